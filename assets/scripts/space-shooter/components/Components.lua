@@ -1,5 +1,20 @@
 -- Component Definitions
 
+-- Hot components are stored natively as float columns; getComponent returns
+-- a view that reads/writes them in place. Extra keys still work.
+ECS.registerComponent("Transform", {
+    x = 0, y = 0, z = 0,
+    rx = 0, ry = 0, rz = 0,
+    sx = 1, sy = 1, sz = 1
+})
+ECS.registerComponent("Physic", {
+    mass = 1.0, friction = 0.5,
+    vx = 0, vy = 0, vz = 0,
+    vax = 0, vay = 0, vaz = 0,
+    ax = 0, ay = 0, az = 0
+})
+ECS.registerComponent("Color", { r = 1.0, g = 1.0, b = 1.0 })
+
 function Transform(x, y, z, rx, ry, rz, sx, sy, sz)
     return {
         x = x or 0,
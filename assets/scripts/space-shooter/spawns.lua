@@ -49,6 +49,7 @@ function Spawns.createPlayer(x, y, z, clientId)
 
     if hasAuthority() then
         ECS.addComponent(e, "ServerAuthority", ServerAuthority())
+        ECS.replicate(e, 1)
     end
     if isLocal or hasRendering() then
         ECS.addComponent(e, "ClientPredicted", ClientPredicted())
@@ -98,6 +99,29 @@ function Spawns.createExplosion(x, y, z)
     return e
 end
 
+-- ============================================================================
+-- PRELOAD
+-- ============================================================================
+-- Models and textures spawned during the level (enemy animation frames,
+-- shots, bonuses), loaded by the renderer before the first one appears.
+function Spawns.preloadAssets()
+    local assets = {
+        "assets/models/simple_plane.obj",
+        "assets/textures/plane_texture.png",
+        "assets/models/sphere.obj",
+        "assets/textures/attack.jpg",
+        "assets/textures/shoot.jpg",
+        "assets/models/cube.obj",
+        "assets/models/quad.obj",
+    }
+    for _, monster in ipairs({{"Monster_1", 8}, {"Monster_2", 3}, {"Monster_3", 8}}) do
+        for frame = 1, monster[2] do
+            table.insert(assets, "assets/models/" .. monster[1] .. "/motion_" .. frame .. ".obj")
+        end
+    end
+    ECS.sendMessage("PreloadAssets", table.concat(assets, ";"))
+end
+
 -- ============================================================================
 -- ENEMY
 -- ============================================================================
@@ -174,6 +198,7 @@ function Spawns.spawnEnemy(x, y, speed, type)
     ECS.addComponent(e, "NetworkIdentity", NetworkIdentity(e, -1, false)) -- -1 = Server owned
     if hasAuthority() then
         ECS.addComponent(e, "ServerAuthority", ServerAuthority())
+        ECS.replicate(e, 3 + mType)
     end
 
     return e
@@ -220,6 +245,7 @@ function Spawns.spawnBullet(x, y, z, isEnemy, ownerId)
     ECS.addComponent(e, "NetworkIdentity", NetworkIdentity(e, -1, false))
     if hasAuthority() then
         ECS.addComponent(e, "ServerAuthority", ServerAuthority())
+        ECS.replicate(e, isEnemy and 3 or 2)
     end
 
     return e
@@ -272,6 +298,7 @@ end
 function Spawns.createCoreEntities(level, backgroundTexture)
     -- Create Camera (if not already present)
     if ECS.capabilities and ECS.capabilities.hasRendering then
+        Spawns.preloadAssets()
         local cameraEntities = ECS.getEntitiesWith({"Camera"})
         if #cameraEntities == 0 then
             local camera = ECS.createEntity()
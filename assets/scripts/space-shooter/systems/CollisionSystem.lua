@@ -4,6 +4,7 @@
 
 local config = dofile("assets/scripts/space-shooter/config.lua")
 local CollisionSystem = {}
+local colliderQuery = ECS.query({"Transform", "Collider"})
 
 -- Mémoire persistante pour ne pas recréer les corps à l'infini
 CollisionSystem.initializedEntities = {}
@@ -20,7 +21,7 @@ function CollisionSystem.update(dt)
     if not ECS.capabilities.hasAuthority then return end
     if not ECS.isGameRunning then return end
 
-    local entities = ECS.getEntitiesWith({"Transform", "Collider"})
+    local entities = colliderQuery:ids()
 
     for _, id in ipairs(entities) do
         -- Si l'entité n'a pas encore de corps physique connu
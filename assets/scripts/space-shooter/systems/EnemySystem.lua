@@ -2,6 +2,7 @@ local config = dofile("assets/scripts/space-shooter/config.lua")
 local Spawns = dofile("assets/scripts/space-shooter/spawns.lua")
 
 local EnemySystem = {}
+local enemyQuery = ECS.query({"Enemy", "Transform"})
 
 EnemySystem.spawnTimer = 0
 EnemySystem.spawnInterval = config.enemy.spawnInterval or 2.0
@@ -55,7 +56,7 @@ function EnemySystem.update(dt)
     end
 
     -- Update Enemies (Movement & Bounds)
-    local enemies = ECS.getEntitiesWith({"Enemy", "Transform"})
+    local enemies = enemyQuery:ids()
     for _, id in ipairs(enemies) do
         local t = ECS.getComponent(id, "Transform")
         
@@ -16,10 +16,8 @@ NetworkSystem.broadcastInterval = 0.08
 NetworkSystem.readyClients = {}
 NetworkSystem.tickCounter = 0
 NetworkSystem.debugAccum = 0
-NetworkSystem.debugSentPlayers = 0
-NetworkSystem.debugSentBullets = 0
-NetworkSystem.debugSentEnemies = 0
 NetworkSystem.debugSentScores = 0
+NetworkSystem.lastSentScore = nil
 
 local function destroyEntitySafe(id)
     if id and ECS.getComponent(id, "Transform") then
@@ -35,30 +33,6 @@ local function hasReadyClients()
     return next(NetworkSystem.readyClients) ~= nil
 end
 
-local function extractVelocity(phys)
-    if not phys then return 0, 0, 0 end
-    return phys.vx or 0, phys.vy or 0, phys.vz or 0
-end
-
-local function buildStateData(id, transform, phys, typeNum)
-    local enemyTypeComp = ECS.getComponent(id, "EnemyType")
-    local actualType = enemyTypeComp and enemyTypeComp.type or typeNum  -- Use EnemyType for enemies, else passed typeNum
-    local vx, vy, vz = extractVelocity(phys)
-    return {
-        id = id,
-        x = transform.x,
-        y = transform.y,
-        z = transform.z,
-        rx = transform.rx,
-        ry = transform.ry,
-        rz = transform.rz,
-        vx = vx,
-        vy = vy,
-        vz = vz,
-        t = actualType
-    }
-end
-
 local function countTableKeys(tbl)
     local c = 0
     for _ in pairs(tbl) do c = c + 1 end
@@ -91,10 +65,42 @@ function NetworkSystem.resetWorldState()
 end
 
 function NetworkSystem.init()
+    -- Snapshot layout (server side), matching onSnapshotEntity below.
+    ECS.setReplicatedFields({
+        {"Transform", "x", "y", "z", "rx", "ry", "rz"},
+        {"Physic", "vx", "vy", "vz"},
+    })
+
     -- ========================================================================
     -- UNIFIED NETWORK SYSTEM: Uses ECS.capabilities instead of direct checks
     -- ========================================================================
 
+    if ECS.capabilities.hasNetworkSync then
+        -- Delivery channels for the topics this side sends; the rest stay
+        -- unreliable. Reliable topics are resent until acked and arrive in
+        -- order, so they are sent once rather than repeated.
+        local channels = {
+            PLAYER_ASSIGN = "reliable",
+            LEVEL_CHANGE = "reliable",
+            ENTITY_DESTROY = "reliable",
+            CLIENT_RESET = "reliable",
+            ENEMY_DEAD = "reliable",
+            GAME_OVER = "reliable",
+            GAME_SCORE = "reliable",
+            STOP_MUSIC = "reliable",
+            CLIENT_READY = "reliable",
+            REQUEST_GAME_START = "reliable",
+            INPUT = "reliable",
+        }
+        for topic, mode in pairs(channels) do
+            ECS.setNetworkChannel(topic, mode)
+        end
+        -- Cosmetic events are the first dropped if received messages back up.
+        for _, topic in ipairs({"PLAY_SOUND", "ENTITY_HIT"}) do
+            ECS.sendMessage("RequestNetworkQueuePolicy", topic .. " shed")
+        end
+    end
+
     if ECS.capabilities.hasAuthority and ECS.capabilities.hasNetworkSync then
         print("[NetworkSystem] Server Mode - Authoritative Network Sync")
 
@@ -146,18 +152,7 @@ function NetworkSystem.init()
                 local s = ECS.getComponent(scoreEntities[1], "Score")
                 ECS.sendToClient(tonumber(clientId), "GAME_SCORE", tostring(s.value))
             end
-            -- Send positions of existing enemies so client renders them right away
-            local enemies = ECS.getEntitiesWith({"Enemy", "Transform"})
-            for _, id in ipairs(enemies) do
-                local t = ECS.getComponent(id, "Transform")
-                local phys = ECS.getComponent(id, "Physic")
-                local data = buildStateData(id, t, phys, 3)
-                if ECS.sendToClientBinary then
-                    ECS.sendToClientBinary(tonumber(clientId), "ENTITY_POS", data)
-                else
-                    -- Fallback impossible if formatStateMessage is gone, but assuming binary is available
-                end
-            end
+            -- Existing entities reach the client with its first (full) snapshot.
         end)
 
         ECS.subscribe("RESET_GAME", function(msg)
@@ -347,6 +342,8 @@ function NetworkSystem.init()
                 -- Send a ready ping; network layer will prefix client id.
                 ECS.sendNetworkMessage("CLIENT_READY", "ready")
                 ECS.isGameRunning = true
+                -- Snapshots only carry changes: get every entity once now that we apply them.
+                ECS.sendMessage("RequestSnapshotResync", "")
             end
         end)
 
@@ -376,6 +373,7 @@ function NetworkSystem.init()
             end
         end)
 
+        -- Legacy per-entity updates; the server now replicates through snapshots.
         ECS.subscribe("ENTITY_POS", function(msg)
             -- msg can be binary (table) or text (string)
             if not ECS.isGameRunning then return end
@@ -452,6 +450,20 @@ function NetworkSystem.init()
     end
 end
 
+-- Snapshot replication (client): called by the engine for every entity the
+-- latest server snapshot added or changed, and for every one it dropped.
+function NetworkSystem.onSnapshotEntity(id, kind, x, y, z, rx, ry, rz, vx, vy, vz)
+    if not ECS.isGameRunning then return end
+    NetworkSystem.updateLocalEntity(id, x, y, z, rx, ry, rz, vx, vy, vz, tostring(kind))
+end
+
+function NetworkSystem.onSnapshotRemoved(id)
+    if NetworkSystem.serverEntities[id] then
+        destroyEntitySafe(NetworkSystem.serverEntities[id])
+        NetworkSystem.serverEntities[id] = nil
+    end
+end
+
 function NetworkSystem.spawnPlayerForClient(clientId)
     -- Offset Y based on Client ID to prevent stacking
     local offsetY = (tonumber(clientId) % 4) * 2.0 - 3.0
@@ -667,75 +679,25 @@ function NetworkSystem.update(dt)
 
     NetworkSystem.debugAccum = NetworkSystem.debugAccum + NetworkSystem.broadcastInterval
 
-    local players = ECS.getEntitiesWith({"Player", "Transform"})
-    if #players > 0 then
-         -- print("DEBUG SERVER: Broadcasting " .. #players .. " Players")
-    else
-         -- print("DEBUG SERVER: No Players found to broadcast")
-    end
-
-    for _, id in ipairs(players) do
-        local t = ECS.getComponent(id, "Transform")
-        local phys = ECS.getComponent(id, "Physic")
-        if ECS.broadcastBinary then
-            ECS.broadcastBinary("ENTITY_POS", buildStateData(id, t, phys, 1))
-        else
-            -- Should not happen with new engine
-        end
-        NetworkSystem.debugSentPlayers = NetworkSystem.debugSentPlayers + 1
-    end
-
-    local bullets = ECS.getEntitiesWith({"Bullet", "Transform"})
-    if NetworkSystem.tickCounter % 2 == 0 then -- ~every 0.16s
-        for _, id in ipairs(bullets) do
-            local t = ECS.getComponent(id, "Transform")
-            local phys = ECS.getComponent(id, "Physic")
-            local tagComp = ECS.getComponent(id, "Tag")
-            local isEnemyBullet = false
-            if tagComp and tagComp.tags then
-                for _, tag in ipairs(tagComp.tags) do
-                    if tag == "EnemyBullet" then
-                        isEnemyBullet = true
-                        break
-                    end
-                end
-            end
-            local typeNum = isEnemyBullet and 3 or 2
-            if ECS.broadcastBinary then
-                ECS.broadcastBinary("ENTITY_POS", buildStateData(id, t, phys, typeNum))
-            end
-            NetworkSystem.debugSentBullets = NetworkSystem.debugSentBullets + 1
-        end
-    end
-
-    local enemies = ECS.getEntitiesWith({"Enemy", "Transform"})
-    if NetworkSystem.tickCounter % 3 == 0 then -- ~every 0.24s
-        for _, id in ipairs(enemies) do
-             local t = ECS.getComponent(id, "Transform")
-             local phys = ECS.getComponent(id, "Physic")
-             if ECS.broadcastBinary then
-                 ECS.broadcastBinary("ENTITY_POS", buildStateData(id, t, phys, 4))
-             end
-             NetworkSystem.debugSentEnemies = NetworkSystem.debugSentEnemies + 1
-        end
-    end
+    -- Entity state (players, bullets, enemies) is replicated by the engine:
+    -- Spawns mark entities with ECS.replicate and the server publishes
+    -- delta-compressed snapshots (see onSnapshotEntity below).
 
     -- Periodic debug dump (server side) every ~1s
     if NetworkSystem.debugAccum >= 1.0 then
-        print(string.format("[NetworkSystem][Server] tick=%d players=%d bullets=%d enemies=%d score=%d readyClients=%d", NetworkSystem.tickCounter, NetworkSystem.debugSentPlayers, NetworkSystem.debugSentBullets, NetworkSystem.debugSentEnemies, NetworkSystem.debugSentScores, countTableKeys(NetworkSystem.readyClients)))
+        print(string.format("[NetworkSystem][Server] tick=%d players=%d bullets=%d enemies=%d score=%d readyClients=%d", NetworkSystem.tickCounter, #ECS.getEntitiesWith({"Player", "Transform"}), #ECS.getEntitiesWith({"Bullet", "Transform"}), #ECS.getEntitiesWith({"Enemy", "Transform"}), NetworkSystem.debugSentScores, countTableKeys(NetworkSystem.readyClients)))
         NetworkSystem.debugAccum = NetworkSystem.debugAccum - 1.0
-        NetworkSystem.debugSentPlayers = 0
-        NetworkSystem.debugSentBullets = 0
-        NetworkSystem.debugSentEnemies = 0
         NetworkSystem.debugSentScores = 0
     end
 
-    -- Broadcast Score
-    if NetworkSystem.tickCounter % 10 == 0 then -- score every ~1.2s
-        local scoreEntities = ECS.getEntitiesWith({"Score"})
-        if #scoreEntities > 0 then
-            local s = ECS.getComponent(scoreEntities[1], "Score")
+    -- Broadcast Score when it changes (GAME_SCORE is reliable; new clients
+    -- get the current value on CLIENT_READY)
+    local scoreEntities = ECS.getEntitiesWith({"Score"})
+    if #scoreEntities > 0 then
+        local s = ECS.getComponent(scoreEntities[1], "Score")
+        if s.value ~= NetworkSystem.lastSentScore then
             ECS.broadcastNetworkMessage("GAME_SCORE", tostring(s.value))
+            NetworkSystem.lastSentScore = s.value
             NetworkSystem.debugSentScores = NetworkSystem.debugSentScores + 1
         end
     end
@@ -5,6 +5,7 @@
 -- Clients and Solo instances render particles; servers skip them.
 -- ============================================================================
 local ParticleSystem = {}
+local generatorQuery = ECS.query({"Transform", "ParticleGenerator"})
 ParticleSystem.initializedParticles = {}
 
 function ParticleSystem.init()
@@ -17,7 +18,7 @@ function ParticleSystem.update(dt)
     -- Only process particles on instances with rendering capability
     if not ECS.capabilities.hasRendering then return end
     
-    local entities = ECS.getEntitiesWith({"Transform", "ParticleGenerator"})
+    local entities = generatorQuery:ids()
     for _, id in ipairs(entities) do
         local t = ECS.getComponent(id, "Transform")
         local gen = ECS.getComponent(id, "ParticleGenerator")
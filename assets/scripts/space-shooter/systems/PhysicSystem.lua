@@ -1,4 +1,5 @@
 local PhysicSystem = {}
+local physicQuery = ECS.query({"Physic"})
 
 function PhysicSystem.init()
     print("[PhysicSystem] Initialized")
@@ -14,13 +15,13 @@ function PhysicSystem.update(dt)
     -- GUARD : Si je ne suis pas le serveur (Local ou Distant), je ne touche pas à la physique.
     if not ECS.capabilities.hasAuthority then return end
 
-    local entities = ECS.getEntitiesWith({"Physic"})
+    local entities = physicQuery:ids()
 
     for _, id in ipairs(entities) do
         local physic = ECS.getComponent(id, "Physic")
         -- Always send velocity to ensure we can stop the ship (send 0,0,0)
-        local msg = string.format("SetLinearVelocity:%s:%f,%f,0;", id, physic.vx, physic.vy)
-        ECS.sendMessage("PhysicCommand", msg)
+        -- Batched into one binary PhysicCommand per tick by the engine.
+        ECS.sendPhysicCommand("SetLinearVelocity", id, physic.vx, physic.vy, 0)
     end
 end
 
@@ -51,11 +52,7 @@ function PhysicSystem.onEntityUpdated(id, x, y, z, rx, ry, rz)
     -- ====================================================================
     -- Send SetPosition command to ensure renderer draws at correct position
     -- This bypasses any potential RenderSystem latency
-    local renderMsg = string.format("SetPosition:%s,%f,%f,%f", id, x, y, z)
-    ECS.sendMessage("RenderEntityCommand", renderMsg)
-
-    local rotMsg = string.format("SetRotation:%s,%f,%f,%f", id, rx, ry, rz)
-    ECS.sendMessage("RenderEntityCommand", rotMsg)
+    ECS.sendRenderCommand("SetTransform", id, x, y, z, rx, ry, rz)
     
     -- print("[PhysicSystem] Forced Render Sync: " .. renderMsg)
 end
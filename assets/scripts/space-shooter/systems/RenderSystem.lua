@@ -5,6 +5,8 @@
 -- Server instances skip all rendering to save resources.
 -- ============================================================================
 local RenderSystem = {}
+local meshQuery = ECS.query({"Transform", "Mesh"})
+local textQuery = ECS.query({"Transform", "Text"})
 local activeCameraId = nil  -- Track the currently active camera
 RenderSystem.initializedEntities = {}
 
@@ -34,8 +36,7 @@ function RenderSystem.update(dt)
             end
             
             local t = ECS.getComponent(id, "Transform")
-            ECS.sendMessage("RenderEntityCommand", "SetPosition:" .. id .. "," .. t.x .. "," .. t.y .. "," .. t.z)
-            ECS.sendMessage("RenderEntityCommand", "SetRotation:" .. id .. "," .. t.rx .. "," .. t.ry .. "," .. t.rz)
+            ECS.sendRenderCommand("SetTransform", id, t.x, t.y, t.z, t.rx, t.ry, t.rz)
             break
         end
     end
@@ -46,7 +47,7 @@ function RenderSystem.update(dt)
     end
 
     -- Handle Mesh Entities
-    local entities = ECS.getEntitiesWith({"Transform", "Mesh"})
+    local entities = meshQuery:ids()
     for _, id in ipairs(entities) do
         local transform = ECS.getComponent(id, "Transform")
         local mesh = ECS.getComponent(id, "Mesh")
@@ -78,15 +79,14 @@ function RenderSystem.update(dt)
         end
 
         if color then
-            ECS.sendMessage("RenderEntityCommand", "SetColor:" .. id .. "," .. color.r .. "," .. color.g .. "," .. color.b)
+            ECS.sendRenderCommand("SetColor", id, color.r, color.g, color.b)
         end
 
-        ECS.sendMessage("RenderEntityCommand", "SetPosition:" .. id .. "," .. transform.x .. "," .. transform.y .. "," .. transform.z)
-        ECS.sendMessage("RenderEntityCommand", "SetRotation:" .. id .. "," .. transform.rx .. "," .. transform.ry .. "," .. transform.rz)
+        ECS.sendRenderCommand("SetTransform", id, transform.x, transform.y, transform.z, transform.rx, transform.ry, transform.rz)
     end
 
     -- Handle Text Entities
-    local textEntities = ECS.getEntitiesWith({"Transform", "Text"})
+    local textEntities = textQuery:ids()
     for _, id in ipairs(textEntities) do
         local transform = ECS.getComponent(id, "Transform")
         local text = ECS.getComponent(id, "Text")
@@ -99,11 +99,10 @@ function RenderSystem.update(dt)
         end
 
         if color then
-            ECS.sendMessage("RenderEntityCommand", "SetColor:" .. id .. "," .. color.r .. "," .. color.g .. "," .. color.b)
+            ECS.sendRenderCommand("SetColor", id, color.r, color.g, color.b)
         end
 
-        ECS.sendMessage("RenderEntityCommand", "SetPosition:" .. id .. "," .. transform.x .. "," .. transform.y .. "," .. transform.z)
-        ECS.sendMessage("RenderEntityCommand", "SetRotation:" .. id .. "," .. transform.rx .. "," .. transform.ry .. "," .. transform.rz)
+        ECS.sendRenderCommand("SetTransform", id, transform.x, transform.y, transform.z, transform.rx, transform.ry, transform.rz)
 
         if not RenderSystem.lastText then RenderSystem.lastText = {} end
         if RenderSystem.lastText[id] ~= text.text then
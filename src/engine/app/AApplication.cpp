@@ -1,5 +1,6 @@
 
 #include "AApplication.hpp"
+#include <cerrno>
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
@@ -190,7 +191,7 @@ void AApplication::run() {
   while (_running) {
     processMessages();
     loop();
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    waitForMessages(APP_IDLE_WAIT);
   }
 
   for (const auto &module : _modules) {
@@ -204,6 +205,22 @@ void AApplication::run() {
   cleanupMessageBroker();
 }
 
+void AApplication::waitForMessages(std::chrono::milliseconds timeout) {
+  if (!_subscriber || !_isBrokerActive) {
+    std::this_thread::sleep_for(timeout);
+    return;
+  }
+  // Wake as soon as the bus has something for us instead of sleeping blindly.
+  zmq::pollitem_t items[] = {{static_cast<void*>(*_subscriber), 0, ZMQ_POLLIN, 0}};
+  try {
+    zmq::poll(items, 1, timeout);
+  } catch (const zmq::error_t& e) {
+    if (e.num() != EINTR && e.num() != ETERM) {
+      std::cerr << "[App] poll error: " << e.what() << std::endl;
+    }
+  }
+}
+
 void AApplication::sendMessage(const std::string& topic, const std::string& message) {
   if (!_publisher || !_isBrokerActive) {
     return;
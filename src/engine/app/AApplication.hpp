@@ -17,6 +17,7 @@
 #pragma once
 
 #include "IApplication.hpp"
+#include <chrono>
 #include <memory>
 #include <thread>
 #include <zmq.hpp>
@@ -42,6 +43,9 @@ public:
 protected:
   void initializeMessageBroker();
   void cleanupMessageBroker();
+  void waitForMessages(std::chrono::milliseconds timeout);
+
+  static constexpr std::chrono::milliseconds APP_IDLE_WAIT{10};
 
 private:
   zmq::context_t _zmqContext;
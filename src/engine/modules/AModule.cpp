@@ -1,5 +1,7 @@
 
 #include "AModule.hpp"
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdlib>
 #include <iostream>
@@ -14,6 +16,14 @@ bool debugEnabled() {
     return enabled;
 }
 
+bool legacySchedulerEnabled() {
+    static bool enabled = [] {
+        const char* mode = std::getenv("RTYPE_MODULE_SCHEDULER");
+        return mode != nullptr && std::string(mode) == "sleep";
+    }();
+    return enabled;
+}
+
 bool sniperDebugEnabled() {
     static bool enabled = (std::getenv("RTYPE_SNIPER_DEBUG") != nullptr);
     return enabled;
@@ -41,8 +51,6 @@ void AModule::start() {
     _running = true;
     _moduleThread = std::thread([this]() {
         const std::string name = moduleName(this);
-        bool isBullet = (name.find("Bullet") != std::string::npos);
-        bool sniper = sniperDebugEnabled() && isBullet;
 
         if (debugEnabled()) {
             std::cout << "[Module] Start " << name << std::endl;
@@ -54,16 +62,10 @@ void AModule::start() {
             init();
             _initialized = true;
         }
-        while (_running) {
-            if (sniper) std::cout << "[Sniper] " << name << " Step 1: Entering processMessages" << std::endl;
-            processMessages();
-            if (sniper) std::cout << "[Sniper] " << name << " Step 2: Exited processMessages" << std::endl;
-
-            if (sniper) std::cout << "[Sniper] " << name << " Step 3: Entering loop" << std::endl;
-            loop();
-            if (sniper) std::cout << "[Sniper] " << name << " Step 4: Exited loop" << std::endl;
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (legacySchedulerEnabled()) {
+            runLegacy();
+        } else {
+            runScheduled();
         }
         if (_initialized) {
             if (debugEnabled()) {
@@ -78,6 +80,87 @@ void AModule::start() {
     });
 }
 
+void AModule::runLegacy() {
+    const std::string name = moduleName(this);
+    bool sniper = sniperDebugEnabled() && (name.find("Bullet") != std::string::npos);
+
+    while (_running) {
+        if (sniper) std::cout << "[Sniper] " << name << " Step 1: Entering processMessages" << std::endl;
+        processMessages();
+        if (sniper) std::cout << "[Sniper] " << name << " Step 2: Exited processMessages" << std::endl;
+
+        if (sniper) std::cout << "[Sniper] " << name << " Step 3: Entering loop" << std::endl;
+        loop();
+        if (sniper) std::cout << "[Sniper] " << name << " Step 4: Exited loop" << std::endl;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void AModule::runScheduled() {
+    using Clock = std::chrono::steady_clock;
+    const std::string name = moduleName(this);
+    bool sniper = sniperDebugEnabled() && (name.find("Bullet") != std::string::npos);
+
+    auto nextTick = Clock::now();
+    while (_running) {
+        if (sniper) std::cout << "[Sniper] " << name << " Step 1: Entering processMessages" << std::endl;
+        processMessages();
+        if (sniper) std::cout << "[Sniper] " << name << " Step 2: Exited processMessages" << std::endl;
+
+        const auto interval = std::chrono::nanoseconds(_tickIntervalNs.load(std::memory_order_relaxed));
+        auto now = Clock::now();
+        if (interval.count() > 0 && now >= nextTick) {
+            if (sniper) std::cout << "[Sniper] " << name << " Step 3: Entering loop" << std::endl;
+            loop();
+            if (sniper) std::cout << "[Sniper] " << name << " Step 4: Exited loop" << std::endl;
+
+            nextTick += interval;
+            now = Clock::now();
+            // After a long stall, restart the cadence instead of ticking back-to-back to catch up.
+            if (nextTick < now) {
+                nextTick = now + interval;
+            }
+        }
+
+        Clock::duration timeout = MAX_IDLE_WAIT;
+        if (interval.count() > 0) {
+            timeout = std::min<Clock::duration>(timeout, nextTick - now);
+        }
+        if (timeout > Clock::duration::zero()) {
+            waitForMessages(timeout);
+        }
+    }
+}
+
+bool AModule::waitForMessages(std::chrono::steady_clock::duration timeout) {
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(timeout);
+    // zmq::poll has millisecond granularity; round sub-millisecond waits up so we don't spin.
+    if (ms < timeout) {
+        ms += std::chrono::milliseconds(1);
+    }
+    zmq::pollitem_t items[] = {{static_cast<void*>(*_subscriber), 0, ZMQ_POLLIN, 0}};
+    try {
+        zmq::poll(items, 1, ms);
+    } catch (const zmq::error_t& e) {
+        if (e.num() != EINTR && e.num() != ETERM) {
+            std::cerr << "[Module] poll error in " << moduleName(this) << ": " << e.what() << std::endl;
+        }
+        return false;
+    }
+    return (items[0].revents & ZMQ_POLLIN) != 0;
+}
+
+void AModule::setTickRate(double hz) {
+    int64_t interval = hz > 0.0 ? static_cast<int64_t>(1e9 / hz) : 0;
+    _tickIntervalNs.store(interval, std::memory_order_relaxed);
+}
+
+double AModule::getTickRate() const {
+    int64_t interval = _tickIntervalNs.load(std::memory_order_relaxed);
+    return interval > 0 ? 1e9 / static_cast<double>(interval) : 0.0;
+}
+
 void AModule::stop() {
     _running = false; // Signal the thread to stop
 
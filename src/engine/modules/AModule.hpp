@@ -13,6 +13,13 @@
  * - Each module runs in _moduleThread
  * - _running atomic controls the module loop
  * - processMessages() handles incoming messages
+ *
+ * @section scheduling Scheduling
+ * The module thread blocks in zmq::poll on its subscriber socket until either
+ * a message arrives (handled immediately) or the next tick is due, at which
+ * point loop() runs. Modules declare their rate with setTickRate(); a rate of
+ * 0 means loop() is never ticked and the module only reacts to messages.
+ * `RTYPE_MODULE_SCHEDULER=sleep` restores the old fixed 10 ms sleep loop.
  * 
  * @see IModule for the interface definition
  * @see docs/ARCHITECTURE.md for module system details
@@ -26,6 +33,8 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 
 namespace rtypeEngine {
 
@@ -49,6 +58,13 @@ class AModule : public IModule {
     void setPublisherBufferLength(int length) override;
     void setSubscriberBufferLength(int length) override;
 
+    /// Target rate of loop() calls in Hz; 0 disables ticking (message-driven only).
+    void setTickRate(double hz);
+    double getTickRate() const;
+
+    static constexpr double DEFAULT_TICK_RATE = 100.0;
+    static constexpr std::chrono::milliseconds MAX_IDLE_WAIT{100};
+
     zmq::context_t _context;
     std::unique_ptr<zmq::socket_t> _publisher;
     std::unique_ptr<zmq::socket_t> _subscriber;
@@ -56,6 +72,13 @@ class AModule : public IModule {
     std::thread _moduleThread;
     std::atomic<bool> _running;
     bool _initialized = false;
+
+  private:
+    void runScheduled();
+    void runLegacy();
+    bool waitForMessages(std::chrono::steady_clock::duration timeout);
+
+    std::atomic<int64_t> _tickIntervalNs{static_cast<int64_t>(1e9 / DEFAULT_TICK_RATE)};
 };
 
 }  // namespace rtypeEngine
@@ -7,6 +7,91 @@
 
 namespace rtypeEngine {
 
+namespace {
+struct CommandSpec {
+  const char *name;
+  busCodec::Op op;
+  uint16_t minFloats;
+  uint16_t maxFloats;
+};
+
+const CommandSpec PHYSIC_COMMANDS[] = {
+    {"SetLinearVelocity", busCodec::Op::SetLinearVelocity, 3, 3},
+    {"SetAngularVelocity", busCodec::Op::SetAngularVelocity, 3, 3},
+    {"ApplyForce", busCodec::Op::ApplyForce, 3, 3},
+    {"ApplyImpulse", busCodec::Op::ApplyImpulse, 3, 3},
+    {"SetTransform", busCodec::Op::SetTransform, 6, 6},
+};
+
+const CommandSpec RENDER_COMMANDS[] = {
+    {"SetPosition", busCodec::Op::RenderSetPosition, 3, 3},
+    {"SetRotation", busCodec::Op::RenderSetRotation, 3, 3},
+    {"SetScale", busCodec::Op::RenderSetScale, 3, 3},
+    {"SetColor", busCodec::Op::RenderSetColor, 3, 3},
+    {"SetTransform", busCodec::Op::RenderSetTransform, 6, 9},
+};
+
+template <std::size_t N>
+const CommandSpec *findCommand(const CommandSpec (&specs)[N], const std::string &name) {
+  for (const auto &spec : specs) {
+    if (name == spec.name) return &spec;
+  }
+  return nullptr;
+}
+
+uint16_t collectFloats(const sol::variadic_args &args, float *out, uint16_t max) {
+  uint16_t count = 0;
+  for (auto arg : args) {
+    if (count >= max) break;
+    sol::optional<float> value = arg.as<sol::optional<float>>();
+    if (!value) break;
+    out[count++] = *value;
+  }
+  return count;
+}
+
+void appendFloats(std::ostringstream &ss, const float *values, uint16_t from, uint16_t to) {
+  for (uint16_t i = from; i < to; ++i) {
+    if (i > from) ss << ",";
+    ss << values[i];
+  }
+}
+
+// Legacy text forms, identical to what the scripts used to build by hand.
+std::string formatPhysicText(const CommandSpec &spec, const std::string &id, const float *values, uint16_t count) {
+  std::ostringstream ss;
+  ss << spec.name << ":" << id << ":";
+  appendFloats(ss, values, 0, 3);
+  if (spec.op == busCodec::Op::SetTransform) {
+    ss << ":";
+    appendFloats(ss, values, 3, count);
+  }
+  ss << ";";
+  return ss.str();
+}
+
+std::string formatRenderText(const CommandSpec &spec, const std::string &id, const float *values, uint16_t count) {
+  std::ostringstream ss;
+  if (spec.op != busCodec::Op::RenderSetTransform) {
+    ss << spec.name << ":" << id << ",";
+    appendFloats(ss, values, 0, 3);
+    ss << ";";
+    return ss.str();
+  }
+  ss << "SetPosition:" << id << ",";
+  appendFloats(ss, values, 0, 3);
+  ss << ";SetRotation:" << id << ",";
+  appendFloats(ss, values, 3, 6);
+  ss << ";";
+  if (count >= 9) {
+    ss << "SetScale:" << id << ",";
+    appendFloats(ss, values, 6, 9);
+    ss << ";";
+  }
+  return ss.str();
+}
+} // namespace
+
 void LuaECSManager::setupLuaBindings() {
   auto ecs = _lua.create_named_table("ECS");
 
@@ -21,6 +106,9 @@ void LuaECSManager::setupLuaBindings() {
   _capabilities["isClientMode"] = false;
   _capabilities["isServer"] = false;
 
+  setupComponentBindings(ecs);
+  setupReplicationBindings(ecs);
+
   ecs.set_function("setGameMode", [this](const std::string &mode_name) {
       if (mode_name == "SOLO") {
           _capabilities["hasAuthority"] = true;
@@ -64,35 +152,17 @@ void LuaECSManager::setupLuaBindings() {
 
   ecs.set_function("createEntity", [this]() -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
     return id;
   });
 
   ecs.set_function("destroyEntity", [this](const std::string &id) {
-    auto it = std::find(_entities.begin(), _entities.end(), id);
-    if (it != _entities.end()) {
-      _entities.erase(it);
-
-      for (auto &pair : _pools) {
-        ComponentPool &pool = pair.second;
-        if (pool.sparse.count(id)) {
-          size_t index = pool.sparse[id];
-          size_t lastIndex = pool.dense.size() - 1;
-          std::string lastEntity = pool.entities[lastIndex];
-
-          std::swap(pool.dense[index], pool.dense[lastIndex]);
-          std::swap(pool.entities[index], pool.entities[lastIndex]);
-
-          pool.sparse[lastEntity] = index;
-          pool.dense.pop_back();
-          pool.entities.pop_back();
-          pool.sparse.erase(id);
-        }
-      }
+    EntityHandle handle = _registry.find(id);
+    if (handle == INVALID_ENTITY) return;
 
-      sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
-      sendMessage("PhysicCommand", "DestroyBody:" + id + ";");
-    }
+    releaseEntity(handle);
+    sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
+    sendMessage("PhysicCommand", "DestroyBody:" + id + ";");
   });
 
   ecs.set_function("createText", [this](const std::string &id,
@@ -111,20 +181,12 @@ void LuaECSManager::setupLuaBindings() {
 
   ecs.set_function("addComponent", [this](const std::string &entityId,
                                           const std::string &componentName,
-                                          sol::table componentData) {
+                                          sol::object componentData) {
     // std::cout << "[LuaECSManager] Adding component " << componentName << " to " << entityId << std::endl;
-    if (_pools.find(componentName) == _pools.end()) {
-      _pools[componentName] = ComponentPool();
-    }
-    ComponentPool &pool = _pools[componentName];
     try {
-        if (pool.sparse.count(entityId)) {
-          pool.dense[pool.sparse[entityId]] = componentData;
-        } else {
-          pool.dense.push_back(componentData);
-          pool.entities.push_back(entityId);
-          pool.sparse[entityId] = pool.dense.size() - 1;
-        }
+        // Ids minted elsewhere (server entities on clients, saves) are adopted here.
+        EntityHandle handle = _registry.findOrCreate(entityId);
+        storeComponent(componentName, handle, componentData);
     } catch (const std::exception& e) {
         std::cerr << "[LuaECSManager] CRASH AVERTED in addComponent (" << componentName << "): " << e.what() << std::endl;
     }
@@ -132,78 +194,35 @@ void LuaECSManager::setupLuaBindings() {
 
   ecs.set_function("removeComponent", [this](const std::string &id,
                                              const std::string &name) {
-    if (_pools.find(name) != _pools.end()) {
-      ComponentPool &pool = _pools[name];
-      if (pool.sparse.count(id)) {
-        size_t index = pool.sparse[id];
-        size_t lastIndex = pool.dense.size() - 1;
-        std::string lastEntity = pool.entities[lastIndex];
-
-        std::swap(pool.dense[index], pool.dense[lastIndex]);
-        std::swap(pool.entities[index], pool.entities[lastIndex]);
-
-        pool.sparse[lastEntity] = index;
-        pool.dense.pop_back();
-        pool.entities.pop_back();
-        pool.sparse.erase(id);
-      }
+    EntityHandle handle = _registry.find(id);
+    if (handle != INVALID_ENTITY) {
+      removeComponent(name, handle);
     }
   });
 
   ecs.set_function("hasComponent", [this](const std::string &id,
                                           const std::string &name) -> bool {
-    if (_pools.find(name) != _pools.end()) {
-      ComponentPool &pool = _pools[name];
-      return pool.sparse.count(id) > 0;
-    }
-    return false;
+    SparseSet *pool = findStorage(name);
+    EntityHandle handle = _registry.find(id);
+    return pool && handle != INVALID_ENTITY && pool->has(entityIndex(handle));
   });
 
   ecs.set_function("getComponent",
       [this](const std::string &id, const std::string &name) -> sol::object {
-        if (_pools.find(name) != _pools.end()) {
-          ComponentPool &pool = _pools[name];
-          if (pool.sparse.count(id)) {
-            return pool.dense[pool.sparse[id]];
-          }
-        }
-        return sol::nil;
+        EntityHandle handle = _registry.find(id);
+        if (handle == INVALID_ENTITY) return sol::nil;
+        return loadComponent(name, handle);
       });
 
   ecs.set_function("getEntitiesWith",
                    [this](sol::table components) -> std::vector<std::string> {
-                     std::vector<std::string> required;
-                     for (auto &kv : components) {
-                       if (kv.second.is<std::string>()) {
-                         required.push_back(kv.second.as<std::string>());
-                       }
-                     }
-                     if (required.empty()) return {};
-
-                     ComponentPool *smallestPool = nullptr;
-                     size_t minSize = SIZE_MAX;
-
-                     for (const auto &req : required) {
-                       if (_pools.find(req) == _pools.end()) return {};
-                       if (_pools[req].dense.size() < minSize) {
-                         minSize = _pools[req].dense.size();
-                         smallestPool = &_pools[req];
-                       }
-                     }
-                     if (!smallestPool) return {};
-
+                     // Served from the persistent query; the copy keeps callers free to mutate it.
+                     EntityQuery *query = resolveQuery(components);
+                     if (!query) return {};
                      std::vector<std::string> result;
-                     for (const auto &entityId : smallestPool->entities) {
-                       bool hasAll = true;
-                       for (const auto &req : required) {
-                         if (_pools[req].sparse.find(entityId) == _pools[req].sparse.end()) {
-                           hasAll = false;
-                           break;
-                         }
-                       }
-                       if (hasAll) {
-                         result.push_back(entityId);
-                       }
+                     result.reserve(query->size());
+                     for (uint32_t index : query->entities) {
+                       result.push_back(_registry.idAt(index));
                      }
                      return result;
                    });
@@ -213,6 +232,45 @@ void LuaECSManager::setupLuaBindings() {
     sendMessage(topic, message);
   });
 
+  // Hot per-entity commands: queued as fixed-size binary records and flushed
+  // once per tick (see types/busCodec.hpp). With RTYPE_BUS_TEXT=1 they are
+  // sent right away in the legacy text format.
+  ecs.set_function("sendPhysicCommand", [this](const std::string &command, const std::string &id,
+                                               sol::variadic_args args) {
+    const CommandSpec *spec = findCommand(PHYSIC_COMMANDS, command);
+    if (!spec) {
+      std::cerr << "[LuaECSManager] sendPhysicCommand: unsupported command '" << command << "'" << std::endl;
+      return;
+    }
+    float values[busCodec::MAX_FLOATS];
+    uint16_t count = collectFloats(args, values, spec->maxFloats);
+    if (count < spec->minFloats) {
+      std::cerr << "[LuaECSManager] sendPhysicCommand: " << command << " expects " << spec->minFloats << " values" << std::endl;
+      return;
+    }
+    if (busCodec::textFallbackEnabled() || !_physicBatch.add(spec->op, id, values, count)) {
+      sendMessage("PhysicCommand", formatPhysicText(*spec, id, values, count));
+    }
+  });
+
+  ecs.set_function("sendRenderCommand", [this](const std::string &command, const std::string &id,
+                                               sol::variadic_args args) {
+    const CommandSpec *spec = findCommand(RENDER_COMMANDS, command);
+    if (!spec) {
+      std::cerr << "[LuaECSManager] sendRenderCommand: unsupported command '" << command << "'" << std::endl;
+      return;
+    }
+    float values[busCodec::MAX_FLOATS];
+    uint16_t count = collectFloats(args, values, spec->maxFloats);
+    if (count < spec->minFloats) {
+      std::cerr << "[LuaECSManager] sendRenderCommand: " << command << " expects " << spec->minFloats << " values" << std::endl;
+      return;
+    }
+    if (busCodec::textFallbackEnabled() || !_renderBatch.add(spec->op, id, values, count)) {
+      sendMessage("RenderEntityCommand", formatRenderText(*spec, id, values, count));
+    }
+  });
+
   ecs.set_function("subscribe", [this](const std::string &topic, sol::function callback) {
         if (_luaListeners.find(topic) == _luaListeners.end()) {
           subscribe(topic, [this, topic](const std::string &msg) {
@@ -244,6 +302,11 @@ void LuaECSManager::setupLuaBindings() {
     sendMessage("RequestNetworkSendTo", std::to_string(clientId) + " " + topic + " " + payload);
   });
 
+  // "unreliable" (default), "sequenced" (stale messages dropped) or "reliable" (resent, in order).
+  ecs.set_function("setNetworkChannel", [this](const std::string &topic, const std::string &delivery) {
+    sendMessage("RequestNetworkChannel", topic + " " + delivery);
+  });
+
   // Binary Protocol Bindings
   auto buildBinaryPayload = [](const std::string &topic, const msgpack::sbuffer &sbuf) {
       if (topic.size() > 1024) {
@@ -358,12 +421,7 @@ void LuaECSManager::setupLuaBindings() {
   });
 
   ecs.set_function("removeEntities", [this]() {
-      for (const auto& id : _entities) {
-          sendMessage("PhysicCommand", "DestroyBody:" + id + ";");
-          sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
-      }
-      _entities.clear();
-      _pools.clear();
+      destroyAllEntities();
   });
 
   // ============================================================================
@@ -375,7 +433,7 @@ void LuaECSManager::setupLuaBindings() {
   ecs.set_function("createRect", [this](float x, float y, float width, float height,
                                          float r, float g, float b, float a, int zOrder) -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
 
     std::stringstream ss;
     ss << "CreateRect:" << id << ":" << x << "," << y << "," << width << "," << height
@@ -416,7 +474,7 @@ void LuaECSManager::setupLuaBindings() {
   ecs.set_function("createUIText", [this](const std::string& text, float x, float y,
                                            int fontSize, float r, float g, float b, int zOrder, sol::optional<std::string> fontPath) -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
 
     std::string actualFont = fontPath.value_or("assets/fonts/arial.ttf");
     if (actualFont.empty()) actualFont = "assets/fonts/arial.ttf";
@@ -467,9 +525,9 @@ void LuaECSManager::setupLuaBindings() {
   // Destroy a UI element
   ecs.set_function("destroyUI", [this](const std::string& id) {
     sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
-    auto it = std::find(_entities.begin(), _entities.end(), id);
-    if (it != _entities.end()) {
-      _entities.erase(it);
+    EntityHandle handle = _registry.find(id);
+    if (handle != INVALID_ENTITY) {
+      releaseEntity(handle);
     }
   });
 
@@ -487,7 +545,7 @@ void LuaECSManager::setupLuaBindings() {
                                            float r, float g, float b, float a,
                                            int zOrder, sol::optional<int> segments) -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
 
     int segs = segments.value_or(32);
 
@@ -509,7 +567,7 @@ void LuaECSManager::setupLuaBindings() {
                                                 float cornerRadius, float r, float g, float b,
                                                 float a, int zOrder) -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
 
     std::stringstream ss;
     ss << "CreateRoundedRect:" << id << ":" << x << "," << y << "," << width << ","
@@ -529,7 +587,7 @@ void LuaECSManager::setupLuaBindings() {
                                          float lineWidth, float r, float g, float b,
                                          float a, int zOrder) -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
 
     std::stringstream ss;
     ss << "CreateLine:" << id << ":" << x1 << "," << y1 << "," << x2 << "," << y2 << ","
@@ -548,7 +606,7 @@ void LuaECSManager::setupLuaBindings() {
   ecs.set_function("createUISprite", [this](const std::string& texturePath, float x, float y,
                                              float width, float height, int zOrder) -> std::string {
     std::string id = generateUuid();
-    _entities.push_back(id);
+    _registry.create(id);
 
     std::stringstream ss;
     ss << "CreateUISprite:" << id << ":" << texturePath << ":" << x << "," << y << ","
@@ -0,0 +1,358 @@
+#include "LuaECSManager.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace rtypeEngine {
+
+SparseSet *LuaECSManager::findStorage(const std::string &name) {
+  auto typed = _typedPools.find(name);
+  if (typed != _typedPools.end()) return &typed->second;
+  return findPool(name);
+}
+
+TypedComponentPool *LuaECSManager::findTypedPool(const std::string &name) {
+  auto it = _typedPools.find(name);
+  return it != _typedPools.end() ? &it->second : nullptr;
+}
+
+uint32_t LuaECSManager::viewRow(const ComponentView &view) const {
+  if (!view.pool || !_registry.alive(view.handle)) return INVALID_INDEX;
+  return view.pool->rowOf(entityIndex(view.handle));
+}
+
+bool LuaECSManager::registerComponentSchema(const std::string &name, const sol::table &schema) {
+  std::vector<std::string> fields;
+  std::vector<float> defaults;
+  for (const auto &kv : schema) {
+    // Accepts both {"x", "y"} (default 0) and {x = 0, sx = 1}.
+    if (kv.first.get_type() == sol::type::number && kv.second.is<std::string>()) {
+      fields.push_back(kv.second.as<std::string>());
+      defaults.push_back(0.0f);
+    } else if (kv.first.is<std::string>() && kv.second.get_type() == sol::type::number) {
+      fields.push_back(kv.first.as<std::string>());
+      defaults.push_back(kv.second.as<float>());
+    } else {
+      std::cerr << "[LuaECSManager] registerComponent(" << name << "): fields must be numbers" << std::endl;
+      return false;
+    }
+  }
+  if (fields.empty()) return false;
+
+  TypedComponentPool *existing = findTypedPool(name);
+  if (existing && existing->fields == fields) return true;
+  if (existing && existing->size() > 0) {
+    std::cerr << "[LuaECSManager] registerComponent(" << name << "): schema changed while in use" << std::endl;
+    return false;
+  }
+
+  // Reset in place: views held by scripts keep pointing at a live pool.
+  TypedComponentPool &pool = _typedPools[name];
+  pool = TypedComponentPool(name, fields, defaults);
+
+  // Components added before the schema was registered move over to typed storage.
+  auto generic = _pools.find(name);
+  if (generic != _pools.end()) {
+    ComponentPool &old = generic->second;
+    for (std::size_t row = 0; row < old.size(); ++row) {
+      writeTypedComponent(pool, old.entities[row], old.dense[row]);
+    }
+    _pools.erase(generic);
+  }
+  return true;
+}
+
+void LuaECSManager::writeTypedComponent(TypedComponentPool &pool, uint32_t index, const sol::table &data) {
+  uint32_t row = pool.emplace(index);
+  for (std::size_t f = 0; f < pool.columns.size(); ++f) {
+    pool.columns[f][row] = pool.defaults[f];
+  }
+  pool.extras[row] = sol::table();
+
+  for (const auto &kv : data) {
+    int field = kv.first.is<std::string>() ? pool.fieldIndex(kv.first.as<std::string>()) : -1;
+    if (field >= 0 && kv.second.get_type() == sol::type::number) {
+      pool.at(row, field) = kv.second.as<float>();
+      continue;
+    }
+    if (!pool.extras[row].valid()) {
+      pool.extras[row] = _lua.create_table();
+    }
+    pool.extras[row][kv.first] = kv.second;
+  }
+}
+
+sol::table LuaECSManager::componentToTable(TypedComponentPool &pool, uint32_t row) {
+  sol::table table = _lua.create_table();
+  if (pool.extras[row].valid()) {
+    for (const auto &kv : pool.extras[row]) {
+      table[kv.first] = kv.second;
+    }
+  }
+  for (std::size_t f = 0; f < pool.fields.size(); ++f) {
+    table[pool.fields[f]] = pool.columns[f][row];
+  }
+  return table;
+}
+
+void LuaECSManager::storeComponent(const std::string &name, EntityHandle handle, const sol::object &data) {
+  uint32_t index = entityIndex(handle);
+  TypedComponentPool *typed = findTypedPool(name);
+
+  if (data.is<ComponentView>()) {
+    const ComponentView &view = data.as<const ComponentView &>();
+    uint32_t row = viewRow(view);
+    if (row == INVALID_INDEX) return;
+    // Writing a view back onto its own entity is a no-op: it already is the storage.
+    if (view.pool == typed && view.handle == handle) return;
+    sol::table copy = componentToTable(*view.pool, row);
+    storeComponent(name, handle, copy);
+    return;
+  }
+
+  if (data.get_type() != sol::type::table) {
+    std::cerr << "[LuaECSManager] addComponent(" << name << "): component must be a table" << std::endl;
+    return;
+  }
+
+  bool added;
+  if (typed) {
+    added = !typed->has(index);
+    writeTypedComponent(*typed, index, data.as<sol::table>());
+  } else {
+    ComponentPool &pool = _pools[name];
+    added = !pool.has(index);
+    pool.set(index, data.as<sol::table>());
+  }
+  if (added) {
+    onComponentAdded(name, index);
+  }
+}
+
+void LuaECSManager::removeComponent(const std::string &name, EntityHandle handle) {
+  uint32_t index = entityIndex(handle);
+  bool removed = false;
+  if (TypedComponentPool *typed = findTypedPool(name)) {
+    removed = typed->remove(index);
+  } else if (ComponentPool *pool = findPool(name)) {
+    removed = pool->remove(index);
+  }
+  if (removed) {
+    for (auto &query : _queries) {
+      if (query->uses(name)) query->remove(index);
+    }
+  }
+}
+
+void LuaECSManager::onComponentAdded(const std::string &name, uint32_t index) {
+  for (auto &query : _queries) {
+    if (query->uses(name) && !query->has(index) && matchesQuery(*query, index)) {
+      query->add(index);
+    }
+  }
+}
+
+bool LuaECSManager::matchesQuery(const EntityQuery &query, uint32_t index) {
+  for (const auto &name : query.components) {
+    SparseSet *storage = findStorage(name);
+    if (!storage || !storage->has(index)) return false;
+  }
+  return true;
+}
+
+EntityQuery *LuaECSManager::resolveQuery(const sol::table &components) {
+  std::vector<std::string> names;
+  for (const auto &kv : components) {
+    if (kv.second.is<std::string>()) {
+      names.push_back(kv.second.as<std::string>());
+    }
+  }
+  if (names.empty()) return nullptr;
+  std::sort(names.begin(), names.end());
+  names.erase(std::unique(names.begin(), names.end()), names.end());
+
+  std::string key;
+  for (const auto &name : names) {
+    key += name;
+    key += ',';
+  }
+
+  auto it = _queryByKey.find(key);
+  if (it != _queryByKey.end()) {
+    ++it->second->lookups;
+    return it->second;
+  }
+
+  auto query = std::make_unique<EntityQuery>();
+  query->key = key;
+  query->components = std::move(names);
+  query->lookups = 1;
+
+  // Initial fill from the smallest storage; afterwards add/remove keep it current.
+  SparseSet *smallest = nullptr;
+  bool complete = true;
+  for (const auto &name : query->components) {
+    SparseSet *storage = findStorage(name);
+    if (!storage) {
+      complete = false;
+      break;
+    }
+    if (!smallest || storage->size() < smallest->size()) smallest = storage;
+  }
+  if (complete && smallest) {
+    for (uint32_t index : smallest->entities) {
+      if (matchesQuery(*query, index)) query->add(index);
+    }
+  }
+
+  ++_queriesBuilt;
+  EntityQuery *raw = query.get();
+  _queryByKey[key] = raw;
+  _queries.push_back(std::move(query));
+  return raw;
+}
+
+sol::table LuaECSManager::queryIds(EntityQuery &query) {
+  if (!query.dirty && query.ids.valid()) {
+    ++query.hits;
+    return query.ids;
+  }
+  // A fresh table each rebuild: scripts still iterating the previous one are unaffected.
+  sol::table ids = _lua.create_table(static_cast<int>(query.size()), 0);
+  for (std::size_t i = 0; i < query.size(); ++i) {
+    ids[i + 1] = _registry.idAt(query.entities[i]);
+  }
+  // Every caller gets the same table until the next rebuild, so hand out a
+  // read-only view: a script sorting it would reorder it for everyone.
+  query.ids = _readOnlyIds(ids);
+  query.dirty = false;
+  ++query.rebuilds;
+  return query.ids;
+}
+
+void LuaECSManager::clearQueries() {
+  _queryByKey.clear();
+  _queries.clear();
+  _queriesBuilt = 0;
+}
+
+sol::object LuaECSManager::loadComponent(const std::string &name, EntityHandle handle) {
+  uint32_t index = entityIndex(handle);
+  if (TypedComponentPool *typed = findTypedPool(name)) {
+    if (!typed->has(index)) return sol::nil;
+    return sol::make_object(_lua, ComponentView{typed, handle});
+  }
+  if (ComponentPool *pool = findPool(name)) {
+    if (sol::table *component = pool->get(index)) {
+      return *component;
+    }
+  }
+  return sol::nil;
+}
+
+void LuaECSManager::setupComponentBindings(sol::table &ecs) {
+  _lua.new_usertype<ComponentView>(
+      "ComponentView", sol::no_constructor,
+      sol::meta_function::index,
+      [this](ComponentView &view, sol::stack_object key, sol::this_state state) -> sol::object {
+        uint32_t row = viewRow(view);
+        if (row == INVALID_INDEX) return sol::nil;
+        if (key.get_type() == sol::type::string) {
+          int field = view.pool->fieldIndex(key.as<std::string>());
+          if (field >= 0) {
+            return sol::make_object(state, view.pool->at(row, field));
+          }
+        }
+        sol::table &extras = view.pool->extras[row];
+        if (!extras.valid()) return sol::nil;
+        return extras[key].get<sol::object>();
+      },
+      sol::meta_function::new_index,
+      [this](ComponentView &view, sol::stack_object key, sol::stack_object value) {
+        uint32_t row = viewRow(view);
+        if (row == INVALID_INDEX) {
+          throw sol::error("write to a destroyed " + view.pool->name + " component");
+        }
+        int field = key.get_type() == sol::type::string ? view.pool->fieldIndex(key.as<std::string>()) : -1;
+        if (field >= 0) {
+          if (value.get_type() == sol::type::number) {
+            view.pool->at(row, field) = value.as<float>();
+          } else if (value.get_type() == sol::type::lua_nil) {
+            view.pool->at(row, field) = view.pool->defaults[field];
+          } else {
+            throw sol::error(view.pool->name + "." + key.as<std::string>() + " must be a number");
+          }
+          return;
+        }
+        sol::table &extras = view.pool->extras[row];
+        if (!extras.valid()) {
+          extras = _lua.create_table();
+        }
+        extras[key] = value;
+      });
+
+  // Indexing, ipairs, pairs and # read through to the ids; any write raises.
+  _readOnlyIds = _lua.script(R"lua(
+    return function(ids)
+      local count = #ids
+      return setmetatable({}, {
+        __index = ids,
+        __len = function() return count end,
+        __pairs = function() return next, ids, nil end,
+        __newindex = function() error("query ids are read-only, copy them before modifying", 2) end,
+        __metatable = false,
+      })
+    end
+  )lua");
+
+  _lua.new_usertype<EntityQuery>(
+      "EntityQuery", sol::no_constructor,
+      "ids", [this](EntityQuery &query) { return queryIds(query); },
+      "count", [](const EntityQuery &query) { return query.size(); },
+      sol::meta_function::length, [](const EntityQuery &query) { return query.size(); });
+
+  ecs.set_function("query", [this](sol::table components) -> EntityQuery * {
+    return resolveQuery(components);
+  });
+
+  ecs.set_function("getQueryStats", [this]() -> sol::table {
+    uint64_t lookups = 0;
+    uint64_t hits = 0;
+    uint64_t rebuilds = 0;
+    sol::table perQuery = _lua.create_table();
+    for (const auto &query : _queries) {
+      lookups += query->lookups;
+      hits += query->hits;
+      rebuilds += query->rebuilds;
+      sol::table entry = _lua.create_table();
+      entry["size"] = query->size();
+      entry["lookups"] = query->lookups;
+      entry["hits"] = query->hits;
+      entry["rebuilds"] = query->rebuilds;
+      perQuery[query->key] = entry;
+    }
+    sol::table stats = _lua.create_table();
+    stats["queries"] = _queries.size();
+    stats["built"] = _queriesBuilt;
+    stats["lookups"] = lookups;
+    stats["hits"] = hits;
+    stats["rebuilds"] = rebuilds;
+    // Share of id lists served from cache without rebuilding.
+    stats["hitRate"] = (hits + rebuilds) > 0 ? static_cast<double>(hits) / static_cast<double>(hits + rebuilds) : 0.0;
+    stats["perQuery"] = perQuery;
+    return stats;
+  });
+
+  ecs.set_function("registerComponent", [this](const std::string &name, sol::table schema) -> bool {
+    return registerComponentSchema(name, schema);
+  });
+
+  ecs.set_function("toTable", [this](sol::object component) -> sol::object {
+    if (!component.is<ComponentView>()) return component;
+    const ComponentView &view = component.as<const ComponentView &>();
+    uint32_t row = viewRow(view);
+    if (row == INVALID_INDEX) return sol::nil;
+    return componentToTable(*view.pool, row);
+  });
+}
+
+} // namespace rtypeEngine
@@ -20,6 +20,7 @@ namespace rtypeEngine {
 LuaECSManager::LuaECSManager(const char *pubEndpoint, const char *subEndpoint)
     : IECSManager(pubEndpoint, subEndpoint) {
   _lastFrameTime = std::chrono::high_resolution_clock::now();
+  setTickRate(1.0 / FIXED_DT);
 }
 
 LuaECSManager::~LuaECSManager() {}
@@ -159,6 +160,10 @@ void LuaECSManager::init() {
   });
 
   subscribe("EntityUpdated", [this](const std::string &msg) {
+    if (busCodec::isBinary(msg)) {
+      onBinaryEntityUpdated(msg);
+      return;
+    }
     std::stringstream ss(msg);
     std::string segment;
     while (std::getline(ss, segment, ';')) {
@@ -195,39 +200,124 @@ void LuaECSManager::init() {
     }
   });
 
+  subscribe("SnapshotReceived", [this](const std::string &msg) { onSnapshotReceived(msg); });
+
   std::cout << "[LuaECSManager] Initialized" << std::endl;
 }
 
+void LuaECSManager::onBinaryEntityUpdated(const std::string &msg) {
+  // Resolve the callbacks once per batch rather than once per body.
+  std::vector<sol::function> handlers;
+  for (auto &system : _systems) {
+    sol::object handler = system["onEntityUpdated"];
+    if (handler.valid() && handler.get_type() == sol::type::function) {
+      handlers.push_back(handler.as<sol::function>());
+    }
+  }
+  if (handlers.empty()) return;
+
+  bool ok = busCodec::decode(msg, [&](busCodec::Op op, const std::string &id, const float *v, uint16_t count) {
+    if (op != busCodec::Op::EntityUpdated || count < 6) return;
+    for (auto &handler : handlers) {
+      try {
+        handler(id, v[0], v[1], v[2], v[3], v[4], v[5]);
+      } catch (const sol::error &e) {
+        std::cerr << "[LuaECSManager] Error in onEntityUpdated: " << e.what() << std::endl;
+      }
+    }
+  });
+  if (!ok) {
+    std::cerr << "[LuaECSManager] Malformed binary EntityUpdated (" << msg.size() << " bytes)" << std::endl;
+  }
+}
+
+void LuaECSManager::sendMessage(const std::string &topic, const std::string &message) {
+  // Keep ordering with batched commands: anything queued for this channel goes first.
+  if (topic == "PhysicCommand" && !_physicBatch.empty()) {
+    AModule::sendMessage(topic, _physicBatch.take());
+  } else if (topic == "RenderEntityCommand" && !_renderBatch.empty()) {
+    AModule::sendMessage(topic, _renderBatch.take());
+  }
+  AModule::sendMessage(topic, message);
+}
+
+void LuaECSManager::processMessages() {
+  AModule::processMessages();
+  flushCommandBatches();
+}
+
+void LuaECSManager::flushCommandBatches() {
+  if (!_physicBatch.empty()) {
+    AModule::sendMessage("PhysicCommand", _physicBatch.take());
+  }
+  if (!_renderBatch.empty()) {
+    AModule::sendMessage("RenderEntityCommand", _renderBatch.take());
+  }
+}
+
 std::string LuaECSManager::generateUuid() {
+  // Random v4 UUID written straight into a fixed buffer: two 64-bit draws
+  // supply all 32 hex digits.
+  static const char HEX[] = "0123456789abcdef";
   static std::random_device rd;
-  static std::mt19937 gen(rd());
-  static std::uniform_int_distribution<> dis(0, 15);
-  static std::uniform_int_distribution<> dis2(8, 11);
-
-  std::stringstream ss;
-  int i;
-  ss << std::hex;
-  for (i = 0; i < 8; i++) {
-    ss << dis(gen);
+  static std::mt19937_64 gen(rd());
+
+  uint64_t bits[2] = {gen(), gen()};
+  char out[36];
+  int nibble = 0;
+  for (int i = 0; i < 36; ++i) {
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      out[i] = '-';
+      continue;
+    }
+    unsigned value = static_cast<unsigned>((bits[nibble / 16] >> ((nibble % 16) * 4)) & 0xF);
+    ++nibble;
+    if (i == 14) {
+      value = 4;                  // version
+    } else if (i == 19) {
+      value = 8 | (value & 0x3);  // variant 10xx
+    }
+    out[i] = HEX[value];
   }
-  ss << "-";
-  for (i = 0; i < 4; i++) {
-    ss << dis(gen);
+  return std::string(out, sizeof(out));
+}
+
+ComponentPool *LuaECSManager::findPool(const std::string &name) {
+  auto it = _pools.find(name);
+  return it != _pools.end() ? &it->second : nullptr;
+}
+
+void LuaECSManager::releaseEntity(EntityHandle handle) {
+  uint32_t index = entityIndex(handle);
+  for (auto &pair : _pools) {
+    pair.second.remove(index);
   }
-  ss << "-4";
-  for (i = 0; i < 3; i++) {
-    ss << dis(gen);
+  for (auto &pair : _typedPools) {
+    pair.second.remove(index);
   }
-  ss << "-";
-  ss << dis2(gen);
-  for (i = 0; i < 3; i++) {
-    ss << dis(gen);
+  for (auto &query : _queries) {
+    query->remove(index);
   }
-  ss << "-";
-  for (i = 0; i < 12; i++) {
-    ss << dis(gen);
+  _replicated.remove(index);
+  _registry.destroy(handle);
+}
+
+void LuaECSManager::destroyAllEntities() {
+  for (uint32_t index : _registry.aliveIndices()) {
+    const std::string &id = _registry.idAt(index);
+    sendMessage("PhysicCommand", "DestroyBody:" + id + ";");
+    sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
   }
-  return ss.str();
+  _registry.clear();
+  _pools.clear();
+  // Typed pools keep their schema; scripts register them once at load time.
+  for (auto &pair : _typedPools) {
+    pair.second.clear();
+  }
+  for (auto &query : _queries) {
+    query->clear();
+  }
+  _replicated.clear();
 }
 
 void LuaECSManager::loadScript(const std::string &path) {
@@ -242,14 +332,12 @@ void LuaECSManager::loadScript(const std::string &path) {
 
 void LuaECSManager::unloadScript(const std::string& path) {
     try {
-        for (const auto& id : _entities) {
-            sendMessage("PhysicCommand", "DestroyBody:" + id + ";");
-            sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
-        }
-
+        destroyAllEntities();
+        clearQueries();
+        _readOnlyIds = sol::function();
+        _replicatedFields.clear();
+        _typedPools.clear();
         _systems.clear();
-        _entities.clear();
-        _pools.clear();
 
         _lua = sol::state();
         _lua.open_libraries(sol::lib::base, sol::lib::package, sol::lib::string, sol::lib::table, sol::lib::math, sol::lib::io, sol::lib::os);
@@ -288,14 +376,24 @@ void LuaECSManager::loop() {
     _accumulator -= FIXED_DT;
   }
 
-  auto sleepTime = std::chrono::milliseconds(10);
-  std::this_thread::sleep_for(sleepTime);
+  if (_isServer && _snapshotInterval > 0.0) {
+    _snapshotAccumulator += deltaTime;
+    if (_snapshotAccumulator >= _snapshotInterval) {
+      _snapshotAccumulator = std::min(_snapshotAccumulator - _snapshotInterval, _snapshotInterval);
+      publishSnapshot();
+    }
+  }
+
+  flushCommandBatches();
 }
 
 void LuaECSManager::cleanup() {
   _systems.clear();
-  _entities.clear();
+  _registry.clear();
   _pools.clear();
+  _typedPools.clear();
+  _replicated.clear();
+  clearQueries();
   _luaListeners.clear();
 }
 
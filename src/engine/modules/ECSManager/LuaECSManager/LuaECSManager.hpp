@@ -15,6 +15,7 @@
  * | `MouseMoved` | WindowManager | Mouse movement |
  * | `Collision` | PhysicEngine | Physics collision events |
  * | `NetworkMessage` | NetworkManager | Network messages |
+ * | `SnapshotReceived` | NetworkManager | Replicated entities (client, `onSnapshotEntity`) |
  * | Custom topics | Various | Game-specific events |
  * 
  * @section channels_pub Published Channels (from Lua)
@@ -25,6 +26,7 @@
  * | `SoundPlay` | SoundManager | Play sound effects |
  * | `MusicPlay` | SoundManager | Play music |
  * | `RequestNetworkSend` | NetworkManager | Send network message |
+ * | `NetworkSnapshot` | NetworkManager | Replicated entity state (server) |
  * | `ExitApplication` | Application | Exit the application |
  * 
  * @section lua_api Lua API
@@ -34,9 +36,28 @@
  * - `ECS.addComponent(id, name, data)` - Add component
  * - `ECS.getComponent(id, name)` - Get component
  * - `ECS.getEntitiesWith({components})` - Query entities
+ * - `ECS.query({components})` - Persistent query; `q:ids()` (read-only), `q:count()`
+ * - `ECS.getQueryStats()` - Query cache hit counters
+ * - `ECS.registerComponent(name, {field = default, ...})` - Typed float storage
+ * - `ECS.toTable(component)` - Plain table copy of a component
  * - `ECS.subscribe(topic, handler)` - Subscribe to channel
  * - `ECS.sendMessage(topic, payload)` - Publish message
+ * - `ECS.sendPhysicCommand(cmd, id, ...)` - Batched PhysicCommand (binary)
+ * - `ECS.sendRenderCommand(cmd, id, ...)` - Batched RenderEntityCommand (binary)
+ * - `ECS.replicate(id, kind)` / `ECS.unreplicate(id)` - Snapshot replication (server)
+ * - `ECS.setReplicatedFields({{component, field...}, ...})` - Fields sent in snapshots
+ * - `ECS.setSnapshotRate(hz)` - Snapshot publish rate (default 20 Hz)
  * - `ECS.registerSystem(system)` - Register system table
+ *
+ * @section entities Entity storage
+ * Entities are slot indices with a generation counter (see types/ecs.hpp);
+ * component pools are sparse sets indexed by slot. The string UUIDs are kept
+ * only at the boundary (Lua, bus messages, saves) and resolved once per call.
+ *
+ * Components registered with `ECS.registerComponent` are stored as float
+ * columns; `ECS.getComponent` then returns a view userdata that reads and
+ * writes the columns in place (non-schema keys live in a side table).
+ * Unregistered components keep the generic one-table-per-entity storage.
  * 
  * @see docs/CHANNELS.md for complete channel reference
  * @see assets/scripts/ for Lua game scripts
@@ -44,9 +65,11 @@
 
 #pragma once
 
+#include "../../../types/busCodec.hpp"
 #include "../../../types/ecs.hpp"
 #include "../IECSManager.hpp"
 #include <map>
+#include <memory>
 #include <sol/sol.hpp>
 #include <string>
 #include <unordered_map>
@@ -54,6 +77,12 @@
 
 namespace rtypeEngine {
 
+/// Lua-side handle on one row of a TypedComponentPool (`t.x` reads the column).
+struct ComponentView {
+  TypedComponentPool *pool;
+  EntityHandle handle;
+};
+
 class LuaECSManager : public IECSManager {
 public:
   LuaECSManager(const char *pubEndpoint, const char *subEndpoint);
@@ -63,6 +92,9 @@ public:
   void loop() override;
   void cleanup() override;
 
+  void sendMessage(const std::string &topic, const std::string &message) override;
+  void processMessages() override;
+
         void loadScript(const std::string& path);
         void unloadScript(const std::string& path);
 
@@ -73,8 +105,13 @@ private:
   std::string serializeTable(const sol::table &table);
   sol::state _lua;
   std::vector<sol::table> _systems;
-  std::vector<std::string> _entities;
+  EntityRegistry _registry;
   std::unordered_map<std::string, ComponentPool> _pools;
+  std::unordered_map<std::string, TypedComponentPool> _typedPools;
+  std::vector<std::unique_ptr<EntityQuery>> _queries;
+  std::unordered_map<std::string, EntityQuery *> _queryByKey;
+  uint64_t _queriesBuilt = 0;
+  sol::function _readOnlyIds; // wraps a query's id table in a read-only view
   std::map<std::string, std::vector<sol::function>> _luaListeners;
   bool _isServer = false;
   sol::table _capabilities;
@@ -84,8 +121,56 @@ private:
   const double FIXED_DT = 1.0 / 60.0;  // 60 Hz (16.666ms)
   const double MAX_FRAME_TIME = 0.25;
 
+  // Per-entity float commands queued by ECS.sendPhysicCommand / ECS.sendRenderCommand,
+  // published as one busCodec payload per channel after each tick.
+  busCodec::BatchWriter _physicBatch;
+  busCodec::BatchWriter _renderBatch;
+
+  // Snapshot replication: entities marked with ECS.replicate (column 0 is
+  // their kind) are published on NetworkSnapshot by the server.
+  TypedComponentPool _replicated{"Replicated", {"kind"}, {0.0f}};
+  // The component fields sent for them, set by ECS.setReplicatedFields.
+  struct ReplicatedComponent {
+    std::string name;
+    std::vector<std::string> fields;
+  };
+  std::vector<ReplicatedComponent> _replicatedFields;
+  busCodec::BatchWriter _snapshotBatch;
+  double _snapshotInterval = 1.0 / 20.0;
+  double _snapshotAccumulator = 0.0;
+  bool _lastSnapshotEmpty = true;
+
   void setupLuaBindings();
   std::string generateUuid();
+  ComponentPool *findPool(const std::string &name);
+  TypedComponentPool *findTypedPool(const std::string &name);
+  SparseSet *findStorage(const std::string &name);
+
+  // Typed (schema-registered) components, see LuaComponents.cpp
+  void setupComponentBindings(sol::table &ecs);
+  bool registerComponentSchema(const std::string &name, const sol::table &schema);
+  void writeTypedComponent(TypedComponentPool &pool, uint32_t index, const sol::table &data);
+  sol::table componentToTable(TypedComponentPool &pool, uint32_t row);
+  uint32_t viewRow(const ComponentView &view) const;
+  void storeComponent(const std::string &name, EntityHandle handle, const sol::object &data);
+  sol::object loadComponent(const std::string &name, EntityHandle handle);
+  void removeComponent(const std::string &name, EntityHandle handle);
+
+  // Persistent queries (ECS.query / getEntitiesWith)
+  EntityQuery *resolveQuery(const sol::table &components);
+  sol::table queryIds(EntityQuery &query);
+  bool matchesQuery(const EntityQuery &query, uint32_t index);
+  void onComponentAdded(const std::string &name, uint32_t index);
+  void clearQueries();
+  void releaseEntity(EntityHandle handle);
+  void destroyAllEntities();
+  void onBinaryEntityUpdated(const std::string &msg);
+  void flushCommandBatches();
+
+  // Snapshot replication, see LuaReplication.cpp
+  void setupReplicationBindings(sol::table &ecs);
+  void publishSnapshot();
+  void onSnapshotReceived(const std::string &msg);
 };
 
 } // namespace rtypeEngine
@@ -0,0 +1,169 @@
+#include "LuaECSManager.hpp"
+#include <algorithm>
+#include <iostream>
+
+namespace rtypeEngine {
+
+namespace {
+
+constexpr std::size_t SNAPSHOT_FLOATS = 10;  // kind + the registered fields
+
+/// Reads the registered float fields of one component, typed or generic.
+struct FieldReader {
+  TypedComponentPool *typed = nullptr;
+  ComponentPool *generic = nullptr;
+  const std::vector<std::string> &names;
+  int columns[SNAPSHOT_FLOATS - 1] = {};
+
+  FieldReader(TypedComponentPool *typedPool, ComponentPool *genericPool, const std::vector<std::string> &fieldNames)
+      : typed(typedPool), generic(genericPool), names(fieldNames) {
+    if (typed) {
+      for (std::size_t i = 0; i < names.size(); ++i) {
+        columns[i] = typed->fieldIndex(names[i]);
+      }
+    }
+  }
+
+  /// Fills `out` (missing fields read 0); false if the entity lacks the component.
+  bool read(uint32_t index, float *out) {
+    if (typed) {
+      uint32_t row = typed->rowOf(index);
+      if (row == INVALID_INDEX) return false;
+      for (std::size_t i = 0; i < names.size(); ++i) {
+        out[i] = columns[i] >= 0 ? typed->at(row, columns[i]) : 0.0f;
+      }
+      return true;
+    }
+    if (generic) {
+      sol::table *component = generic->get(index);
+      if (!component) return false;
+      for (std::size_t i = 0; i < names.size(); ++i) {
+        out[i] = component->get_or(names[i], 0.0f);
+      }
+      return true;
+    }
+    return false;
+  }
+};
+
+} // namespace
+
+void LuaECSManager::publishSnapshot() {
+  std::vector<FieldReader> readers;
+  readers.reserve(_replicatedFields.size());
+  for (const auto &component : _replicatedFields) {
+    readers.emplace_back(findTypedPool(component.name), findPool(component.name), component.fields);
+  }
+
+  float values[SNAPSHOT_FLOATS];
+  for (std::size_t row = 0; row < _replicated.size() && !readers.empty(); ++row) {
+    uint32_t index = _replicated.entities[row];
+    values[0] = _replicated.at(static_cast<uint32_t>(row), 0);
+    std::fill(values + 1, values + SNAPSHOT_FLOATS, 0.0f);
+    // The first registered component is required, the others read 0 when missing.
+    if (!readers[0].read(index, values + 1)) continue;
+    float *slot = values + 1 + readers[0].names.size();
+    for (std::size_t c = 1; c < readers.size(); ++c) {
+      readers[c].read(index, slot);
+      slot += readers[c].names.size();
+    }
+    _snapshotBatch.add(busCodec::Op::SnapshotEntity, _registry.idAt(index), values, SNAPSHOT_FLOATS);
+  }
+
+  // An empty world is published once so clients see the last removals.
+  bool empty = _snapshotBatch.empty();
+  if (empty && _lastSnapshotEmpty) return;
+  AModule::sendMessage("NetworkSnapshot", empty ? busCodec::emptyPayload() : _snapshotBatch.take());
+  _lastSnapshotEmpty = empty;
+}
+
+void LuaECSManager::onSnapshotReceived(const std::string &msg) {
+  // Resolve the callbacks once per snapshot rather than once per entity.
+  std::vector<sol::function> onEntity;
+  std::vector<sol::function> onRemoved;
+  for (auto &system : _systems) {
+    sol::object handler = system["onSnapshotEntity"];
+    if (handler.valid() && handler.get_type() == sol::type::function) {
+      onEntity.push_back(handler.as<sol::function>());
+    }
+    handler = system["onSnapshotRemoved"];
+    if (handler.valid() && handler.get_type() == sol::type::function) {
+      onRemoved.push_back(handler.as<sol::function>());
+    }
+  }
+  if (onEntity.empty() && onRemoved.empty()) return;
+
+  bool ok = busCodec::decode(msg, [&](busCodec::Op op, const std::string &id, const float *v, uint16_t count) {
+    try {
+      if (op == busCodec::Op::SnapshotEntity && count >= SNAPSHOT_FLOATS) {
+        int kind = static_cast<int>(v[0]);
+        for (auto &handler : onEntity) {
+          handler(id, kind, v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8], v[9]);
+        }
+      } else if (op == busCodec::Op::SnapshotRemoved) {
+        for (auto &handler : onRemoved) {
+          handler(id);
+        }
+      }
+    } catch (const sol::error &e) {
+      std::cerr << "[LuaECSManager] Error in snapshot handler: " << e.what() << std::endl;
+    }
+  });
+  if (!ok) {
+    std::cerr << "[LuaECSManager] Malformed SnapshotReceived (" << msg.size() << " bytes)" << std::endl;
+  }
+}
+
+void LuaECSManager::setupReplicationBindings(sol::table &ecs) {
+  // Server side: mark an entity for snapshot replication. `kind` tells
+  // clients what to spawn for it (game defined, must be an integer).
+  ecs.set_function("replicate", [this](const std::string &id, int kind) {
+    EntityHandle handle = _registry.find(id);
+    if (handle == INVALID_ENTITY) return;
+    uint32_t row = _replicated.emplace(entityIndex(handle));
+    _replicated.at(row, 0) = static_cast<float>(kind);
+  });
+
+  ecs.set_function("unreplicate", [this](const std::string &id) {
+    EntityHandle handle = _registry.find(id);
+    if (handle != INVALID_ENTITY) {
+      _replicated.remove(entityIndex(handle));
+    }
+  });
+
+  // Which component fields fill the nine value slots of a snapshot entity,
+  // in order: ECS.setReplicatedFields({{"Transform", "x", "y"}, {"Physic", "vx"}}).
+  // Entities lacking the first component are not published.
+  ecs.set_function("setReplicatedFields", [this](sol::table components) -> bool {
+    std::vector<ReplicatedComponent> parsed;
+    std::size_t slots = 0;
+    for (std::size_t c = 1; c <= components.size(); ++c) {
+      sol::optional<sol::table> entry = components[c];
+      if (!entry || entry->size() < 2) {
+        std::cerr << "[LuaECSManager] setReplicatedFields: entry " << c << " must be {component, field...}" << std::endl;
+        return false;
+      }
+      ReplicatedComponent component;
+      component.name = entry->get<std::string>(1);
+      for (std::size_t f = 2; f <= entry->size(); ++f) {
+        component.fields.push_back(entry->get<std::string>(f));
+      }
+      slots += component.fields.size();
+      parsed.push_back(std::move(component));
+    }
+    if (slots > SNAPSHOT_FLOATS - 1) {
+      std::cerr << "[LuaECSManager] setReplicatedFields: " << slots << " fields, at most "
+                << SNAPSHOT_FLOATS - 1 << " fit a snapshot" << std::endl;
+      return false;
+    }
+    _replicatedFields = std::move(parsed);
+    return true;
+  });
+
+  ecs.set_function("setSnapshotRate", [this](double hz) {
+    _snapshotInterval = hz > 0.0 ? 1.0 / hz : 0.0;
+    _snapshotAccumulator = 0.0;
+  });
+}
+
+} // namespace rtypeEngine
@@ -45,8 +45,9 @@ std::string LuaECSManager::serializeTable(const sol::table &table) {
 std::string LuaECSManager::serializeState() {
   std::stringstream ss;
   ss << "ENTITIES:";
-  for (size_t i = 0; i < _entities.size(); ++i) {
-    ss << _entities[i] << (i == _entities.size() - 1 ? "" : ",");
+  const auto &alive = _registry.aliveIndices();
+  for (size_t i = 0; i < alive.size(); ++i) {
+    ss << _registry.idAt(alive[i]) << (i == alive.size() - 1 ? "" : ",");
   }
   ss << ";\n";
 
@@ -55,7 +56,7 @@ std::string LuaECSManager::serializeState() {
     ComponentPool &pool = pair.second;
     ss << "POOL:" << poolName << ";\n";
     for (size_t i = 0; i < pool.dense.size(); ++i) {
-      std::string entityId = pool.entities[i];
+      const std::string &entityId = _registry.idAt(pool.entities[i]);
       sol::table comp = pool.dense[i];
       std::string serializedComp;
       try {
@@ -67,17 +68,20 @@ std::string LuaECSManager::serializeState() {
       ss << "COMP:" << entityId << ":" << serializedComp << ";\n";
     }
   }
+
+  for (auto &pair : _typedPools) {
+    TypedComponentPool &pool = pair.second;
+    ss << "POOL:" << pair.first << ";\n";
+    for (uint32_t row = 0; row < pool.size(); ++row) {
+      ss << "COMP:" << _registry.idAt(pool.entities[row]) << ":"
+         << serializeTable(componentToTable(pool, row)) << ";\n";
+    }
+  }
   return ss.str();
 }
 
 void LuaECSManager::deserializeState(const std::string &state) {
-  for (const auto &id : _entities) {
-    sendMessage("PhysicCommand", "DestroyBody:" + id + ";");
-    sendMessage("RenderEntityCommand", "DestroyEntity:" + id + ";");
-  }
-
-  _entities.clear();
-  _pools.clear();
+  destroyAllEntities();
 
   std::stringstream ss(state);
   std::string line;
@@ -95,7 +99,7 @@ void LuaECSManager::deserializeState(const std::string &state) {
       std::string entityId;
       while (std::getline(ess, entityId, ',')) {
         if (!entityId.empty()) {
-          _entities.push_back(entityId);
+          _registry.findOrCreate(entityId);
         }
       }
     } else if (line.rfind("POOL:", 0) == 0) {
@@ -113,11 +117,7 @@ void LuaECSManager::deserializeState(const std::string &state) {
 
       try {
         sol::table comp = _lua.script("return " + data);
-        ComponentPool &pool = _pools[currentPoolName];
-
-        pool.dense.push_back(comp);
-        pool.entities.push_back(entityId);
-        pool.sparse[entityId] = pool.dense.size() - 1;
+        storeComponent(currentPoolName, _registry.findOrCreate(entityId), comp);
 
       } catch (const sol::error &e) {
         std::cerr << "[LuaECSManager] Error deserializing component: " << e.what() << std::endl;
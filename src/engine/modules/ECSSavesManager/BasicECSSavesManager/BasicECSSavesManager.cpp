@@ -14,6 +14,8 @@ namespace rtypeEngine {
 
     ECSSavesManager::ECSSavesManager(const char* pubEndpoint, const char* subEndpoint)
         : IECSSavesManager(pubEndpoint, subEndpoint) {
+        // Purely request driven: no periodic work, wake only on messages.
+        setTickRate(0.0);
     }
 
     ECSSavesManager::~ECSSavesManager() {
@@ -46,7 +48,6 @@ namespace rtypeEngine {
     }
 
     void ECSSavesManager::loop() {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
     void ECSSavesManager::cleanup() {
@@ -0,0 +1,97 @@
+/**
+ * @file EndpointTable.hpp
+ * @brief Flat hash table from UDP endpoint to client id
+ *
+ * @details The server looks up the sender of every datagram. Keys are the
+ * raw address and port (IPv4 stored IPv4-mapped, `::ffff:a.b.c.d`), so a
+ * lookup hashes 18 bytes instead of formatting "ip:port" into a string.
+ *
+ * Open addressing with linear probing over one array of slots; the table
+ * doubles when half full. Entries are never removed one by one (a client
+ * that times out keeps its id until the socket is closed), so probing needs
+ * no tombstones. Not synchronized: the io thread owns it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace rtypeEngine {
+
+struct EndpointKey {
+  uint64_t high = 0;  // address bytes 0-7
+  uint64_t low = 0;   // address bytes 8-15
+  uint16_t port = 0;
+
+  bool operator==(const EndpointKey &other) const {
+    return high == other.high && low == other.low && port == other.port;
+  }
+};
+
+class EndpointTable {
+ public:
+  static constexpr std::size_t INITIAL_CAPACITY = 64;
+
+  EndpointTable() { clear(); }
+
+  /// Client id stored for `key`, 0 if absent.
+  uint32_t find(const EndpointKey &key) const {
+    for (std::size_t i = hash(key) & _mask;; i = (i + 1) & _mask) {
+      const Slot &slot = _slots[i];
+      if (slot.id == 0) return 0;
+      if (slot.key == key) return slot.id;
+    }
+  }
+
+  /// `key` must be absent and `id` nonzero.
+  void insert(const EndpointKey &key, uint32_t id) {
+    if ((_size + 1) * 2 > _slots.size()) grow();
+    place(key, id);
+    ++_size;
+  }
+
+  void clear() {
+    _slots.assign(INITIAL_CAPACITY, Slot{});
+    _mask = INITIAL_CAPACITY - 1;
+    _size = 0;
+  }
+
+  std::size_t size() const { return _size; }
+
+ private:
+  struct Slot {
+    EndpointKey key;
+    uint32_t id = 0;  // 0 = empty
+  };
+
+  static std::size_t hash(const EndpointKey &key) {
+    uint64_t h = key.low * 0x9E3779B97F4A7C15ull;
+    h ^= (key.high + key.port) * 0xC2B2AE3D27D4EB4Full;
+    h ^= h >> 29;
+    h *= 0xBF58476D1CE4E5B9ull;
+    return static_cast<std::size_t>(h ^ (h >> 32));
+  }
+
+  void place(const EndpointKey &key, uint32_t id) {
+    std::size_t i = hash(key) & _mask;
+    while (_slots[i].id != 0) i = (i + 1) & _mask;
+    _slots[i] = Slot{key, id};
+  }
+
+  void grow() {
+    std::vector<Slot> old(_slots.size() * 2);
+    old.swap(_slots);
+    _mask = _slots.size() - 1;
+    for (const Slot &slot : old) {
+      if (slot.id != 0) place(slot.key, slot.id);
+    }
+  }
+
+  std::vector<Slot> _slots;
+  std::size_t _mask = 0;
+  std::size_t _size = 0;
+};
+
+}  // namespace rtypeEngine
@@ -0,0 +1,141 @@
+/**
+ * @file MessageRing.hpp
+ * @brief Bounded lock-free queue for the io thread -> module thread handoff
+ *
+ * @details A fixed ring of pre-allocated slots (D. Vyukov's bounded queue):
+ * each slot carries a sequence number telling producers and the consumer
+ * whose turn it is, so pushing and popping are a CAS on a shared index and
+ * no lock is ever taken. Any number of threads may push; pops must come from
+ * one thread at a time.
+ *
+ * Messages are written into and read from the slots in place. Slot strings
+ * keep their capacity from one lap to the next (and start with
+ * `SLOT_RESERVE` bytes), so steady traffic does not allocate.
+ *
+ * When the ring is full the new message is rejected. Topics flagged `Shed`
+ * are rejected earlier, once the ring is half full, so bulk traffic cannot
+ * crowd out the messages that matter when the consumer falls behind.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace rtypeEngine {
+
+enum class DropPolicy : uint8_t {
+  Keep = 0,  // dropped only when the ring is full
+  Shed = 1,  // dropped once the ring is half full
+};
+
+/// "keep" or "shed"; false for anything else.
+inline bool parseDropPolicy(const std::string &name, DropPolicy &out) {
+  if (name == "keep") {
+    out = DropPolicy::Keep;
+  } else if (name == "shed") {
+    out = DropPolicy::Shed;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+template <typename T>
+class MessageRing {
+ public:
+  static constexpr std::size_t SLOT_RESERVE = 256;
+
+  /// Capacity is rounded up to a power of two (at least 2).
+  explicit MessageRing(std::size_t capacity) {
+    std::size_t size = 2;
+    while (size < capacity) size <<= 1;
+    _mask = size - 1;
+    _cells = std::make_unique<Cell[]>(size);
+    for (std::size_t i = 0; i < size; ++i) {
+      _cells[i].sequence.store(i, std::memory_order_relaxed);
+      reserveSlot(_cells[i].value, 0);
+    }
+  }
+
+  MessageRing(const MessageRing &) = delete;
+  MessageRing &operator=(const MessageRing &) = delete;
+
+  /// Claims a slot and lets `fill(T &)` write it; false if the policy refuses.
+  template <typename Fill>
+  bool tryPush(Fill &&fill, DropPolicy policy = DropPolicy::Keep) {
+    if (policy == DropPolicy::Shed && size() >= capacity() / 2) return false;
+
+    std::size_t pos = _enqueue.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &_cells[pos & _mask];
+      std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+      if (diff == 0) {
+        if (_enqueue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;  // full
+      } else {
+        pos = _enqueue.load(std::memory_order_relaxed);
+      }
+    }
+    fill(cell->value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Hands the oldest message to `read(T &)` and frees its slot; false if empty.
+  template <typename Read>
+  bool tryPop(Read &&read) {
+    std::size_t pos = _dequeue.load(std::memory_order_relaxed);
+    Cell *cell;
+    for (;;) {
+      cell = &_cells[pos & _mask];
+      std::size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+      if (diff == 0) {
+        if (_dequeue.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        return false;  // empty
+      } else {
+        pos = _dequeue.load(std::memory_order_relaxed);
+      }
+    }
+    read(cell->value);
+    cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Approximate while other threads push or pop.
+  std::size_t size() const {
+    std::size_t enqueued = _enqueue.load(std::memory_order_relaxed);
+    std::size_t dequeued = _dequeue.load(std::memory_order_relaxed);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+  std::size_t capacity() const { return _mask + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<std::size_t> sequence{0};
+    T value;
+  };
+
+  template <typename U>
+  static auto reserveSlot(U &value, int) -> decltype(value.payload.reserve(0), void()) {
+    value.payload.reserve(SLOT_RESERVE);
+  }
+  template <typename U>
+  static void reserveSlot(U &, long) {}
+
+  std::unique_ptr<Cell[]> _cells;
+  std::size_t _mask = 0;
+  alignas(64) std::atomic<std::size_t> _enqueue{0};
+  alignas(64) std::atomic<std::size_t> _dequeue{0};
+};
+
+}  // namespace rtypeEngine
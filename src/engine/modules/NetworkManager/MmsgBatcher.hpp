@@ -0,0 +1,155 @@
+/**
+ * @file MmsgBatcher.hpp
+ * @brief Batched UDP receive/send with recvmmsg(2)/sendmmsg(2) (Linux only)
+ *
+ * @details Optional server backend for NetworkManager, enabled with
+ * `RTYPE_NET_BACKEND=mmsg`. One `recvmmsg` call drains up to `batch`
+ * datagrams into a pool of receive buffers allocated once; outgoing
+ * datagrams are queued and leave with one `sendmmsg` call per io-loop turn
+ * instead of one `sendto` each.
+ *
+ * The batcher only deals with the file descriptor and socket addresses, the
+ * NetworkManager keeps driving readiness through asio (`async_wait`).
+ */
+
+#pragma once
+
+#ifdef __linux__
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace rtypeEngine {
+
+class MmsgBatcher {
+ public:
+  using Datagram = std::shared_ptr<std::vector<char>>;
+
+  static constexpr std::size_t DEFAULT_BATCH = 32;
+  static constexpr std::size_t MAX_DATAGRAM = 65536;
+
+  explicit MmsgBatcher(std::size_t batch = DEFAULT_BATCH, std::size_t bufferSize = MAX_DATAGRAM)
+      : _batch(batch), _bufferSize(bufferSize), _buffers(batch * bufferSize), _recvIov(batch),
+        _recvAddrs(batch), _recvHeaders(batch), _sendIov(batch), _sendHeaders(batch) {
+    for (std::size_t i = 0; i < _batch; ++i) {
+      _recvIov[i].iov_base = _buffers.data() + i * _bufferSize;
+      _recvIov[i].iov_len = _bufferSize;
+    }
+  }
+
+  std::size_t batch() const { return _batch; }
+
+  /**
+   * One non-blocking recvmmsg call; `onDatagram(data, size, addr, addrLen)`
+   * runs for every datagram received. The data stays valid until the next
+   * call to receive().
+   * @return datagrams received, 0 if none was waiting, -1 on error (errno set).
+   */
+  template <typename OnDatagram>
+  int receive(int fd, OnDatagram &&onDatagram) {
+    for (std::size_t i = 0; i < _batch; ++i) {
+      std::memset(&_recvHeaders[i], 0, sizeof(mmsghdr));
+      _recvHeaders[i].msg_hdr.msg_iov = &_recvIov[i];
+      _recvHeaders[i].msg_hdr.msg_iovlen = 1;
+      _recvHeaders[i].msg_hdr.msg_name = &_recvAddrs[i];
+      _recvHeaders[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+    }
+    int count = ::recvmmsg(fd, _recvHeaders.data(), static_cast<unsigned>(_batch), MSG_DONTWAIT, nullptr);
+    if (count < 0) {
+      return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+    for (int i = 0; i < count; ++i) {
+      const mmsghdr &header = _recvHeaders[i];
+      if (header.msg_hdr.msg_flags & MSG_TRUNC) continue;  // larger than a pool buffer
+      onDatagram(static_cast<const char *>(_recvIov[i].iov_base), static_cast<std::size_t>(header.msg_len),
+                 reinterpret_cast<const sockaddr *>(&_recvAddrs[i]), header.msg_hdr.msg_namelen);
+    }
+    return count;
+  }
+
+  void queue(const sockaddr *addr, socklen_t addrLen, Datagram datagram) {
+    Outgoing outgoing;
+    std::memcpy(&outgoing.addr, addr, addrLen);
+    outgoing.addrLen = addrLen;
+    outgoing.datagram = std::move(datagram);
+    _outgoing.push_back(std::move(outgoing));
+  }
+
+  bool pending() const { return !_outgoing.empty(); }
+  std::size_t pendingCount() const { return _outgoing.size(); }
+
+  struct FlushResult {
+    std::size_t sent = 0;
+    std::size_t calls = 0;
+    std::size_t failed = 0;  // datagrams dropped on a hard error
+    int error = 0;           // errno of the last hard error
+    bool wouldBlock = false; // stopped early, wait for the socket to be writable
+  };
+
+  /// Sends queued datagrams, `batch` per sendmmsg call, until done or blocked.
+  FlushResult flush(int fd) {
+    FlushResult result;
+    while (!_outgoing.empty()) {
+      std::size_t count = std::min(_batch, _outgoing.size());
+      for (std::size_t i = 0; i < count; ++i) {
+        Outgoing &outgoing = _outgoing[i];
+        _sendIov[i].iov_base = outgoing.datagram->data();
+        _sendIov[i].iov_len = outgoing.datagram->size();
+        std::memset(&_sendHeaders[i], 0, sizeof(mmsghdr));
+        _sendHeaders[i].msg_hdr.msg_iov = &_sendIov[i];
+        _sendHeaders[i].msg_hdr.msg_iovlen = 1;
+        _sendHeaders[i].msg_hdr.msg_name = &outgoing.addr;
+        _sendHeaders[i].msg_hdr.msg_namelen = outgoing.addrLen;
+      }
+
+      int sent = ::sendmmsg(fd, _sendHeaders.data(), static_cast<unsigned>(count), MSG_DONTWAIT);
+      ++result.calls;
+      if (sent < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+          result.wouldBlock = true;
+          return result;
+        }
+        if (errno == EINTR) continue;
+        // The first datagram cannot be sent (e.g. unreachable address): drop it.
+        result.error = errno;
+        ++result.failed;
+        _outgoing.pop_front();
+        continue;
+      }
+      result.sent += static_cast<std::size_t>(sent);
+      _outgoing.erase(_outgoing.begin(), _outgoing.begin() + sent);
+    }
+    return result;
+  }
+
+  void clear() { _outgoing.clear(); }
+
+ private:
+  struct Outgoing {
+    sockaddr_storage addr{};
+    socklen_t addrLen = 0;
+    Datagram datagram;
+  };
+
+  std::size_t _batch;
+  std::size_t _bufferSize;
+  std::vector<char> _buffers;  // receive pool: `batch` buffers of `bufferSize`
+  std::vector<iovec> _recvIov;
+  std::vector<sockaddr_storage> _recvAddrs;
+  std::vector<mmsghdr> _recvHeaders;
+  std::vector<iovec> _sendIov;
+  std::vector<mmsghdr> _sendHeaders;
+  std::deque<Outgoing> _outgoing;
+};
+
+}  // namespace rtypeEngine
+
+#endif  // __linux__
@@ -1,4 +1,5 @@
 #include "NetworkManager.hpp"
+#include "../../types/busCodec.hpp"
 
 #include <msgpack.hpp>
 
@@ -11,9 +12,13 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <cerrno>
 #include <chrono>
+#include <cstdlib>
 #include <cstring>
+#include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 
 namespace {
@@ -34,36 +39,128 @@ std::string toLower(std::string value) {
   return value;
 }
 
+std::size_t envSize(const char *name, std::size_t fallback) {
+  const char *value = std::getenv(name);
+  if (value == nullptr || value[0] == '\0') {
+    return fallback;
+  }
+  char *end = nullptr;
+  unsigned long long parsed = std::strtoull(value, &end, 10);
+  return (end != nullptr && *end == '\0') ? static_cast<std::size_t>(parsed)
+                                           : fallback;
+}
+
+std::size_t envQueueCapacity(std::size_t fallback) {
+  return std::clamp<std::size_t>(envSize("RTYPE_NET_QUEUE", fallback), 64,
+                                 std::size_t{1} << 20);
+}
+
 std::string endpointToString(const asio::ip::udp::endpoint &ep) {
   return ep.address().to_string() + ":" + std::to_string(ep.port());
 }
 
+rtypeEngine::EndpointKey endpointKey(const asio::ip::udp::endpoint &ep) {
+  rtypeEngine::EndpointKey key;
+  key.port = ep.port();
+  const asio::ip::address address = ep.address();
+  if (address.is_v4()) {
+    key.low = 0xFFFF00000000ull | address.to_v4().to_uint();
+  } else {
+    const auto bytes = address.to_v6().to_bytes();
+    for (std::size_t i = 0; i < 8; ++i) {
+      key.high = (key.high << 8) | bytes[i];
+      key.low = (key.low << 8) | bytes[i + 8];
+    }
+  }
+  return key;
+}
+
+// Unreliable envelopes only carry topic and payload; missing trailing
+// fields unpack as 0.
 struct SerializableEnvelope {
   std::string topic;
   std::string payload;
-
-  SerializableEnvelope() = default;
-  explicit SerializableEnvelope(const rtypeEngine::NetworkEnvelope &envelope)
-      : topic(envelope.topic), payload(envelope.payload) {}
+  uint8_t channel = 0;
+  uint32_t sequence = 0;
+  uint32_t stream = 0;
+  uint32_t base = 0;
 
   rtypeEngine::NetworkEnvelope toEnvelope(uint32_t clientId = 0) const {
     return {topic, payload, clientId};
   }
 
-  MSGPACK_DEFINE(topic, payload);
+  MSGPACK_DEFINE(topic, payload, channel, sequence, stream, base);
 };
 
+std::shared_ptr<std::vector<char>>
+packEnvelope(const std::string &topic, const std::string &payload,
+             rtypeEngine::channel::Delivery delivery =
+                 rtypeEngine::channel::Delivery::Unreliable,
+             uint32_t sequence = 0, uint32_t stream = 0, uint32_t base = 0) {
+  msgpack::sbuffer buffer;
+  msgpack::packer<msgpack::sbuffer> packer(buffer);
+  if (delivery == rtypeEngine::channel::Delivery::Unreliable) {
+    packer.pack_array(2);
+    packer.pack(topic);
+    packer.pack(payload);
+  } else {
+    packer.pack_array(6);
+    packer.pack(topic);
+    packer.pack(payload);
+    packer.pack(static_cast<uint8_t>(delivery));
+    packer.pack(sequence);
+    packer.pack(stream);
+    packer.pack(base);
+  }
+
+  auto packet = std::make_shared<std::vector<char>>(buffer.size());
+  std::memcpy(packet->data(), buffer.data(), buffer.size());
+  return packet;
+}
+
+const rtypeEngine::snapshot::Snapshot *
+findSnapshot(const std::deque<rtypeEngine::snapshot::Snapshot> &history,
+             uint32_t sequence) {
+  for (auto it = history.rbegin(); it != history.rend(); ++it) {
+    if (it->sequence == sequence) {
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
 } // namespace
 
 namespace rtypeEngine {
 
-NetworkManager::NetworkManager(const char *pubEndpoint, const char *subEndpoint)
+NetworkManager::NetworkManager(const char *pubEndpoint, const char *subEndpoint,
+                               bool pollMessages)
     : AModule(pubEndpoint, subEndpoint), _workGuard(nullptr), _socket(nullptr),
+      _pollMessages(pollMessages),
+      _messageRing(pollMessages ? envQueueCapacity(DEFAULT_QUEUE_CAPACITY) : 2),
+      _busRing(envQueueCapacity(DEFAULT_QUEUE_CAPACITY)),
       _ioThreadRunning(false), _isServer(false) {
   auto now = std::chrono::steady_clock::now();
   _lastHeartbeatTime = now;
   _lastTimeoutCheckTime = now;
   _lastOverflowLog = now;
+  _lastStatsTime = now;
+  _mtu = std::clamp<std::size_t>(envSize("RTYPE_NET_MTU", DEFAULT_MTU), 256,
+                                 60000);
+  _flushDelay = std::chrono::microseconds(
+      envSize("RTYPE_NET_FLUSH_US", DEFAULT_FLUSH_DELAY.count()));
+  const char *backend = std::getenv("RTYPE_NET_BACKEND");
+  _batchedIo = backend != nullptr && toLower(backend) == "mmsg";
+#ifndef __linux__
+  if (_batchedIo) {
+    std::cerr << "[NetworkManager] RTYPE_NET_BACKEND=mmsg needs Linux, using asio"
+              << std::endl;
+    _batchedIo = false;
+  }
+#endif
+  // Received packets are queued by the io thread and do not wake the module
+  // thread, so drain them at a steady rate.
+  setTickRate(NETWORK_TICK_RATE);
 }
 
 NetworkManager::~NetworkManager() { cleanup(); }
@@ -75,14 +172,16 @@ void NetworkManager::init() {
 }
 
 void NetworkManager::loop() {
-  std::deque<std::pair<std::string, std::string>> toPublish;
-  {
-    std::lock_guard<std::mutex> lock(_busMutex);
-    toPublish.swap(_busMessages);
+  publishBusMessages();
+
+  // Everything sent while handling this tick's messages leaves together.
+  if (_flushDelay.count() > 0) {
+    asio::post(_ioContext, [this]() { flushOutbound(); });
   }
 
-  for (const auto &entry : toPublish) {
-    sendMessage(entry.first, entry.second);
+  auto now = std::chrono::steady_clock::now();
+  if (now - _lastStatsTime >= std::chrono::seconds(1)) {
+    publishOutboundStats(now);
   }
 
   // Heartbeat and timeout checks (only for server)
@@ -101,8 +200,6 @@ void NetworkManager::loop() {
       _lastTimeoutCheckTime = now;
     }
   }
-
-  std::this_thread::sleep_for(std::chrono::milliseconds(10));
 }
 
 void NetworkManager::cleanup() {
@@ -112,16 +209,17 @@ void NetworkManager::cleanup() {
   {
     std::lock_guard<std::mutex> lock(_queueMutex);
     _messageQueue.clear();
+    while (_messageRing.tryPop([](NetworkEnvelope &) {})) {
+    }
   }
-  {
-    std::lock_guard<std::mutex> lock(_busMutex);
-    _busMessages.clear();
+  while (_busRing.tryPop([](BusMessage &) {})) {
   }
   {
-    std::lock_guard<std::mutex> lock(_clientsMutex);
-    _clients.clear();
-    _endpointToClientId.clear();
+    std::lock_guard<std::mutex> lock(_busSpillMutex);
+    _busSpill.clear();
+    _busSpilled.store(false, std::memory_order_relaxed);
   }
+  clearClients();
 }
 
 void NetworkManager::startIoContext() {
@@ -198,6 +296,26 @@ void NetworkManager::registerSubscriptions() {
   subscribe("RequestNetworkSendToBinary", [this](const std::string &payload) {
     handleSendToBinaryRequest(payload);
   });
+
+  subscribe("NetworkSnapshot", [this](const std::string &payload) {
+    handleSnapshotPublish(payload);
+  });
+
+  subscribe("RequestNetworkFlush", [this](const std::string &) {
+    asio::post(_ioContext, [this]() { flushOutbound(); });
+  });
+
+  subscribe("RequestSnapshotResync", [this](const std::string &) {
+    asio::post(_ioContext, [this]() { requestFullSnapshot(); });
+  });
+
+  subscribe("RequestNetworkChannel", [this](const std::string &payload) {
+    handleChannelRequest(payload);
+  });
+
+  subscribe("RequestNetworkQueuePolicy", [this](const std::string &payload) {
+    handleQueuePolicyRequest(payload);
+  });
 }
 
 void NetworkManager::handleCommandString(const std::string &commandLine) {
@@ -407,12 +525,63 @@ void NetworkManager::handleSendToBinaryRequest(const std::string &payload) {
   sendToClientBinary(clientId, topic, binPayload);
 }
 
+void NetworkManager::handleChannelRequest(const std::string &payload) {
+  // Format: "topic unreliable|sequenced|reliable"
+  std::istringstream iss(payload);
+  std::string topic, name;
+  iss >> topic >> name;
+
+  channel::Delivery delivery;
+  if (topic.empty() || !channel::parseDelivery(toLower(name), delivery)) {
+    publishError("ChannelInvalidRequest:" + payload);
+    return;
+  }
+  setTopicChannel(topic, delivery);
+}
+
+void NetworkManager::handleQueuePolicyRequest(const std::string &payload) {
+  // Format: "topic keep|shed"
+  std::istringstream iss(payload);
+  std::string topic, name;
+  iss >> topic >> name;
+
+  DropPolicy policy;
+  if (topic.empty() || !parseDropPolicy(toLower(name), policy)) {
+    publishError("QueuePolicyInvalidRequest:" + payload);
+    return;
+  }
+  // The policy table belongs to the io thread, which reads it per packet.
+  asio::post(_ioContext, [this, topic, policy]() {
+    if (policy == DropPolicy::Keep) {
+      _queuePolicies.erase(topic);
+    } else {
+      _queuePolicies[topic] = policy;
+    }
+  });
+}
+
+void NetworkManager::setTopicChannel(const std::string &topic,
+                                     channel::Delivery delivery) {
+  std::lock_guard<std::mutex> lock(_topicChannelsMutex);
+  if (delivery == channel::Delivery::Unreliable) {
+    _topicChannels.erase(topic);
+  } else {
+    _topicChannels[topic] = delivery;
+  }
+}
+
 void NetworkManager::bind(uint16_t port) {
   asio::post(_ioContext, [this, port]() {
     disconnectInternal();
     try {
       _socket = std::make_shared<udp::socket>(_ioContext,
                                               udp::endpoint(udp::v4(), port));
+#ifdef __linux__
+      if (_batchedIo) {
+        _socket->non_blocking(true);
+        _mmsg = std::make_unique<MmsgBatcher>();
+      }
+#endif
       _isServer = true;
       publishStatus("Bound:" + std::to_string(port));
       startReceive();
@@ -468,11 +637,21 @@ void NetworkManager::disconnectInternal() {
     _socket->close(ec);
   }
   _socket.reset();
+#ifdef __linux__
+  _mmsg.reset();
+  _batchFlushQueued = false;
+#endif
   _isServer = false;
-
-  std::lock_guard<std::mutex> lock(_clientsMutex);
-  _clients.clear();
-  _endpointToClientId.clear();
+  _flushTimer.cancel();
+  _outbound.clear();
+  _channelTimer.cancel();
+  _peers.clear();
+  _receivedSnapshots.clear();
+  _snapshotAssembly = SnapshotAssembly{};
+  _forwardedEntities.clear();
+  _remoteEntityIds.clear();
+  _forwardFullSnapshot = false;
+  clearClients();
 }
 
 void NetworkManager::startReceive() {
@@ -480,6 +659,16 @@ void NetworkManager::startReceive() {
     return;
   }
 
+#ifdef __linux__
+  if (_mmsg) {
+    _socket->async_wait(udp::socket::wait_read,
+                        [this](const std::error_code &ec) {
+                          handleBatchReceive(ec);
+                        });
+    return;
+  }
+#endif
+
   _socket->async_receive_from(
       asio::buffer(_recvBuffer), _remoteEndpoint,
       [this](const std::error_code &ec, std::size_t bytes_transferred) {
@@ -496,105 +685,476 @@ void NetworkManager::handleReceive(const std::error_code &ec,
     return;
   }
 
+  _recvCalls.fetch_add(1, std::memory_order_relaxed);
   if (bytes_transferred > 0) {
-    std::vector<char> data(_recvBuffer.begin(),
-                           _recvBuffer.begin() + bytes_transferred);
     udp::endpoint senderEndpoint = _remoteEndpoint;
-    processIncomingBuffer(data, senderEndpoint);
+    processIncomingBuffer(_recvBuffer.data(), bytes_transferred,
+                          senderEndpoint);
+  }
+
+  startReceive();
+}
+
+#ifdef __linux__
+void NetworkManager::handleBatchReceive(const std::error_code &ec) {
+  if (ec) {
+    if (ec != asio::error::operation_aborted) {
+      publishError(std::string("ReceiveFailed:") + ec.message());
+    }
+    return;
+  }
+  if (!_socket || !_mmsg) {
+    return;
+  }
+
+  // A full batch means more is probably waiting: read again, within bounds
+  // so a flood cannot starve the timers.
+  udp::endpoint senderEndpoint;
+  for (int round = 0; round < MAX_RECEIVE_BATCHES; ++round) {
+    int received = _mmsg->receive(
+        _socket->native_handle(),
+        [&](const char *data, std::size_t size, const sockaddr *addr,
+            socklen_t addrLen) {
+          if (addrLen > senderEndpoint.capacity()) {
+            return;
+          }
+          std::memcpy(senderEndpoint.data(), addr, addrLen);
+          senderEndpoint.resize(addrLen);
+          processIncomingBuffer(data, size, senderEndpoint);
+        });
+    _recvCalls.fetch_add(1, std::memory_order_relaxed);
+    if (received < 0) {
+      publishError(std::string("ReceiveFailed:") + std::strerror(errno));
+      break;
+    }
+    if (static_cast<std::size_t>(received) < _mmsg->batch()) {
+      break;
+    }
   }
 
   startReceive();
 }
 
+void NetworkManager::flushBatchedSends() {
+  _batchFlushQueued = false;
+  if (!_socket || !_socket->is_open() || !_mmsg) {
+    return;
+  }
+
+  MmsgBatcher::FlushResult result = _mmsg->flush(_socket->native_handle());
+  _sendCalls.fetch_add(result.calls, std::memory_order_relaxed);
+  if (result.failed > 0) {
+    publishError(std::string("SendFailed:") + std::strerror(result.error));
+  }
+  if (result.wouldBlock) {
+    // Send buffer full: finish once the socket is writable again.
+    _batchFlushQueued = true;
+    _socket->async_wait(udp::socket::wait_write,
+                        [this](const std::error_code &ec) {
+                          if (ec) {
+                            _batchFlushQueued = false;
+                            return;
+                          }
+                          flushBatchedSends();
+                        });
+  }
+}
+#endif
+
 void NetworkManager::processIncomingBuffer(
-    const std::vector<char> &buffer, const udp::endpoint &senderEndpoint) {
+    const char *data, std::size_t size, const udp::endpoint &senderEndpoint) {
   try {
-    msgpack::object_handle handle =
-        msgpack::unpack(buffer.data(), buffer.size());
-    const msgpack::object &obj = handle.get();
-    SerializableEnvelope wireEnvelope;
-    obj.convert(wireEnvelope);
-
-    // Track client if we're server
+    // A datagram carries one or more envelopes back to back.
     uint32_t clientId = 0;
-    if (_isServer) {
-      clientId = getOrCreateClientId(senderEndpoint);
-      updateClientActivity(clientId);
+    bool tracked = false;
+    std::size_t offset = 0;
+    while (offset < size) {
+      msgpack::object_handle handle = msgpack::unpack(data, size, offset);
+      const msgpack::object &obj = handle.get();
+      SerializableEnvelope wireEnvelope;
+      obj.convert(wireEnvelope);
+
+      // Track client if we're server
+      if (_isServer && !tracked) {
+        clientId = getOrCreateClientId(senderEndpoint);
+        updateClientActivity(clientId);
+        tracked = true;
+      }
+
+      if (wireEnvelope.topic == "_ack") {
+        handleChannelAck(senderEndpoint, wireEnvelope.payload);
+        continue;
+      }
+
+      auto delivery = static_cast<channel::Delivery>(wireEnvelope.channel);
+      if (delivery == channel::Delivery::Sequenced) {
+        if (!peerChannels(senderEndpoint)
+                 .receiver.acceptSequenced(wireEnvelope.stream,
+                                           wireEnvelope.topic,
+                                           wireEnvelope.payload,
+                                           wireEnvelope.sequence)) {
+          _staleDropped.fetch_add(1, std::memory_order_relaxed);
+          continue;
+        }
+      } else if (delivery == channel::Delivery::Reliable) {
+        // Delivered in send order; anything ahead of a gap waits for it.
+        peerChannels(senderEndpoint)
+            .receiver.receiveReliable(
+                wireEnvelope.stream, wireEnvelope.base, wireEnvelope.sequence,
+                std::move(wireEnvelope.topic), std::move(wireEnvelope.payload),
+                [&](const std::string &topic, const std::string &payload) {
+                  processEnvelope({topic, payload, clientId}, senderEndpoint,
+                                  clientId);
+                });
+        armChannelTimer();
+        continue;
+      }
+
+      processEnvelope(wireEnvelope.toEnvelope(clientId), senderEndpoint,
+                      clientId);
     }
+  } catch (const std::exception &e) {
+    publishError(std::string("InvalidPacket:") + e.what());
+  }
+}
 
-    NetworkEnvelope envelope = wireEnvelope.toEnvelope(clientId);
+void NetworkManager::processEnvelope(const NetworkEnvelope &envelope,
+                                     const udp::endpoint &senderEndpoint,
+                                     uint32_t clientId) {
+  if (envelope.topic == "_heartbeat_response") {
+    return;
+  }
 
-    if (envelope.topic == "_heartbeat_response") {
-      return;
+  if (envelope.topic == "_heartbeat") {
+    sendToEndpoint(senderEndpoint, "_heartbeat_response", "pong");
+    return;
+  }
+
+  if (envelope.topic == "_snapshot_ack") {
+    if (clientId > 0) {
+      handleSnapshotAck(clientId, envelope.payload);
     }
+    return;
+  }
 
-    if (envelope.topic == "_heartbeat") {
-      sendToEndpoint(senderEndpoint, "_heartbeat_response", "pong");
-      return;
+  if (envelope.topic == "_snapshot") {
+    if (!_isServer) {
+      handleSnapshotPacket(envelope.payload, senderEndpoint);
     }
+    return;
+  }
 
-    enqueueMessage(envelope);
+  DropPolicy policy = queuePolicyFor(envelope.topic);
+  if (_pollMessages) {
+    enqueueMessage(envelope, policy);
+  }
+  queueBusMessage(envelope.topic, envelope.payload, _isServer ? clientId : 0,
+                  policy);
+}
 
-    if (_isServer && clientId > 0) {
-      queueBusMessage(envelope.topic,
-                      std::to_string(clientId) + " " + envelope.payload);
-    } else {
-      queueBusMessage(envelope.topic, envelope.payload);
-    }
-  } catch (const std::exception &e) {
-    publishError(std::string("InvalidPacket:") + e.what());
+DropPolicy NetworkManager::queuePolicyFor(const std::string &topic) const {
+  if (_queuePolicies.empty()) {
+    return DropPolicy::Keep;
   }
+  auto it = _queuePolicies.find(topic);
+  return it != _queuePolicies.end() ? it->second : DropPolicy::Keep;
 }
 
-uint32_t NetworkManager::getOrCreateClientId(const udp::endpoint &endpoint) {
-  std::string key = endpointToString(endpoint);
-  uint32_t clientId = 0;
-  bool isNewClient = false;
+void NetworkManager::handleSnapshotPublish(const std::string &payload) {
+  if (!_isServer) {
+    return;
+  }
 
+  snapshot::Snapshot current;
+  if (++_snapshotSequence == 0) {
+    ++_snapshotSequence; // 0 means "no baseline"
+  }
+  current.sequence = _snapshotSequence;
+
+  // Net ids live as long as the entity stays replicated and are never reused,
+  // so a client can never confuse a new entity with one of its baseline.
+  std::unordered_map<std::string, uint32_t> netIds;
+  netIds.reserve(_netIdByEntity.size());
+  bool valid = busCodec::decode(
+      payload, [&](busCodec::Op op, const std::string &id, const float *values,
+                   uint16_t count) {
+        if (op != busCodec::Op::SnapshotEntity ||
+            count < snapshot::FIELD_COUNT) {
+          return;
+        }
+        auto [slot, inserted] = netIds.emplace(id, 0);
+        if (!inserted) {
+          return;
+        }
+        auto known = _netIdByEntity.find(id);
+        slot->second = known != _netIdByEntity.end() ? known->second : _nextNetId++;
+
+        snapshot::EntityState state;
+        state.netId = slot->second;
+        for (std::size_t f = 0; f < snapshot::FIELD_COUNT; ++f) {
+          state.fields[f] = snapshot::quantize(values[f], f);
+        }
+        current.entities.push_back(state);
+      });
+  if (!valid) {
+    publishError("SnapshotInvalidPayload");
+    return;
+  }
+  current.sort();
+
+  _netIdByEntity.swap(netIds);
+  _entityByNetId.clear();
+  for (const auto &[id, netId] : _netIdByEntity) {
+    _entityByNetId.emplace(netId, &id);
+  }
+
+  _snapshotHistory.push_back(std::move(current));
+  while (_snapshotHistory.size() > snapshot::HISTORY) {
+    _snapshotHistory.pop_front();
+  }
+  const snapshot::Snapshot &latest = _snapshotHistory.back();
+
+  std::vector<std::pair<udp::endpoint, uint32_t>> targets;
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    auto it = _endpointToClientId.find(key);
-    if (it != _endpointToClientId.end()) {
-      return it->second;
+    for (const ClientSession &session : _sessions) {
+      if (session.connected.load(std::memory_order_relaxed)) {
+        targets.emplace_back(
+            session.endpoint,
+            session.ackedSnapshot.load(std::memory_order_relaxed));
+      }
     }
+  }
 
-    // New client
-    clientId = _nextClientId++;
-    _endpointToClientId[key] = clientId;
+  // Clients acked on the same baseline share one encoding, cut into chunks
+  // that each fit a datagram so a full snapshot never relies on IP
+  // fragmentation.
+  std::unordered_map<uint32_t, std::vector<std::string>> encoded;
+  auto idOf = [this](uint32_t netId) -> const std::string & {
+    return *_entityByNetId.at(netId);
+  };
+  for (const auto &[endpoint, acked] : targets) {
+    const snapshot::Snapshot *baseline =
+        acked != 0 ? findSnapshot(_snapshotHistory, acked) : nullptr;
+    uint32_t key = baseline ? baseline->sequence : 0;
+    auto it = encoded.find(key);
+    if (it == encoded.end()) {
+      it = encoded
+               .emplace(key, snapshot::encodeChunks(
+                                 latest, baseline, idOf,
+                                 _mtu - snapshot::ENVELOPE_OVERHEAD))
+               .first;
+    }
+    for (const std::string &chunk : it->second) {
+      sendToEndpoint(endpoint, "_snapshot", chunk);
+    }
+  }
+}
 
-    ClientSession session;
-    session.id = clientId;
-    session.endpoint = endpoint;
-    session.lastActivity = std::chrono::steady_clock::now();
-    session.connected = true;
-    _clients[clientId] = session;
-    isNewClient = true;
+void NetworkManager::handleSnapshotAck(uint32_t clientId,
+                                       const std::string &payload) {
+  uint32_t sequence = static_cast<uint32_t>(std::stoul(payload));
+  ClientSession *session = findSession(clientId);
+  if (session == nullptr) {
+    return;
   }
+  // Acks may arrive out of order; 0 asks for a full snapshot. Only the io
+  // thread writes it.
+  uint32_t acked = session->ackedSnapshot.load(std::memory_order_relaxed);
+  session->ackedSnapshot.store(sequence == 0 ? 0 : std::max(acked, sequence),
+                               std::memory_order_relaxed);
+}
+
+void NetworkManager::requestFullSnapshot() {
+  // The next applied snapshot is forwarded whole instead of as changes.
+  _forwardFullSnapshot = true;
+}
 
-  // Notify about new client
-  if (isNewClient) {
-    queueBusMessage("ClientConnected", std::to_string(clientId) + " " + key);
+void NetworkManager::handleSnapshotPacket(const std::string &payload,
+                                          const udp::endpoint &senderEndpoint) {
+  snapshot::ChunkHeader header;
+  if (!snapshot::readHeader(payload, header)) {
+    publishError("SnapshotInvalidPacket");
+    return;
   }
 
-  return clientId;
+  const snapshot::Snapshot *previous =
+      _receivedSnapshots.empty() ? nullptr : &_receivedSnapshots.back();
+  if ((previous && header.sequence <= previous->sequence) ||
+      header.sequence < _snapshotAssembly.sequence) {
+    // Late or duplicated datagram: re-ack so the server moves its baseline.
+    if (previous) {
+      sendToEndpoint(senderEndpoint, "_snapshot_ack",
+                     std::to_string(previous->sequence));
+    }
+    return;
+  }
+
+  SnapshotAssembly &assembly = _snapshotAssembly;
+  if (header.sequence != assembly.sequence) {
+    // A newer snapshot replaces one still missing chunks.
+    assembly.sequence = header.sequence;
+    assembly.baseline = header.baseline;
+    assembly.parts.assign(header.count, {});
+    assembly.received.assign(header.count, false);
+    assembly.missing = header.count;
+    assembly.forwardWhole = _forwardFullSnapshot;
+  }
+  if (header.count != assembly.parts.size() ||
+      header.baseline != assembly.baseline) {
+    publishError("SnapshotInvalidPacket");
+    return;
+  }
+  if (assembly.received[header.index]) {
+    return;
+  }
+
+  const snapshot::Snapshot *baseline = nullptr;
+  if (header.baseline != 0) {
+    baseline = findSnapshot(_receivedSnapshots, header.baseline);
+    if (!baseline) {
+      sendToEndpoint(senderEndpoint, "_snapshot_ack", "0");
+      return;
+    }
+  }
+
+  std::vector<snapshot::EntityState> entities;
+  snapshot::AppliedDelta applied;
+  if (!snapshot::decodeChunk(payload, baseline, header, entities, applied)) {
+    publishError("SnapshotDecodeFailed");
+    sendToEndpoint(senderEndpoint, "_snapshot_ack", "0");
+    return;
+  }
+  for (auto &[netId, id] : applied.newIds) {
+    _remoteEntityIds[netId] = std::move(id);
+  }
+
+  // Forward what changed in this chunk's range since the game last heard of
+  // it, which is not necessarily the baseline the server encoded against.
+  auto &known = _forwardedEntities;
+  auto byNetId = [](const snapshot::EntityState &e, uint32_t id) {
+    return e.netId < id;
+  };
+  auto first = std::lower_bound(known.begin(), known.end(), header.first,
+                                byNetId);
+  auto last = std::upper_bound(
+      first, known.end(), header.last,
+      [](uint32_t id, const snapshot::EntityState &e) { return id < e.netId; });
+
+  busCodec::BatchWriter batch;
+  float values[snapshot::FIELD_COUNT];
+  auto before = first;
+  std::size_t i = 0;
+  while (i < entities.size() || before != last) {
+    if (i == entities.size() ||
+        (before != last && before->netId < entities[i].netId)) {
+      auto gone = _remoteEntityIds.find((before++)->netId);
+      if (gone != _remoteEntityIds.end()) {
+        batch.add(busCodec::Op::SnapshotRemoved, gone->second, nullptr, 0);
+        _remoteEntityIds.erase(gone);
+      }
+      continue;
+    }
+
+    const snapshot::EntityState &state = entities[i++];
+    if (before != last && before->netId == state.netId) {
+      const snapshot::EntityState &old = *before++;
+      if (!assembly.forwardWhole &&
+          std::equal(std::begin(state.fields), std::end(state.fields),
+                     std::begin(old.fields))) {
+        continue;
+      }
+    }
+    auto id = _remoteEntityIds.find(state.netId);
+    if (id == _remoteEntityIds.end()) {
+      continue;
+    }
+    for (std::size_t f = 0; f < snapshot::FIELD_COUNT; ++f) {
+      values[f] = snapshot::dequantize(state.fields[f], f);
+    }
+    batch.add(busCodec::Op::SnapshotEntity, id->second, values,
+              snapshot::FIELD_COUNT);
+  }
+  if (!batch.empty()) {
+    queueBusMessage("SnapshotReceived", batch.take());
+  }
+  first = known.erase(first, last);
+  known.insert(first, entities.begin(), entities.end());
+
+  assembly.parts[header.index] = std::move(entities);
+  assembly.received[header.index] = true;
+  if (--assembly.missing > 0) {
+    return;
+  }
+
+  // Every chunk is in: the snapshot can serve as a baseline, so ack it.
+  snapshot::Snapshot current;
+  current.sequence = assembly.sequence;
+  for (std::vector<snapshot::EntityState> &part : assembly.parts) {
+    current.entities.insert(current.entities.end(), part.begin(), part.end());
+  }
+  assembly.parts.clear();
+  if (assembly.forwardWhole) {
+    _forwardFullSnapshot = false;
+  }
+
+  _receivedSnapshots.push_back(std::move(current));
+  while (_receivedSnapshots.size() > snapshot::HISTORY) {
+    _receivedSnapshots.pop_front();
+  }
+  sendToEndpoint(senderEndpoint, "_snapshot_ack",
+                 std::to_string(assembly.sequence));
 }
 
-void NetworkManager::updateClientActivity(uint32_t clientId) {
-  bool wasReconnected = false;
+uint32_t NetworkManager::getOrCreateClientId(const udp::endpoint &endpoint) {
+  // io thread: the table is its own, no lock needed to read it.
+  EndpointKey key = endpointKey(endpoint);
+  uint32_t clientId = _endpointIds.find(key);
+  if (clientId != 0) {
+    return clientId;
+  }
+
+  // New client
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    auto it = _clients.find(clientId);
-    if (it != _clients.end()) {
-      it->second.lastActivity = std::chrono::steady_clock::now();
-      if (!it->second.connected) {
-        it->second.connected = true;
-        wasReconnected = true;
-      }
-    }
+    clientId = _nextClientId++;
+    _sessions.emplace_back(clientId, endpoint,
+                           std::chrono::steady_clock::now());
+  }
+  _endpointIds.insert(key, clientId);
+
+  queueLifecycleMessage("ClientConnected", std::to_string(clientId) + " " +
+                                               endpointToString(endpoint));
+  return clientId;
+}
+
+NetworkManager::ClientSession *
+NetworkManager::findSession(uint32_t clientId) {
+  // io thread, or any thread holding _clientsMutex.
+  if (clientId < _firstClientId ||
+      clientId - _firstClientId >= _sessions.size()) {
+    return nullptr;
   }
+  return &_sessions[clientId - _firstClientId];
+}
 
-  if (wasReconnected) {
-    queueBusMessage("ClientReconnected", std::to_string(clientId));
+void NetworkManager::clearClients() {
+  std::lock_guard<std::mutex> lock(_clientsMutex);
+  _sessions.clear();
+  _endpointIds.clear();
+  // Ids keep counting up across rebinds.
+  _firstClientId = _nextClientId;
+}
+
+void NetworkManager::updateClientActivity(uint32_t clientId) {
+  ClientSession *session = findSession(clientId);
+  if (session == nullptr) {
+    return;
+  }
+  session->lastActivity.store(std::chrono::steady_clock::now(),
+                              std::memory_order_relaxed);
+  if (!session->connected.exchange(true, std::memory_order_relaxed)) {
+    queueLifecycleMessage("ClientReconnected", std::to_string(clientId));
   }
 }
 
@@ -602,11 +1162,17 @@ void NetworkManager::checkClientTimeouts() {
   std::lock_guard<std::mutex> lock(_clientsMutex);
   auto now = std::chrono::steady_clock::now();
 
-  for (auto &[clientId, session] : _clients) {
-    if (session.connected && (now - session.lastActivity) >= CLIENT_TIMEOUT) {
-      session.connected = false;
-      queueBusMessage("ClientDisconnected",
-                      std::to_string(clientId) + " timeout");
+  for (ClientSession &session : _sessions) {
+    bool connected = true;
+    if (now - session.lastActivity.load(std::memory_order_relaxed) >=
+            CLIENT_TIMEOUT &&
+        session.connected.compare_exchange_strong(connected, false,
+                                                  std::memory_order_relaxed)) {
+      queueLifecycleMessage("ClientDisconnected",
+                            std::to_string(session.id) + " timeout");
+      // Stop resending to it; a client that comes back starts a new stream.
+      udp::endpoint endpoint = session.endpoint;
+      asio::post(_ioContext, [this, endpoint]() { _peers.erase(endpoint); });
     }
   }
 }
@@ -615,8 +1181,8 @@ void NetworkManager::sendHeartbeats() {
   std::vector<udp::endpoint> endpoints;
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    for (const auto &[clientId, session] : _clients) {
-      if (session.connected) {
+    for (const ClientSession &session : _sessions) {
+      if (session.connected.load(std::memory_order_relaxed)) {
         endpoints.push_back(session.endpoint);
       }
     }
@@ -630,93 +1196,393 @@ void NetworkManager::sendHeartbeats() {
 void NetworkManager::sendToEndpoint(const udp::endpoint &endpoint,
                                     const std::string &topic,
                                     const std::string &payload) {
-  NetworkEnvelope envelope{topic, payload, 0};
-  msgpack::sbuffer buffer;
-  SerializableEnvelope wireEnvelope(envelope);
-  msgpack::pack(buffer, wireEnvelope);
+  postEnvelope(endpoint, topic, payload);
+}
 
-  auto packet = std::make_shared<std::vector<char>>(buffer.size());
-  std::memcpy(packet->data(), buffer.data(), buffer.size());
+void NetworkManager::sendToEndpointBinary(const udp::endpoint &endpoint,
+                                          const std::string &topic,
+                                          const std::vector<char> &payload) {
+  // The envelope stores the payload as a string, which is safe for binary data.
+  postEnvelope(endpoint, topic, std::string(payload.begin(), payload.end()));
+}
 
-  asio::post(_ioContext, [this, packet, endpoint]() {
-    if (!_socket || !_socket->is_open()) {
+void NetworkManager::postEnvelope(const udp::endpoint &endpoint,
+                                  const std::string &topic,
+                                  const std::string &payload) {
+  channel::Delivery delivery = channelFor(topic);
+  if (delivery != channel::Delivery::Unreliable) {
+    // Sequence numbers belong to the io thread.
+    asio::post(_ioContext, [this, endpoint, topic, payload, delivery]() {
+      sendOnChannel(endpoint, topic, payload, delivery);
+    });
+    return;
+  }
+
+  Datagram packet = packEnvelope(topic, payload);
+  asio::post(_ioContext,
+             [this, packet, endpoint]() { queueOutbound(endpoint, packet); });
+}
+
+channel::Delivery NetworkManager::channelFor(const std::string &topic) {
+  if (!topic.empty() && topic[0] == '_') {
+    return channel::Delivery::Unreliable; // internal traffic has its own recovery
+  }
+  std::lock_guard<std::mutex> lock(_topicChannelsMutex);
+  auto it = _topicChannels.find(topic);
+  return it != _topicChannels.end() ? it->second
+                                    : channel::Delivery::Unreliable;
+}
+
+NetworkManager::PeerChannels &
+NetworkManager::peerChannels(const udp::endpoint &endpoint) {
+  auto it = _peers.find(endpoint);
+  if (it == _peers.end()) {
+    uint32_t stream = 0;
+    while (stream == 0) {
+      stream = _streamIds();
+    }
+    it = _peers.emplace(endpoint, PeerChannels{channel::Sender(stream), {}})
+             .first;
+  }
+  return it->second;
+}
+
+void NetworkManager::sendOnChannel(const udp::endpoint &endpoint,
+                                   const std::string &topic,
+                                   const std::string &payload,
+                                   channel::Delivery delivery) {
+  if (!_socket || !_socket->is_open()) {
+    return;
+  }
+
+  channel::Sender &sender = peerChannels(endpoint).sender;
+  uint32_t sequence = 0;
+  if (delivery == channel::Delivery::Reliable) {
+    sequence = sender.pushReliable(topic, payload,
+                                   std::chrono::steady_clock::now());
+    if (sequence == 0) {
+      // The peer stopped acknowledging; holding more would grow without bound.
+      publishError("ReliableWindowFull:" + endpointToString(endpoint) + ":" +
+                   topic);
       return;
     }
+    armChannelTimer();
+  } else {
+    sequence = sender.nextSequenced();
+  }
+  queueOutbound(endpoint, packEnvelope(topic, payload, delivery, sequence,
+                                       sender.stream(), sender.base()));
+}
 
-    _socket->async_send_to(
-        asio::buffer(*packet), endpoint,
-        [this, packet](const std::error_code &ec, std::size_t) {
-          if (ec && ec != asio::error::operation_aborted) {
-            publishError(std::string("SendFailed:") + ec.message());
-          }
-        });
+void NetworkManager::handleChannelAck(const udp::endpoint &endpoint,
+                                      const std::string &payload) {
+  channel::Ack ack;
+  auto it = _peers.find(endpoint);
+  if (it == _peers.end() || !channel::decodeAck(payload, ack)) {
+    return;
+  }
+  it->second.sender.onAck(ack, std::chrono::steady_clock::now());
+}
+
+void NetworkManager::armChannelTimer() {
+  if (_channelTimerArmed) {
+    return;
+  }
+  _channelTimerArmed = true;
+  _channelTimer.expires_after(CHANNEL_TICK);
+  _channelTimer.async_wait([this](const std::error_code &ec) {
+    _channelTimerArmed = false;
+    if (!ec) {
+      serviceChannels();
+    }
   });
 }
 
-void NetworkManager::sendToEndpointBinary(const udp::endpoint &endpoint,
-                                          const std::string &topic,
-                                          const std::vector<char> &payload) {
-  // Convert vector<char> to string for the envelope (which uses string storage)
-  // This is safe for binary data.
-  std::string payloadStr(payload.begin(), payload.end());
-  NetworkEnvelope envelope{topic, payloadStr, 0};
-  
-  msgpack::sbuffer buffer;
-  SerializableEnvelope wireEnvelope(envelope);
-  msgpack::pack(buffer, wireEnvelope);
+void NetworkManager::serviceChannels() {
+  if (!_socket || !_socket->is_open()) {
+    return;
+  }
 
-  auto packet = std::make_shared<std::vector<char>>(buffer.size());
-  std::memcpy(packet->data(), buffer.data(), buffer.size());
+  auto now = std::chrono::steady_clock::now();
+  bool waiting = false;
+  for (auto &[endpoint, peer] : _peers) {
+    channel::Sender &sender = peer.sender;
+    sender.resendDue(now, [&](uint32_t sequence,
+                              const channel::Sender::Pending &pending) {
+      _reliableResends.fetch_add(1, std::memory_order_relaxed);
+      queueOutbound(endpoint,
+                    packEnvelope(pending.topic, pending.payload,
+                                 channel::Delivery::Reliable, sequence,
+                                 sender.stream(), sender.base()));
+    });
+
+    // Acks not piggybacked on traffic since the last tick go on their own.
+    if (peer.receiver.ackPending()) {
+      queueOutbound(endpoint,
+                    packEnvelope("_ack", channel::encodeAck(
+                                             peer.receiver.takeAck())));
+    }
+    waiting = waiting || sender.hasPending();
+  }
 
-  asio::post(_ioContext, [this, packet, endpoint]() {
-    if (!_socket || !_socket->is_open()) {
-      return;
+  if (waiting) {
+    armChannelTimer();
+  }
+}
+
+void NetworkManager::queueOutbound(const udp::endpoint &endpoint,
+                                   const Datagram &packet) {
+  if (!_socket || !_socket->is_open()) {
+    return;
+  }
+
+  if (_flushDelay.count() == 0) {
+    sendDatagram(endpoint, packet, 1);
+    return;
+  }
+
+  const std::size_t limit = _mtu - ACK_RESERVE;
+  OutboundBatch &batch = _outbound[endpoint];
+  if (batch.data.size() + packet->size() > limit) {
+    flushBatch(endpoint, batch);
+  }
+  if (packet->size() >= limit) {
+    // Too big to share a datagram; pending messages went out first.
+    sendDatagram(endpoint, packet, 1);
+    return;
+  }
+
+  batch.data.insert(batch.data.end(), packet->begin(), packet->end());
+  ++batch.messages;
+
+  if (!_flushTimerArmed) {
+    _flushTimerArmed = true;
+    _flushTimer.expires_after(_flushDelay);
+    _flushTimer.async_wait([this](const std::error_code &ec) {
+      _flushTimerArmed = false;
+      if (!ec) {
+        flushOutbound();
+      }
+    });
+  }
+}
+
+void NetworkManager::flushOutbound() {
+  // Flushed batches are dropped, so endpoints that stopped receiving (e.g.
+  // clients that reconnected from another port) do not stay in the map.
+  for (auto it = _outbound.begin(); it != _outbound.end();) {
+    flushBatch(it->first, it->second);
+    it = _outbound.erase(it);
+  }
+}
+
+void NetworkManager::flushBatch(const udp::endpoint &endpoint,
+                                OutboundBatch &batch) {
+  if (batch.messages == 0) {
+    return;
+  }
+
+  // Piggyback the pending ack for this peer's reliable messages.
+  auto peer = _peers.find(endpoint);
+  if (peer != _peers.end() && peer->second.receiver.ackPending()) {
+    Datagram ack = packEnvelope(
+        "_ack", channel::encodeAck(peer->second.receiver.takeAck()));
+    batch.data.insert(batch.data.end(), ack->begin(), ack->end());
+    ++batch.messages;
+  }
+
+  auto datagram = std::make_shared<std::vector<char>>(std::move(batch.data));
+  batch.data.clear();
+  batch.data.reserve(_mtu);
+  sendDatagram(endpoint, datagram, batch.messages);
+  batch.messages = 0;
+}
+
+void NetworkManager::sendDatagram(const udp::endpoint &endpoint,
+                                  const Datagram &datagram,
+                                  uint32_t messages) {
+  if (!_socket || !_socket->is_open()) {
+    return;
+  }
+
+  _datagramsSent.fetch_add(1, std::memory_order_relaxed);
+  _messagesSent.fetch_add(messages, std::memory_order_relaxed);
+  _bytesSent.fetch_add(datagram->size(), std::memory_order_relaxed);
+
+#ifdef __linux__
+  if (_mmsg) {
+    // Everything queued during this io turn leaves in one sendmmsg.
+    _mmsg->queue(reinterpret_cast<const sockaddr *>(endpoint.data()),
+                 static_cast<socklen_t>(endpoint.size()), datagram);
+    if (!_batchFlushQueued) {
+      _batchFlushQueued = true;
+      asio::post(_ioContext, [this]() { flushBatchedSends(); });
     }
+    return;
+  }
+#endif
 
-    _socket->async_send_to(
-        asio::buffer(*packet), endpoint,
-        [this, packet](const std::error_code &ec, std::size_t) {
-          if (ec && ec != asio::error::operation_aborted) {
-            publishError(std::string("SendFailed:") + ec.message());
-          }
-        });
-  });
+  _sendCalls.fetch_add(1, std::memory_order_relaxed);
+  _socket->async_send_to(
+      asio::buffer(*datagram), endpoint,
+      [this, datagram](const std::error_code &ec, std::size_t) {
+        if (ec && ec != asio::error::operation_aborted) {
+          publishError(std::string("SendFailed:") + ec.message());
+        }
+      });
 }
 
-void NetworkManager::enqueueMessage(const NetworkEnvelope &envelope) {
-  std::lock_guard<std::mutex> lock(_queueMutex);
-  _enqueuedTotal.fetch_add(1, std::memory_order_relaxed);
-  _messageQueue.push_back(envelope);
+void NetworkManager::publishOutboundStats(
+    std::chrono::steady_clock::time_point now) {
+  uint64_t datagrams = _datagramsSent.load(std::memory_order_relaxed);
+  uint64_t messages = _messagesSent.load(std::memory_order_relaxed);
+  uint64_t bytes = _bytesSent.load(std::memory_order_relaxed);
+  uint64_t resends = _reliableResends.load(std::memory_order_relaxed);
+  uint64_t stale = _staleDropped.load(std::memory_order_relaxed);
+  uint64_t busDropped = _busDropped.load(std::memory_order_relaxed);
+  uint64_t overflowTotal = _overflowTotal.load(std::memory_order_relaxed);
+  uint64_t sendCalls = _sendCalls.load(std::memory_order_relaxed);
+  uint64_t recvCalls = _recvCalls.load(std::memory_order_relaxed);
+  double seconds = std::chrono::duration<double>(now - _lastStatsTime).count();
+  _lastStatsTime = now;
+
+  uint64_t sentDatagrams = datagrams - _statsDatagrams;
+  uint64_t sentMessages = messages - _statsMessages;
+  uint64_t sentBytes = bytes - _statsBytes;
+  _statsDatagrams = datagrams;
+  _statsMessages = messages;
+  _statsBytes = bytes;
+  uint64_t resent = resends - _statsResends;
+  uint64_t dropped = stale - _statsStale;
+  _statsResends = resends;
+  _statsStale = stale;
+  uint64_t shed = busDropped - _statsBusDropped;
+  _statsBusDropped = busDropped;
+  uint64_t overflow = overflowTotal - _statsOverflow;
+  _statsOverflow = overflowTotal;
+  uint64_t sends = sendCalls - _statsSendCalls;
+  uint64_t receives = recvCalls - _statsRecvCalls;
+  _statsSendCalls = sendCalls;
+  _statsRecvCalls = recvCalls;
+
+  // Published while idle too, so drops are seen even when nothing is sent.
+  // fill: average share of the MTU used by each datagram; resends: reliable
+  // messages sent again; stale: sequenced messages dropped on arrival;
+  // dropped: received messages refused by the full (or shedding) bus ring;
+  // overflow: the same for the getAllMessages() queue;
+  // sendcalls/recvcalls: socket operations, fewer than datagrams when batched.
+  std::ostringstream oss;
+  oss << std::fixed << std::setprecision(1)
+      << "datagrams=" << sentDatagrams / seconds
+      << " messages=" << sentMessages / seconds
+      << " bytes=" << sentBytes / seconds << std::setprecision(2)
+      << " fill="
+      << (sentDatagrams == 0 ? 0.0
+                             : static_cast<double>(sentBytes) /
+                                   static_cast<double>(sentDatagrams * _mtu))
+      << std::setprecision(1) << " resends=" << resent / seconds
+      << " stale=" << dropped / seconds << " dropped=" << shed / seconds
+      << " overflow=" << overflow / seconds
+      << " sendcalls=" << sends / seconds << " recvcalls=" << receives / seconds;
+  queueBusMessage("NetworkStats", oss.str());
+}
 
-  const auto qSize = _messageQueue.size();
+void NetworkManager::enqueueMessage(const NetworkEnvelope &envelope,
+                                    DropPolicy policy) {
+  _enqueuedTotal.fetch_add(1, std::memory_order_relaxed);
+  bool queued = _messageRing.tryPush(
+      [&](NetworkEnvelope &slot) {
+        slot.topic.assign(envelope.topic);
+        slot.payload.assign(envelope.payload);
+        slot.clientId = envelope.clientId;
+      },
+      policy);
+
+  const auto qSize = _messageRing.size();
   if (qSize > _maxQueueSizeObserved) {
     _maxQueueSizeObserved = qSize;
   }
+  if (queued) {
+    return;
+  }
 
-  constexpr size_t QUEUE_LIMIT = 4096;
-
-  if (_messageQueue.size() > QUEUE_LIMIT) {
-    _messageQueue.pop_front();
-    const auto overflowCount = _overflowTotal.fetch_add(1, std::memory_order_relaxed) + 1;
-    auto now = std::chrono::steady_clock::now();
-    if (now - _lastOverflowLog >= std::chrono::seconds(1)) {
-      _lastOverflowLog = now;
-      std::ostringstream oss;
-      oss << "MessageQueueOverflow: dropped oldest. limit=" << QUEUE_LIMIT
-          << " queueSize=" << _messageQueue.size()
-          << " maxObserved=" << _maxQueueSizeObserved
-          << " enqueuedTotal=" << _enqueuedTotal.load(std::memory_order_relaxed)
-          << " overflowTotal=" << overflowCount
-          << " lastTopic=" << envelope.topic;
-      publishError(oss.str());
-    }
+  // Only the io thread gets here, so the log throttle needs no lock.
+  const auto overflowCount =
+      _overflowTotal.fetch_add(1, std::memory_order_relaxed) + 1;
+  auto now = std::chrono::steady_clock::now();
+  if (now - _lastOverflowLog >= std::chrono::seconds(1)) {
+    _lastOverflowLog = now;
+    std::ostringstream oss;
+    oss << "MessageQueueOverflow: dropped newest. limit="
+        << _messageRing.capacity() << " queueSize=" << qSize
+        << " maxObserved=" << _maxQueueSizeObserved
+        << " enqueuedTotal=" << _enqueuedTotal.load(std::memory_order_relaxed)
+        << " overflowTotal=" << overflowCount
+        << " lastTopic=" << envelope.topic;
+    publishError(oss.str());
   }
 }
 
 void NetworkManager::queueBusMessage(const std::string &topic,
-                                     const std::string &payload) {
-  std::lock_guard<std::mutex> lock(_busMutex);
-  _busMessages.emplace_back(topic, payload);
+                                     const std::string &payload,
+                                     uint32_t clientId, DropPolicy policy) {
+  bool queued = _busRing.tryPush(
+      [&](BusMessage &slot) {
+        slot.topic.assign(topic);
+        if (clientId > 0) {
+          // Server side: handlers get "clientId payload".
+          slot.payload.assign(std::to_string(clientId));
+          slot.payload.push_back(' ');
+          slot.payload.append(payload);
+        } else {
+          slot.payload.assign(payload);
+        }
+      },
+      policy);
+  if (!queued) {
+    _busDropped.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void NetworkManager::queueLifecycleMessage(const std::string &topic,
+                                           const std::string &payload) {
+  bool queued = !_busSpilled.load(std::memory_order_acquire) &&
+                _busRing.tryPush([&](BusMessage &slot) {
+                  slot.topic.assign(topic);
+                  slot.payload.assign(payload);
+                });
+  if (queued) {
+    return;
+  }
+  // Once one has spilled, the next ones follow it to keep their order.
+  std::lock_guard<std::mutex> lock(_busSpillMutex);
+  _busSpill.push_back({topic, payload});
+  _busSpilled.store(true, std::memory_order_release);
+}
+
+void NetworkManager::publishBusMessages() {
+  // Bounded so a flood arriving meanwhile cannot hold the tick forever.
+  const std::size_t budget = _busRing.capacity();
+  for (std::size_t i = 0; i < budget; ++i) {
+    if (!_busRing.tryPop([this](BusMessage &message) {
+          sendMessage(message.topic, message.payload);
+        })) {
+      break;
+    }
+  }
+
+  if (!_busSpilled.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::vector<BusMessage> spilled;
+  {
+    std::lock_guard<std::mutex> lock(_busSpillMutex);
+    spilled.swap(_busSpill);
+    _busSpilled.store(false, std::memory_order_release);
+  }
+  for (const BusMessage &message : spilled) {
+    sendMessage(message.topic, message.payload);
+  }
 }
 
 void NetworkManager::publishStatus(const std::string &status) {
@@ -764,13 +1630,13 @@ void NetworkManager::sendToClient(uint32_t clientId, const std::string &topic,
 
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    auto it = _clients.find(clientId);
-    if (it == _clients.end()) {
+    const ClientSession *session = findSession(clientId);
+    if (session == nullptr) {
       errorMsg = "SendToClient:UnknownClient:" + std::to_string(clientId);
-    } else if (!it->second.connected) {
+    } else if (!session->connected.load(std::memory_order_relaxed)) {
       errorMsg = "SendToClient:ClientDisconnected:" + std::to_string(clientId);
     } else {
-      endpointOpt = it->second.endpoint;
+      endpointOpt = session->endpoint;
     }
   }
 
@@ -792,13 +1658,13 @@ void NetworkManager::sendToClientBinary(uint32_t clientId,
 
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    auto it = _clients.find(clientId);
-    if (it == _clients.end()) {
+    const ClientSession *session = findSession(clientId);
+    if (session == nullptr) {
       errorMsg = "SendToClient:UnknownClient:" + std::to_string(clientId);
-    } else if (!it->second.connected) {
+    } else if (!session->connected.load(std::memory_order_relaxed)) {
       errorMsg = "SendToClient:ClientDisconnected:" + std::to_string(clientId);
     } else {
-      endpointOpt = it->second.endpoint;
+      endpointOpt = session->endpoint;
     }
   }
 
@@ -817,11 +1683,11 @@ void NetworkManager::broadcast(const std::string &topic,
   std::vector<udp::endpoint> endpoints;
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    if (_clients.empty()) {
+    if (_sessions.empty()) {
       return;
     }
-    for (const auto &[clientId, session] : _clients) {
-      if (session.connected) {
+    for (const ClientSession &session : _sessions) {
+      if (session.connected.load(std::memory_order_relaxed)) {
         endpoints.push_back(session.endpoint);
       }
     }
@@ -837,11 +1703,11 @@ void NetworkManager::broadcastBinary(const std::string &topic,
   std::vector<udp::endpoint> endpoints;
   {
     std::lock_guard<std::mutex> lock(_clientsMutex);
-    if (_clients.empty()) {
+    if (_sessions.empty()) {
       return;
     }
-    for (const auto &[clientId, session] : _clients) {
-      if (session.connected) {
+    for (const ClientSession &session : _sessions) {
+      if (session.connected.load(std::memory_order_relaxed)) {
         endpoints.push_back(session.endpoint);
       }
     }
@@ -856,46 +1722,61 @@ std::vector<ClientInfo> NetworkManager::getConnectedClients() {
   std::lock_guard<std::mutex> lock(_clientsMutex);
   std::vector<ClientInfo> result;
 
-  for (const auto &[clientId, session] : _clients) {
+  for (const ClientSession &session : _sessions) {
     ClientInfo info;
     info.id = session.id;
     info.address = session.endpoint.address().to_string();
     info.port = session.endpoint.port();
-    info.lastActivity = session.lastActivity;
-    info.connected = session.connected;
+    info.lastActivity = session.lastActivity.load(std::memory_order_relaxed);
+    info.connected = session.connected.load(std::memory_order_relaxed);
     result.push_back(info);
   }
 
   return result;
 }
 
+void NetworkManager::drainMessageRing() {
+  // Caller holds _queueMutex. Past the ring capacity the oldest unread
+  // messages give way, as the old deque limit did.
+  while (_messageRing.tryPop([this](NetworkEnvelope &slot) {
+    _messageQueue.push_back(slot);
+  })) {
+    if (_messageQueue.size() > _messageRing.capacity()) {
+      _messageQueue.pop_front();
+    }
+  }
+}
+
 std::optional<NetworkEnvelope> NetworkManager::getFirstMessage() {
   std::lock_guard<std::mutex> lock(_queueMutex);
   if (_messageQueue.empty()) {
-    return std::nullopt;
+    std::optional<NetworkEnvelope> envelope;
+    _messageRing.tryPop([&](NetworkEnvelope &slot) { envelope = slot; });
+    return envelope;
   }
-  NetworkEnvelope envelope = _messageQueue.front();
+  NetworkEnvelope envelope = std::move(_messageQueue.front());
   _messageQueue.pop_front();
   return envelope;
 }
 
 std::optional<NetworkEnvelope> NetworkManager::getLastMessage() {
   std::lock_guard<std::mutex> lock(_queueMutex);
+  drainMessageRing();
   if (_messageQueue.empty()) {
     return std::nullopt;
   }
-  NetworkEnvelope envelope = _messageQueue.back();
+  NetworkEnvelope envelope = std::move(_messageQueue.back());
   _messageQueue.pop_back();
   return envelope;
 }
 
 std::vector<NetworkEnvelope> NetworkManager::getAllMessages() {
-  std::vector<NetworkEnvelope> messages;
   std::lock_guard<std::mutex> lock(_queueMutex);
-  while (!_messageQueue.empty()) {
-    messages.push_back(_messageQueue.front());
-    _messageQueue.pop_front();
-  }
+  drainMessageRing();
+  std::vector<NetworkEnvelope> messages(
+      std::make_move_iterator(_messageQueue.begin()),
+      std::make_move_iterator(_messageQueue.end()));
+  _messageQueue.clear();
   return messages;
 }
 
@@ -909,5 +1790,6 @@ std::vector<NetworkEnvelope> NetworkManager::getAllMessages() {
 
 extern "C" NETWORK_MANAGER_EXPORT rtypeEngine::IModule *createModule(const char *pubEndpoint,
                                               const char *subEndpoint) {
-  return new rtypeEngine::NetworkManager(pubEndpoint, subEndpoint);
+  // Loaded by the engine, which takes received messages from the bus.
+  return new rtypeEngine::NetworkManager(pubEndpoint, subEndpoint, false);
 }
@@ -15,6 +15,11 @@
  * | `RequestNetworkBroadcast` | "topic:payload" | Broadcast to all clients |
  * | `RequestNetworkSendBinary` | Binary data | Send binary message |
  * | `RequestNetworkBroadcastBinary` | Binary data | Broadcast binary |
+ * | `NetworkSnapshot` | busCodec batch | Replicated entity state (server) |
+ * | `RequestSnapshotResync` | - | Forward the next snapshot whole (client) |
+ * | `RequestNetworkFlush` | - | Send pending coalesced datagrams now |
+ * | `RequestNetworkChannel` | "topic unreliable\|sequenced\|reliable" | Delivery channel for an outgoing topic |
+ * | `RequestNetworkQueuePolicy` | "topic keep\|shed" | Drop policy of an incoming topic |
  * 
  * @section channels_pub Published Channels
  * | Channel | Payload | Description |
@@ -23,13 +28,31 @@
  * | `NetworkError` | Error string | Network error messages |
  * | `ClientConnected` | "clientId" | New client connected (server) |
  * | `ClientDisconnected` | "clientId" | Client disconnected (server) |
+ * | `NetworkStats` | "datagrams=N messages=N bytes=N fill=F resends=N stale=N dropped=N overflow=N sendcalls=N recvcalls=N" | Traffic, once per second |
+ * | `SnapshotReceived` | busCodec batch | Entities changed/removed by a snapshot (client) |
  * | `{topic}` | Message payload | Forwarded network messages |
  * 
  * @section protocol Wire Protocol
  * Uses MsgPack for binary serialization:
  * - Messages: `[TopicLen(4)][Topic(N)][Payload(M)]`
+ * - Datagrams: one or more msgpack envelopes back to back. Messages for the
+ *   same endpoint are coalesced up to `RTYPE_NET_MTU` bytes (default 1200)
+ *   and flushed after every tick or `RTYPE_NET_FLUSH_US` (default 2000 us);
+ *   `RTYPE_NET_FLUSH_US=0` sends every message immediately.
+ * - Channels: topics are unreliable by default; `RequestNetworkChannel`
+ *   switches one to sequenced (stale messages dropped) or reliable-ordered
+ *   (see ReliableChannel.hpp)
  * - Transport: UDP for low-latency game state
  * - Heartbeat: 1 second interval for connection keep-alive
+ * - Received messages reach the module thread through bounded lock-free
+ *   rings of `RTYPE_NET_QUEUE` slots (default 4096, see MessageRing.hpp);
+ *   client lifecycle events spill past a full ring instead of dropping
+ * - Socket I/O: asio by default; `RTYPE_NET_BACKEND=mmsg` makes a Linux
+ *   server receive and send in batches with recvmmsg/sendmmsg
+ *   (see MmsgBatcher.hpp)
+ * - Snapshots: `_snapshot` deltas against the client's last `_snapshot_ack`,
+ *   cut into chunks of at most one MTU that each apply on their own; a
+ *   snapshot is acked once all its chunks arrived (see SnapshotCodec.hpp)
  * 
  * @see docs/NETWORK_PROTOCOL.md for protocol details
  * @see docs/CHANNELS.md for complete channel reference
@@ -38,7 +61,12 @@
 #pragma once
 
 #include "../AModule.hpp"
+#include "EndpointTable.hpp"
 #include "INetworkManager.hpp"
+#include "MessageRing.hpp"
+#include "MmsgBatcher.hpp"
+#include "ReliableChannel.hpp"
+#include "SnapshotCodec.hpp"
 
 #include <asio.hpp>
 #include <atomic>
@@ -48,8 +76,10 @@
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <random>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -57,7 +87,10 @@ namespace rtypeEngine {
 
 class NetworkManager : public AModule, public INetworkManager {
 public:
-  explicit NetworkManager(const char *pubEndpoint, const char *subEndpoint);
+  /// `pollMessages`: also keep received messages for getFirstMessage() and
+  /// friends. The module loaded by the engine reads them from the bus only.
+  explicit NetworkManager(const char *pubEndpoint, const char *subEndpoint,
+                          bool pollMessages = true);
   ~NetworkManager() override;
 
   void init() override;
@@ -86,16 +119,25 @@ public:
   std::optional<NetworkEnvelope> getLastMessage() override;
   std::vector<NetworkEnvelope> getAllMessages() override;
 
+  /// Delivery channel used for `topic` from now on (unreliable by default).
+  void setTopicChannel(const std::string &topic, channel::Delivery delivery);
+
 private:
   using udp = asio::ip::udp;
   using WorkGuard = asio::executor_work_guard<asio::io_context::executor_type>;
 
-  // Client session for multi-client tracking
+  // Client session for multi-client tracking. The io thread updates the
+  // atomics on every datagram without taking _clientsMutex.
   struct ClientSession {
+    ClientSession(uint32_t clientId, const udp::endpoint &clientEndpoint,
+                  std::chrono::steady_clock::time_point now)
+        : id(clientId), endpoint(clientEndpoint), lastActivity(now) {}
+
     uint32_t id;
     udp::endpoint endpoint;
-    std::chrono::steady_clock::time_point lastActivity;
-    bool connected = true;
+    std::atomic<std::chrono::steady_clock::time_point> lastActivity;
+    std::atomic<bool> connected{true};
+    std::atomic<uint32_t> ackedSnapshot{0}; // newest snapshot applied, 0 = none
   };
 
   void startIoContext();
@@ -112,19 +154,40 @@ private:
   void handleSendBinaryRequest(const std::string &payload);
   void handleSendToBinaryRequest(const std::string &payload);
   void handleBroadcastBinaryRequest(const std::string &payload);
+  void handleChannelRequest(const std::string &payload);
+  void handleQueuePolicyRequest(const std::string &payload);
+
+  // Snapshot replication
+  void handleSnapshotPublish(const std::string &payload);
+  void handleSnapshotAck(uint32_t clientId, const std::string &payload);
+  void handleSnapshotPacket(const std::string &payload,
+                            const udp::endpoint &senderEndpoint);
+  void requestFullSnapshot();
 
   void startReceive();
   void handleReceive(const std::error_code &ec, std::size_t bytes_transferred);
-  void processIncomingBuffer(const std::vector<char> &buffer,
+  void processIncomingBuffer(const char *data, std::size_t size,
                              const udp::endpoint &senderEndpoint);
-  void enqueueMessage(const NetworkEnvelope &envelope);
-  void queueBusMessage(const std::string &topic, const std::string &payload);
+  void processEnvelope(const NetworkEnvelope &envelope,
+                       const udp::endpoint &senderEndpoint, uint32_t clientId);
+  void enqueueMessage(const NetworkEnvelope &envelope, DropPolicy policy);
+  void queueBusMessage(const std::string &topic, const std::string &payload,
+                       uint32_t clientId = 0,
+                       DropPolicy policy = DropPolicy::Keep);
+  /// Client lifecycle events: spilled past a full ring, never dropped.
+  void queueLifecycleMessage(const std::string &topic,
+                             const std::string &payload);
+  DropPolicy queuePolicyFor(const std::string &topic) const;
+  void publishBusMessages();
+  void drainMessageRing();
   void publishStatus(const std::string &status);
   void publishError(const std::string &error);
   void disconnectInternal();
 
   // Multi-client helpers
   uint32_t getOrCreateClientId(const udp::endpoint &endpoint);
+  ClientSession *findSession(uint32_t clientId);
+  void clearClients();
   void updateClientActivity(uint32_t clientId);
   void checkClientTimeouts();
   void sendHeartbeats();
@@ -134,31 +197,150 @@ private:
                             const std::string &topic,
                             const std::vector<char> &payload);
 
+  // Outbound coalescing (io thread)
+  using Datagram = std::shared_ptr<std::vector<char>>;
+  struct OutboundBatch {
+    std::vector<char> data;
+    uint32_t messages = 0;
+  };
+  void postEnvelope(const udp::endpoint &endpoint, const std::string &topic,
+                    const std::string &payload);
+  void queueOutbound(const udp::endpoint &endpoint, const Datagram &packet);
+  void flushOutbound();
+  void flushBatch(const udp::endpoint &endpoint, OutboundBatch &batch);
+  void sendDatagram(const udp::endpoint &endpoint, const Datagram &datagram,
+                    uint32_t messages);
+  void publishOutboundStats(std::chrono::steady_clock::time_point now);
+
+#ifdef __linux__
+  // Batched socket I/O, RTYPE_NET_BACKEND=mmsg (io thread)
+  void handleBatchReceive(const std::error_code &ec);
+  void flushBatchedSends();
+#endif
+
+  // Delivery channels (io thread)
+  struct PeerChannels {
+    channel::Sender sender;
+    channel::Receiver receiver;
+  };
+  channel::Delivery channelFor(const std::string &topic);
+  PeerChannels &peerChannels(const udp::endpoint &endpoint);
+  void sendOnChannel(const udp::endpoint &endpoint, const std::string &topic,
+                     const std::string &payload, channel::Delivery delivery);
+  void handleChannelAck(const udp::endpoint &endpoint,
+                        const std::string &payload);
+  void armChannelTimer();
+  void serviceChannels();
+
   asio::io_context _ioContext;
   std::unique_ptr<WorkGuard> _workGuard;
   std::thread _ioThread;
   std::shared_ptr<udp::socket> _socket;
   std::array<char, 65536> _recvBuffer{};
+  bool _batchedIo = false; // RTYPE_NET_BACKEND=mmsg, server only
+#ifdef __linux__
+  std::unique_ptr<MmsgBatcher> _mmsg; // set while bound with _batchedIo
+  bool _batchFlushQueued = false;     // flush posted or waiting for writable
+#endif
+
+  // Outbound coalescing: pending datagram per endpoint until the next flush
+  // (io thread only)
+  std::map<udp::endpoint, OutboundBatch> _outbound;
+  asio::steady_timer _flushTimer{_ioContext};
+  bool _flushTimerArmed = false;
+  std::size_t _mtu = DEFAULT_MTU;
+  std::chrono::microseconds _flushDelay = DEFAULT_FLUSH_DELAY;
+
+  // Delivery channels: per-topic choice, per-peer state (io thread only)
+  std::mutex _topicChannelsMutex;
+  std::unordered_map<std::string, channel::Delivery> _topicChannels;
+  std::map<udp::endpoint, PeerChannels> _peers;
+  asio::steady_timer _channelTimer{_ioContext};
+  bool _channelTimerArmed = false;
+  std::mt19937 _streamIds{std::random_device{}()};
+
+  // Outbound stats, published as NetworkStats once per second
+  std::atomic<uint64_t> _datagramsSent{0};
+  std::atomic<uint64_t> _messagesSent{0};
+  std::atomic<uint64_t> _bytesSent{0};
+  std::atomic<uint64_t> _reliableResends{0};
+  std::atomic<uint64_t> _staleDropped{0};
+  std::atomic<uint64_t> _sendCalls{0}; // socket send syscalls (or async sends)
+  std::atomic<uint64_t> _recvCalls{0};
+  uint64_t _statsDatagrams = 0;
+  uint64_t _statsMessages = 0;
+  uint64_t _statsBytes = 0;
+  uint64_t _statsResends = 0;
+  uint64_t _statsStale = 0;
+  uint64_t _statsSendCalls = 0;
+  uint64_t _statsRecvCalls = 0;
+  std::chrono::steady_clock::time_point _lastStatsTime;
 
   // Debug counters/telemetry
   std::atomic<uint64_t> _enqueuedTotal{0};
   std::atomic<uint64_t> _overflowTotal{0};
+  std::atomic<uint64_t> _busDropped{0};
+  uint64_t _statsBusDropped = 0;
+  uint64_t _statsOverflow = 0;
   size_t _maxQueueSizeObserved = 0;
   std::chrono::steady_clock::time_point _lastOverflowLog;
 
+  // Received messages for getFirstMessage()/getAllMessages(): the io thread
+  // pushes into the ring; callers move them to _messageQueue under
+  // _queueMutex, which the io thread never takes. Unused unless polling.
+  bool _pollMessages;
+  MessageRing<NetworkEnvelope> _messageRing;
   std::mutex _queueMutex;
   std::deque<NetworkEnvelope> _messageQueue;
 
-  std::mutex _busMutex;
-  std::deque<std::pair<std::string, std::string>> _busMessages;
+  // Messages for the bus, pushed by the io and module threads, published by
+  // loop() on the module thread.
+  struct BusMessage {
+    std::string topic;
+    std::string payload;
+  };
+  MessageRing<BusMessage> _busRing;
+  // Lifecycle events the full ring refused, published after it.
+  std::mutex _busSpillMutex;
+  std::vector<BusMessage> _busSpill;
+  std::atomic<bool> _busSpilled{false};
+
+  // Drop policy per incoming topic (io thread only; Keep if absent)
+  std::unordered_map<std::string, DropPolicy> _queuePolicies;
 
-  // Multi-client tracking
+  // Multi-client tracking. Sessions are indexed by id - _firstClientId;
+  // a deque so they never move. Only the io thread adds or clears them, so
+  // it reads without locking; other threads hold _clientsMutex.
   std::mutex _clientsMutex;
-  std::map<uint32_t, ClientSession> _clients;
-  std::map<std::string, uint32_t> _endpointToClientId;
+  std::deque<ClientSession> _sessions;
+  EndpointTable _endpointIds; // io thread only
+  uint32_t _firstClientId = 1;
   uint32_t _nextClientId = 1;
   std::atomic<bool> _isServer{false};
 
+  // Snapshot replication, server side (module thread only)
+  std::unordered_map<std::string, uint32_t> _netIdByEntity;
+  std::unordered_map<uint32_t, const std::string *> _entityByNetId;
+  uint32_t _nextNetId = 1;
+  uint32_t _snapshotSequence = 0;
+  std::deque<snapshot::Snapshot> _snapshotHistory;
+
+  // Snapshot replication, client side (io thread only)
+  struct SnapshotAssembly {
+    uint32_t sequence = 0;
+    uint32_t baseline = 0;
+    std::vector<std::vector<snapshot::EntityState>> parts; // by chunk index
+    std::vector<bool> received;
+    std::size_t missing = 0;
+    bool forwardWhole = false;
+  };
+  std::deque<snapshot::Snapshot> _receivedSnapshots; // complete, acked
+  SnapshotAssembly _snapshotAssembly;
+  // Entity states as last forwarded to the game, sorted by net id.
+  std::vector<snapshot::EntityState> _forwardedEntities;
+  std::unordered_map<uint32_t, std::string> _remoteEntityIds;
+  bool _forwardFullSnapshot = false;
+
   // Remote endpoint protection
   std::mutex _remoteEndpointMutex;
   udp::endpoint _remoteEndpoint; // Protected by _remoteEndpointMutex when
@@ -169,6 +351,13 @@ private:
   std::chrono::steady_clock::time_point _lastTimeoutCheckTime;
   static constexpr auto HEARTBEAT_INTERVAL = std::chrono::seconds(1);
   static constexpr auto CLIENT_TIMEOUT = std::chrono::seconds(5);
+  static constexpr double NETWORK_TICK_RATE = 200.0;
+  static constexpr std::size_t DEFAULT_MTU = 1200; // UDP payload, fits IPv6 min MTU
+  static constexpr auto DEFAULT_FLUSH_DELAY = std::chrono::microseconds(2000);
+  static constexpr std::size_t ACK_RESERVE = 32; // room kept for a piggybacked _ack
+  static constexpr auto CHANNEL_TICK = std::chrono::milliseconds(10);
+  static constexpr std::size_t DEFAULT_QUEUE_CAPACITY = 4096;
+  static constexpr int MAX_RECEIVE_BATCHES = 4; // recvmmsg calls per wakeup
 
   std::atomic<bool> _ioThreadRunning;
 };
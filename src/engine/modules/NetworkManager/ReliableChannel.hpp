@@ -0,0 +1,324 @@
+/**
+ * @file ReliableChannel.hpp
+ * @brief Delivery channels layered on top of the UDP envelopes
+ *
+ * @details Every topic is sent on one of three channels:
+ * - `Unreliable`: fire and forget, as plain UDP.
+ * - `Sequenced`: unreliable, but a message older than the newest one already
+ *   received with the same topic and key is dropped instead of applied out
+ *   of order. The key is the payload up to its first space ("id x y z ..."),
+ *   so updates for different entities never shadow each other.
+ * - `Reliable`: resent until acknowledged and delivered in send order.
+ *
+ * Sequenced and reliable envelopes carry extra msgpack fields:
+ *
+ * @code
+ * [topic, payload, channel, sequence, stream, base]
+ * @endcode
+ *
+ * `sequence` counts per peer and channel from 1. `stream` is a random id of
+ * the sender's channel state, so a receiver notices when the other side
+ * started over. `base` is the oldest reliable sequence the sender still
+ * holds unacknowledged: a receiver meeting a new stream starts there.
+ *
+ * Reliable messages are acknowledged with the last sequence delivered in
+ * order, the newest sequence received and a 32-bit field for the 32
+ * sequences before it. The ack rides in the next datagram going to that peer
+ * (`_ack` envelope) or goes alone on the next channel tick.
+ * Resends are timed from a smoothed RTT (RFC 6298 style, with backoff).
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace rtypeEngine {
+namespace channel {
+
+using Clock = std::chrono::steady_clock;
+
+enum class Delivery : uint8_t { Unreliable = 0, Sequenced = 1, Reliable = 2 };
+
+constexpr std::size_t ACK_WINDOW = 32;
+constexpr std::size_t MAX_BUFFERED = 1024;   // out-of-order reliable messages held per peer
+constexpr std::size_t MAX_PENDING = 1024;    // unacknowledged reliable messages held per peer
+constexpr std::size_t MAX_SEQUENCED_KEYS = 4096;
+constexpr auto INITIAL_RTO = std::chrono::milliseconds(200);
+constexpr auto MIN_RTO = std::chrono::milliseconds(30);
+constexpr auto MAX_RTO = std::chrono::milliseconds(1000);
+
+/// "unreliable", "sequenced" or "reliable"; false for anything else.
+inline bool parseDelivery(const std::string &name, Delivery &out) {
+  if (name == "unreliable") {
+    out = Delivery::Unreliable;
+  } else if (name == "sequenced") {
+    out = Delivery::Sequenced;
+  } else if (name == "reliable") {
+    out = Delivery::Reliable;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+struct Ack {
+  uint32_t stream = 0;     // sender stream being acknowledged
+  uint32_t delivered = 0;  // every sequence up to this one was received
+  uint32_t newest = 0;
+  uint32_t bits = 0;       // bit i set: newest - 1 - i was received
+};
+
+constexpr std::size_t ACK_SIZE = 16;
+
+inline std::string encodeAck(const Ack &ack) {
+  std::string out(ACK_SIZE, '\0');
+  const uint32_t words[4] = {ack.stream, ack.delivered, ack.newest, ack.bits};
+  for (std::size_t w = 0; w < 4; ++w) {
+    for (std::size_t b = 0; b < 4; ++b) {
+      out[w * 4 + b] = static_cast<char>((words[w] >> (8 * b)) & 0xFF);
+    }
+  }
+  return out;
+}
+
+inline bool decodeAck(const std::string &payload, Ack &out) {
+  if (payload.size() != ACK_SIZE) return false;
+  uint32_t words[4] = {};
+  for (std::size_t w = 0; w < 4; ++w) {
+    for (std::size_t b = 0; b < 4; ++b) {
+      words[w] |= static_cast<uint32_t>(static_cast<uint8_t>(payload[w * 4 + b])) << (8 * b);
+    }
+  }
+  out.stream = words[0];
+  out.delivered = words[1];
+  out.newest = words[2];
+  out.bits = words[3];
+  return true;
+}
+
+/// Outgoing side of one peer: sequence numbers, unacked messages, RTT.
+class Sender {
+ public:
+  struct Pending {
+    std::string topic;
+    std::string payload;
+    Clock::time_point sentAt;
+    uint32_t sends = 1;
+  };
+
+  explicit Sender(uint32_t stream) : _stream(stream) {}
+
+  uint32_t stream() const { return _stream; }
+  uint32_t nextSequenced() { return _nextSequenced++; }
+
+  /**
+   * Number a reliable message and keep it until acknowledged.
+   * @return Its sequence, or 0 if MAX_PENDING messages are already unacked.
+   */
+  uint32_t pushReliable(const std::string &topic, const std::string &payload, Clock::time_point now) {
+    if (_pending.size() >= MAX_PENDING) return 0;
+    uint32_t sequence = _nextReliable++;
+    _pending.emplace(sequence, Pending{topic, payload, now, 1});
+    return sequence;
+  }
+
+  /// Oldest unacknowledged reliable sequence (the next one if none is).
+  uint32_t base() const { return _pending.empty() ? _nextReliable : _pending.begin()->first; }
+
+  /// Drops acknowledged messages; returns how many.
+  std::size_t onAck(const Ack &ack, Clock::time_point now) {
+    if (ack.stream != _stream) return 0;
+    std::size_t acked = 0;
+    auto release = [&](std::map<uint32_t, Pending>::iterator it) {
+      // Karn: only messages sent once give an unambiguous sample.
+      if (it->second.sends == 1) sampleRtt(now - it->second.sentAt);
+      ++acked;
+      return _pending.erase(it);
+    };
+    for (auto it = _pending.begin(); it != _pending.end() && it->first <= ack.delivered;) {
+      it = release(it);
+    }
+    if (ack.newest == 0) return acked;
+    auto find = [&](uint32_t sequence) {
+      auto it = _pending.find(sequence);
+      if (it != _pending.end()) release(it);
+    };
+    find(ack.newest);
+    for (uint32_t i = 0; i < ACK_WINDOW && i + 1 < ack.newest; ++i) {
+      if (ack.bits & (1u << i)) find(ack.newest - 1 - i);
+    }
+    return acked;
+  }
+
+  /// Messages whose resend timer expired, oldest first; marks them resent.
+  template <typename Resend>
+  std::size_t resendDue(Clock::time_point now, Resend &&resend) {
+    std::size_t count = 0;
+    for (auto &[sequence, pending] : _pending) {
+      if (now - pending.sentAt < _rto) continue;
+      pending.sentAt = now;
+      ++pending.sends;
+      resend(sequence, pending);
+      ++count;
+    }
+    if (count > 0) {
+      _rto = std::min<Clock::duration>(_rto * 2, MAX_RTO);  // back off until acks come back
+    }
+    return count;
+  }
+
+  bool hasPending() const { return !_pending.empty(); }
+  std::size_t pendingCount() const { return _pending.size(); }
+  Clock::duration rto() const { return _rto; }
+  Clock::duration srtt() const { return _srtt; }
+
+ private:
+  void sampleRtt(Clock::duration sample) {
+    if (!_hasRtt) {
+      _srtt = sample;
+      _rttvar = sample / 2;
+      _hasRtt = true;
+    } else {
+      Clock::duration error = sample > _srtt ? sample - _srtt : _srtt - sample;
+      _rttvar = (_rttvar * 3 + error) / 4;
+      _srtt = (_srtt * 7 + sample) / 8;
+    }
+    _rto = std::clamp<Clock::duration>(_srtt + _rttvar * 4, MIN_RTO, MAX_RTO);
+  }
+
+  uint32_t _stream;
+  uint32_t _nextSequenced = 1;
+  uint32_t _nextReliable = 1;
+  std::map<uint32_t, Pending> _pending;
+  Clock::duration _srtt{0};
+  Clock::duration _rttvar{0};
+  Clock::duration _rto = INITIAL_RTO;
+  bool _hasRtt = false;
+};
+
+/// Incoming side of one peer: stale filter, reorder buffer, ack window.
+class Receiver {
+ public:
+  /// False if a sequenced message is older than the newest seen with its topic and key.
+  bool acceptSequenced(uint32_t stream, const std::string &topic, const std::string &payload,
+                       uint32_t sequence) {
+    if (stream != _sequencedStream) {
+      _sequencedStream = stream;
+      _lastSequenced.clear();
+      _newestSequenced = 0;
+    }
+    std::string key = topic + ' ' + sequencedKey(payload);
+    auto it = _lastSequenced.find(key);
+    if (it != _lastSequenced.end()) {
+      if (sequence <= it->second) return false;
+      it->second = sequence;
+    } else {
+      if (_lastSequenced.size() >= MAX_SEQUENCED_KEYS) forgetOldKeys();
+      _lastSequenced.emplace(std::move(key), sequence);
+    }
+    _newestSequenced = std::max(_newestSequenced, sequence);
+    return true;
+  }
+
+  std::size_t sequencedKeyCount() const { return _lastSequenced.size(); }
+
+  /**
+   * Record a reliable message and hand every message now in order to
+   * `deliver(topic, payload)`. Duplicates are acknowledged but not delivered.
+   * @return false if the message was dropped (duplicate or buffer full).
+   */
+  template <typename Deliver>
+  bool receiveReliable(uint32_t stream, uint32_t base, uint32_t sequence, std::string topic,
+                       std::string payload, Deliver &&deliver) {
+    if (sequence == 0) return false;
+    if (stream != _reliableStream) {
+      _reliableStream = stream;
+      _nextExpected = std::max<uint32_t>(base, 1);
+      _buffered.clear();
+      _ack = Ack{stream, _nextExpected - 1, 0, 0};
+    }
+    if (sequence < _nextExpected || _buffered.count(sequence)) {
+      recordAck(sequence);
+      return false;
+    }
+    if (sequence != _nextExpected && _buffered.size() >= MAX_BUFFERED) {
+      return false;  // not acked: the sender will try again later
+    }
+    recordAck(sequence);
+
+    if (sequence != _nextExpected) {
+      _buffered.emplace(sequence, std::make_pair(std::move(topic), std::move(payload)));
+      return true;
+    }
+    deliver(topic, payload);
+    ++_nextExpected;
+    for (auto it = _buffered.begin(); it != _buffered.end() && it->first == _nextExpected;) {
+      deliver(it->second.first, it->second.second);
+      ++_nextExpected;
+      it = _buffered.erase(it);
+    }
+    _ack.delivered = _nextExpected - 1;
+    return true;
+  }
+
+  bool ackPending() const { return _ackPending; }
+
+  /// The ack to send now; clears the pending flag.
+  Ack takeAck() {
+    _ackPending = false;
+    return _ack;
+  }
+
+ private:
+  static std::string sequencedKey(const std::string &payload) {
+    return payload.substr(0, payload.find(' '));
+  }
+
+  /// Keys not updated within the last MAX_SEQUENCED_KEYS sequences (despawned entities).
+  void forgetOldKeys() {
+    for (auto it = _lastSequenced.begin(); it != _lastSequenced.end();) {
+      if (_newestSequenced - it->second >= MAX_SEQUENCED_KEYS) {
+        it = _lastSequenced.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void recordAck(uint32_t sequence) {
+    if (sequence > _ack.newest) {
+      uint32_t shift = sequence - _ack.newest;
+      if (_ack.newest == 0 || shift > ACK_WINDOW) {
+        _ack.bits = 0;
+      } else {
+        _ack.bits = (shift == ACK_WINDOW ? 0u : _ack.bits << shift) | (1u << (shift - 1));
+      }
+      _ack.newest = sequence;
+    } else if (sequence < _ack.newest) {
+      uint32_t distance = _ack.newest - sequence;
+      if (distance <= ACK_WINDOW) _ack.bits |= 1u << (distance - 1);
+    }
+    _ackPending = true;
+  }
+
+  uint32_t _sequencedStream = 0;
+  std::unordered_map<std::string, uint32_t> _lastSequenced;  // "topic key" -> newest sequence
+  uint32_t _newestSequenced = 0;
+
+  uint32_t _reliableStream = 0;
+  uint32_t _nextExpected = 1;
+  std::map<uint32_t, std::pair<std::string, std::string>> _buffered;
+  Ack _ack;
+  bool _ackPending = false;
+};
+
+}  // namespace channel
+}  // namespace rtypeEngine
@@ -0,0 +1,484 @@
+/**
+ * @file SnapshotCodec.hpp
+ * @brief Delta-compressed world snapshots for server -> client replication
+ *
+ * @details The server numbers every snapshot of the replicated entities and
+ * keeps a short history. Each client acknowledges the newest snapshot it has
+ * applied; the next snapshot for that client is encoded as a delta against
+ * that acked baseline (or against an empty world if none is known).
+ *
+ * A delta is split into chunks that each fit one datagram. Chunk i covers a
+ * range of net ids, the ranges of one snapshot are consecutive and together
+ * cover every net id, so each chunk decodes on its own against the baseline
+ * and the client assembles the whole snapshot once it holds all of them.
+ *
+ * Fields are quantized to integers (1/100 unit for positions, rotations and
+ * velocities) and each chunk is bit-packed:
+ *
+ * @code
+ * u32 sequence | u32 baseline (0 = full snapshot) | u16 chunk index | u16 chunk count
+ * var firstNetId | var lastNetId                  (range covered, inclusive)
+ * var removedCount | var netIdDelta...            (ascending, from firstNetId)
+ * var changedCount | per entity:
+ *   var netIdDelta | 1 bit isNew | [var len | len x 8-bit chars]  (entity id, new only)
+ *   10 bit field mask | var zigzag(delta) for every set bit
+ * @endcode
+ *
+ * `var` is a 6-bit bit length followed by that many bits. Deltas are 32-bit
+ * differences that wrap modulo 2^32; deltas of new entities are taken
+ * against zero. Entities are referred to by a compact
+ * network id; the full entity id only travels when an entity is new to the
+ * baseline the client acknowledged.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rtypeEngine {
+namespace snapshot {
+
+enum Field : std::size_t { Kind = 0, X, Y, Z, RX, RY, RZ, VX, VY, VZ, FIELD_COUNT };
+
+constexpr float FIELD_SCALE[FIELD_COUNT] = {1.0f,   100.0f, 100.0f, 100.0f, 100.0f,
+                                            100.0f, 100.0f, 100.0f, 100.0f, 100.0f};
+constexpr int32_t QUANT_LIMIT = 1 << 30;
+constexpr std::size_t HISTORY = 32;
+constexpr std::size_t MAX_ID_LENGTH = 255;
+constexpr std::size_t MAX_CHUNKS = 0xFFFF;
+// msgpack ["_snapshot", payload] around a chunk of less than 64 KiB.
+constexpr std::size_t ENVELOPE_OVERHEAD = 16;
+
+inline int32_t quantize(float value, std::size_t field) {
+  double scaled = std::nearbyint(static_cast<double>(value) * FIELD_SCALE[field]);
+  if (!(scaled == scaled)) return 0;  // NaN
+  scaled = std::max<double>(-QUANT_LIMIT, std::min<double>(QUANT_LIMIT, scaled));
+  return static_cast<int32_t>(scaled);
+}
+
+inline float dequantize(int32_t value, std::size_t field) {
+  return static_cast<float>(value) / FIELD_SCALE[field];
+}
+
+struct EntityState {
+  uint32_t netId = 0;
+  int32_t fields[FIELD_COUNT] = {};
+};
+
+struct Snapshot {
+  uint32_t sequence = 0;
+  std::vector<EntityState> entities;  // sorted by netId
+
+  const EntityState *find(uint32_t netId) const {
+    auto it = std::lower_bound(entities.begin(), entities.end(), netId,
+                               [](const EntityState &e, uint32_t id) { return e.netId < id; });
+    return (it != entities.end() && it->netId == netId) ? &*it : nullptr;
+  }
+
+  void sort() {
+    std::sort(entities.begin(), entities.end(),
+              [](const EntityState &a, const EntityState &b) { return a.netId < b.netId; });
+  }
+};
+
+class BitWriter {
+ public:
+  void write(uint32_t value, unsigned count) {
+    if (count == 0) return;
+    if (count < 32) value &= (1u << count) - 1;
+    _acc |= static_cast<uint64_t>(value) << _accBits;
+    _accBits += count;
+    while (_accBits >= 8) {
+      _bytes.push_back(static_cast<char>(_acc & 0xFF));
+      _acc >>= 8;
+      _accBits -= 8;
+    }
+  }
+
+  void writeVar(uint32_t value) {
+    unsigned width = 0;
+    while (width < 32 && (value >> width) != 0) ++width;
+    write(width, 6);
+    write(value, width);
+  }
+
+  std::string take() {
+    if (_accBits > 0) _bytes.push_back(static_cast<char>(_acc & 0xFF));
+    _acc = 0;
+    _accBits = 0;
+    return std::move(_bytes);
+  }
+
+ private:
+  std::string _bytes;
+  uint64_t _acc = 0;
+  unsigned _accBits = 0;
+};
+
+class BitReader {
+ public:
+  explicit BitReader(const std::string &data) : _data(data) {}
+
+  uint32_t read(unsigned count) {
+    if (count == 0) return 0;
+    if (count > 32 || _bits + count > _data.size() * 8) {
+      _ok = false;
+      return 0;
+    }
+    std::size_t byte = _bits >> 3;
+    uint64_t window = 0;
+    for (unsigned k = 0; k < 5 && byte + k < _data.size(); ++k) {
+      window |= static_cast<uint64_t>(static_cast<uint8_t>(_data[byte + k])) << (8 * k);
+    }
+    window >>= (_bits & 7);
+    _bits += count;
+    return static_cast<uint32_t>(count == 32 ? window : window & ((1ull << count) - 1));
+  }
+
+  uint32_t readVar() {
+    unsigned width = read(6);
+    if (width > 32) {
+      _ok = false;
+      return 0;
+    }
+    return read(width);
+  }
+
+  bool ok() const { return _ok; }
+
+ private:
+  const std::string &_data;
+  std::size_t _bits = 0;
+  bool _ok = true;
+};
+
+/// Field deltas wrap modulo 2^32, so any pair of int32 values round-trips.
+inline int32_t wrappingDelta(int32_t current, int32_t reference) {
+  return static_cast<int32_t>(static_cast<uint32_t>(current) - static_cast<uint32_t>(reference));
+}
+
+inline int32_t applyDelta(int32_t reference, int32_t delta) {
+  return static_cast<int32_t>(static_cast<uint32_t>(reference) + static_cast<uint32_t>(delta));
+}
+
+inline uint32_t zigzag(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+inline int32_t unzigzag(uint32_t value) {
+  return static_cast<int32_t>((value >> 1) ^ (0u - (value & 1u)));
+}
+
+inline unsigned varBits(uint32_t value) {
+  unsigned width = 0;
+  while (width < 32 && (value >> width) != 0) ++width;
+  return 6 + width;
+}
+
+constexpr unsigned CHUNK_FIXED_BITS = 32 + 32 + 16 + 16;
+
+/// Header fields of one chunk.
+struct ChunkHeader {
+  uint32_t sequence = 0;
+  uint32_t baseline = 0;
+  uint16_t index = 0;
+  uint16_t count = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+};
+
+/**
+ * Encode `current` against `baseline` (nullptr for a full snapshot) as chunks
+ * of at most `maxBytes`, cut in net id order. A chunk holds at least one
+ * entity, so only an entity alone bigger than `maxBytes` exceeds it.
+ * @param idOf returns the entity id string of a net id present in `current`.
+ */
+template <typename IdLookup>
+std::vector<std::string> encodeChunks(const Snapshot &current, const Snapshot *baseline,
+                                      IdLookup &&idOf, std::size_t maxBytes) {
+  static const Snapshot EMPTY;
+  const Snapshot &base = baseline ? *baseline : EMPTY;
+
+  struct Item {
+    uint32_t netId;
+    const EntityState *state;   // null: removed
+    const EntityState *before;  // null: new (or removed)
+  };
+  std::vector<Item> items;
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < current.entities.size() || j < base.entities.size()) {
+    if (j == base.entities.size() ||
+        (i < current.entities.size() && current.entities[i].netId < base.entities[j].netId)) {
+      const EntityState &now = current.entities[i++];
+      items.push_back({now.netId, &now, nullptr});
+    } else if (i == current.entities.size() || base.entities[j].netId < current.entities[i].netId) {
+      items.push_back({base.entities[j++].netId, nullptr, nullptr});
+    } else {
+      const EntityState &now = current.entities[i++];
+      const EntityState &before = base.entities[j++];
+      if (!std::equal(std::begin(now.fields), std::end(now.fields), std::begin(before.fields))) {
+        items.push_back({now.netId, &now, &before});
+      }
+    }
+  }
+
+  auto reference = [](const Item &item, std::size_t f) {
+    return item.before ? item.before->fields[f] : 0;
+  };
+  auto fieldMask = [&](const Item &item) {
+    uint32_t mask = 0;
+    for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+      if (item.state->fields[f] != reference(item, f)) mask |= 1u << f;
+    }
+    return mask;
+  };
+  auto idLength = [&](const Item &item) {
+    return std::min(idOf(item.netId).size(), MAX_ID_LENGTH);
+  };
+  // Bits of everything but the net id delta.
+  auto bodyBits = [&](const Item &item) -> std::size_t {
+    if (!item.state) return 0;
+    std::size_t bits = 1 + FIELD_COUNT;
+    if (!item.before) {
+      std::size_t length = idLength(item);
+      bits += varBits(static_cast<uint32_t>(length)) + 8 * length;
+    }
+    uint32_t mask = fieldMask(item);
+    for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+      if (mask & (1u << f)) bits += varBits(zigzag(wrappingDelta(item.state->fields[f], reference(item, f))));
+    }
+    return bits;
+  };
+
+  // Greedy cut: chunk k holds items [cuts[k], cuts[k + 1]). The last net id
+  // and both counts are not known while filling, so reserve their maximum.
+  const std::size_t budget = std::max<std::size_t>(maxBytes, 1) * 8;
+  std::vector<std::size_t> cuts{0};
+  uint32_t first = 0;
+  std::size_t used = CHUNK_FIXED_BITS + varBits(first) + 3 * 38;
+  uint32_t previousRemoved = first;
+  uint32_t previousChanged = first;
+  for (std::size_t k = 0; k < items.size(); ++k) {
+    const Item &item = items[k];
+    uint32_t &previous = item.state ? previousChanged : previousRemoved;
+    std::size_t cost = varBits(item.netId - previous) + bodyBits(item);
+    if (k > cuts.back() && used + cost > budget && cuts.size() < MAX_CHUNKS) {
+      cuts.push_back(k);
+      first = item.netId;
+      used = CHUNK_FIXED_BITS + varBits(first) + 3 * 38;
+      previousRemoved = first;
+      previousChanged = first;
+      cost = varBits(0) + bodyBits(item);
+    }
+    used += cost;
+    previous = item.netId;
+  }
+  cuts.push_back(items.size());
+
+  const std::size_t count = cuts.size() - 1;
+  std::vector<std::string> chunks;
+  chunks.reserve(count);
+  for (std::size_t c = 0; c < count; ++c) {
+    const std::size_t begin = cuts[c];
+    const std::size_t end = cuts[c + 1];
+    uint32_t rangeFirst = c == 0 ? 0 : items[begin].netId;
+    uint32_t rangeLast = c + 1 == count ? UINT32_MAX : items[end].netId - 1;
+
+    BitWriter out;
+    out.write(current.sequence, 32);
+    out.write(baseline ? baseline->sequence : 0, 32);
+    out.write(static_cast<uint32_t>(c), 16);
+    out.write(static_cast<uint32_t>(count), 16);
+    out.writeVar(rangeFirst);
+    out.writeVar(rangeLast);
+
+    uint32_t removedCount = 0;
+    for (std::size_t k = begin; k < end; ++k) {
+      if (!items[k].state) ++removedCount;
+    }
+    out.writeVar(removedCount);
+    uint32_t previous = rangeFirst;
+    for (std::size_t k = begin; k < end; ++k) {
+      if (items[k].state) continue;
+      out.writeVar(items[k].netId - previous);
+      previous = items[k].netId;
+    }
+
+    out.writeVar(static_cast<uint32_t>(end - begin - removedCount));
+    previous = rangeFirst;
+    for (std::size_t k = begin; k < end; ++k) {
+      const Item &item = items[k];
+      if (!item.state) continue;
+      out.writeVar(item.netId - previous);
+      previous = item.netId;
+
+      bool isNew = item.before == nullptr;
+      out.write(isNew ? 1 : 0, 1);
+      if (isNew) {
+        const std::string &id = idOf(item.netId);
+        std::size_t length = idLength(item);
+        out.writeVar(static_cast<uint32_t>(length));
+        for (std::size_t b = 0; b < length; ++b) {
+          out.write(static_cast<uint8_t>(id[b]), 8);
+        }
+      }
+
+      uint32_t mask = fieldMask(item);
+      out.write(mask, FIELD_COUNT);
+      for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+        if (!(mask & (1u << f))) continue;
+        out.writeVar(zigzag(wrappingDelta(item.state->fields[f], reference(item, f))));
+      }
+    }
+    chunks.push_back(out.take());
+  }
+  return chunks;
+}
+
+/// The whole delta as a single chunk.
+template <typename IdLookup>
+std::string encodeDelta(const Snapshot &current, const Snapshot *baseline, IdLookup &&idOf) {
+  return encodeChunks(current, baseline, idOf, SIZE_MAX / 8).front();
+}
+
+inline bool readHeader(BitReader &in, ChunkHeader &header) {
+  header.sequence = in.read(32);
+  header.baseline = in.read(32);
+  header.index = static_cast<uint16_t>(in.read(16));
+  header.count = static_cast<uint16_t>(in.read(16));
+  header.first = in.readVar();
+  header.last = in.readVar();
+  return in.ok() && header.sequence != 0 && header.index < header.count &&
+         header.first <= header.last;
+}
+
+inline bool readHeader(const std::string &payload, ChunkHeader &header) {
+  BitReader in(payload);
+  return readHeader(in, header);
+}
+
+inline bool readHeader(const std::string &payload, uint32_t &sequence, uint32_t &baseline) {
+  ChunkHeader header;
+  bool ok = readHeader(payload, header);
+  sequence = header.sequence;
+  baseline = header.baseline;
+  return ok;
+}
+
+/// Result of applying a delta: what changed, for forwarding to the game.
+struct AppliedDelta {
+  std::vector<uint32_t> removed;
+  std::vector<uint32_t> changed;                            // net ids, new ones included
+  std::vector<std::pair<uint32_t, std::string>> newIds;     // net id -> entity id
+};
+
+/**
+ * Rebuild the entities of one chunk's net id range from it and its baseline.
+ * @param baseline the snapshot named in the header, nullptr if it is 0.
+ * @param entities set to the range's entities, sorted by net id.
+ */
+inline bool decodeChunk(const std::string &payload, const Snapshot *baseline, ChunkHeader &header,
+                        std::vector<EntityState> &entities, AppliedDelta &applied) {
+  static const Snapshot EMPTY;
+  const Snapshot &base = baseline ? *baseline : EMPTY;
+
+  BitReader in(payload);
+  if (!readHeader(in, header) || header.baseline != (baseline ? baseline->sequence : 0)) {
+    return false;
+  }
+
+  auto inRange = [&](uint32_t netId) { return netId >= header.first && netId <= header.last; };
+  auto begin = std::lower_bound(base.entities.begin(), base.entities.end(), header.first,
+                                [](const EntityState &e, uint32_t id) { return e.netId < id; });
+  auto end = std::upper_bound(begin, base.entities.end(), header.last,
+                              [](uint32_t id, const EntityState &e) { return id < e.netId; });
+
+  const std::size_t removedStart = applied.removed.size();
+  uint32_t removedCount = in.readVar();
+  if (!in.ok() || removedCount > static_cast<std::size_t>(end - begin)) return false;
+  uint32_t netId = header.first;
+  for (uint32_t r = 0; r < removedCount; ++r) {
+    netId += in.readVar();
+    if (!inRange(netId)) return false;
+    applied.removed.push_back(netId);
+  }
+
+  uint32_t changedCount = in.readVar();
+  if (!in.ok() || changedCount > payload.size() * 8) return false;
+  std::vector<EntityState> changed;
+  changed.reserve(changedCount);
+  netId = header.first;
+  for (uint32_t c = 0; c < changedCount && in.ok(); ++c) {
+    EntityState state;
+    netId += in.readVar();
+    if (!inRange(netId)) return false;
+    state.netId = netId;
+
+    bool isNew = in.read(1) != 0;
+    const EntityState *reference = isNew ? nullptr : base.find(netId);
+    if (!isNew && !reference) return false;
+    if (isNew) {
+      uint32_t length = in.readVar();
+      if (length > MAX_ID_LENGTH) return false;
+      std::string id(length, '\0');
+      for (uint32_t k = 0; k < length; ++k) {
+        id[k] = static_cast<char>(in.read(8));
+      }
+      applied.newIds.emplace_back(netId, std::move(id));
+    } else {
+      std::copy(std::begin(reference->fields), std::end(reference->fields), std::begin(state.fields));
+    }
+
+    uint32_t mask = in.read(FIELD_COUNT);
+    for (std::size_t f = 0; f < FIELD_COUNT; ++f) {
+      if (!(mask & (1u << f))) continue;
+      state.fields[f] = applyDelta(state.fields[f], unzigzag(in.readVar()));
+    }
+    changed.push_back(state);
+    applied.changed.push_back(netId);
+  }
+  if (!in.ok()) return false;
+
+  // Merge: baseline range minus removed, with changed entries replacing or adding.
+  entities.clear();
+  entities.reserve(static_cast<std::size_t>(end - begin) + changed.size());
+  std::size_t r = removedStart;
+  std::size_t c = 0;
+  auto b = begin;
+  while (b != end || c < changed.size()) {
+    if (c < changed.size() && (b == end || changed[c].netId <= b->netId)) {
+      if (b != end && changed[c].netId == b->netId) ++b;
+      entities.push_back(changed[c++]);
+      continue;
+    }
+    const EntityState &kept = *b++;
+    while (r < applied.removed.size() && applied.removed[r] < kept.netId) ++r;
+    if (r < applied.removed.size() && applied.removed[r] == kept.netId) continue;
+    entities.push_back(kept);
+  }
+  return true;
+}
+
+/**
+ * Rebuild the full snapshot from a single-chunk delta and its baseline.
+ * @param baseline the snapshot named in the header, nullptr if it is 0.
+ */
+inline bool decodeDelta(const std::string &payload, const Snapshot *baseline, Snapshot &out,
+                        AppliedDelta &applied) {
+  ChunkHeader header;
+  if (!decodeChunk(payload, baseline, header, out.entities, applied) || header.count != 1) {
+    return false;
+  }
+  out.sequence = header.sequence;
+  return true;
+}
+
+}  // namespace snapshot
+}  // namespace rtypeEngine
@@ -1,9 +1,25 @@
 #include <gtest/gtest.h>
 #include "../NetworkManager.hpp"
+#include "../EndpointTable.hpp"
+#include "../MessageRing.hpp"
+#include "../MmsgBatcher.hpp"
+#include "../ReliableChannel.hpp"
+#include "../SnapshotCodec.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <msgpack.hpp>
 #include <thread>
 #include <chrono>
+#include <map>
 #include <zmq.hpp>
 #include <iostream>
+#include <cstdlib>
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#endif
 
 // Helper to simulate the Game Engine / Bus
 class ZmqBusHelper {
@@ -167,6 +183,31 @@ TEST_F(NetworkManagerTest, EndToEndCommunication) {
     client.cleanup();
 }
 
+TEST_F(NetworkManagerTest, BusOnlyModuleKeepsNoPolledMessages) {
+    // As created by createModule(): received messages go to the bus only.
+    rtypeEngine::NetworkManager server("tcp://127.0.0.1:5630", "tcp://127.0.0.1:5631", false);
+    rtypeEngine::NetworkManager client("tcp://127.0.0.1:5632", "tcp://127.0.0.1:5633");
+
+    server.init();
+    client.init();
+
+    server.bind(4263);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    client.connect("127.0.0.1", 4263);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    for (int i = 0; i < 100; ++i) {
+        client.sendNetworkMessage("TestTopic", std::to_string(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    EXPECT_TRUE(server.getAllMessages().empty());
+    EXPECT_FALSE(server.getFirstMessage().has_value());
+
+    server.cleanup();
+    client.cleanup();
+}
+
 TEST_F(NetworkManagerTest, BinaryEndToEndCommunication) {
     rtypeEngine::NetworkManager server("tcp://127.0.0.1:5580", "tcp://127.0.0.1:5581");
     rtypeEngine::NetworkManager client("tcp://127.0.0.1:5582", "tcp://127.0.0.1:5583");
@@ -294,6 +335,601 @@ TEST_F(NetworkManagerTest, DisconnectCleansUpClients) {
     client.cleanup();
 }
 
+TEST_F(NetworkManagerTest, CoalescedMessagesArriveInOrder) {
+    rtypeEngine::NetworkManager server("tcp://127.0.0.1:5600", "tcp://127.0.0.1:5601");
+    rtypeEngine::NetworkManager client("tcp://127.0.0.1:5602", "tcp://127.0.0.1:5603");
+
+    server.init();
+    client.init();
+
+    server.bind(4260);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    client.connect("127.0.0.1", 4260);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    // Small messages share datagrams; a large one travels alone in between.
+    const int count = 60;
+    for (int i = 0; i < count; ++i) {
+        client.sendNetworkMessage("Seq", std::to_string(i));
+        if (i == count / 2) {
+            client.sendNetworkMessage("Big", std::string(4000, 'x'));
+        }
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    std::vector<int> received;
+    bool bigReceived = false;
+    for (const auto& msg : server.getAllMessages()) {
+        if (msg.topic == "Seq") received.push_back(std::stoi(msg.payload));
+        if (msg.topic == "Big") bigReceived = msg.payload.size() == 4000;
+    }
+    ASSERT_EQ(received.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+    EXPECT_TRUE(bigReceived);
+
+    server.cleanup();
+    client.cleanup();
+}
+
+TEST_F(NetworkManagerTest, ReliableChannelDeliversInOrder) {
+    rtypeEngine::NetworkManager server("tcp://127.0.0.1:5610", "tcp://127.0.0.1:5611");
+    rtypeEngine::NetworkManager client("tcp://127.0.0.1:5612", "tcp://127.0.0.1:5613");
+
+    server.init();
+    client.init();
+    client.setTopicChannel("Critical", rtypeEngine::channel::Delivery::Reliable);
+
+    server.bind(4261);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    client.connect("127.0.0.1", 4261);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    const int count = 40;
+    for (int i = 0; i < count; ++i) {
+        client.sendNetworkMessage("Critical", std::to_string(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+    std::vector<int> received;
+    for (const auto& msg : server.getAllMessages()) {
+        if (msg.topic == "Critical") received.push_back(std::stoi(msg.payload));
+    }
+    ASSERT_EQ(received.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+
+    server.cleanup();
+    client.cleanup();
+}
+
+#ifdef __linux__
+TEST_F(NetworkManagerTest, BatchedBackendEndToEnd) {
+    // The server reads the env flag on construction; the client stays on asio.
+    setenv("RTYPE_NET_BACKEND", "mmsg", 1);
+    rtypeEngine::NetworkManager server("tcp://127.0.0.1:5620", "tcp://127.0.0.1:5621");
+    unsetenv("RTYPE_NET_BACKEND");
+    rtypeEngine::NetworkManager client("tcp://127.0.0.1:5622", "tcp://127.0.0.1:5623");
+
+    server.init();
+    client.init();
+
+    server.bind(4262);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    client.connect("127.0.0.1", 4262);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    const int count = 100;
+    for (int i = 0; i < count; ++i) {
+        client.sendNetworkMessage("Up", std::to_string(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    std::vector<int> received;
+    for (const auto& msg : server.getAllMessages()) {
+        if (msg.topic == "Up") received.push_back(std::stoi(msg.payload));
+    }
+    ASSERT_EQ(received.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+
+    for (int i = 0; i < count; ++i) {
+        server.broadcast("Down", std::to_string(i));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    int down = 0;
+    for (const auto& msg : client.getAllMessages()) {
+        if (msg.topic == "Down") EXPECT_EQ(std::stoi(msg.payload), down++);
+    }
+    EXPECT_EQ(down, count);
+
+    server.cleanup();
+    client.cleanup();
+}
+#endif
+
+// --- Delivery channels ------------------------------------------------------
+
+namespace chan = rtypeEngine::channel;
+
+TEST(ReliableChannelTest, ReordersAndSkipsDuplicates) {
+    chan::Receiver receiver;
+    std::vector<std::string> delivered;
+    auto deliver = [&](const std::string &, const std::string &payload) { delivered.push_back(payload); };
+
+    EXPECT_TRUE(receiver.receiveReliable(7, 1, 2, "T", "b", deliver));
+    EXPECT_TRUE(delivered.empty());  // 1 is missing
+    EXPECT_TRUE(receiver.receiveReliable(7, 1, 3, "T", "c", deliver));
+    EXPECT_TRUE(receiver.receiveReliable(7, 1, 1, "T", "a", deliver));
+    EXPECT_EQ(delivered, (std::vector<std::string>{"a", "b", "c"}));
+    EXPECT_FALSE(receiver.receiveReliable(7, 1, 2, "T", "b", deliver));
+    EXPECT_EQ(delivered.size(), 3u);
+
+    ASSERT_TRUE(receiver.ackPending());
+    chan::Ack ack = receiver.takeAck();
+    EXPECT_EQ(ack.stream, 7u);
+    EXPECT_EQ(ack.delivered, 3u);
+    EXPECT_EQ(ack.newest, 3u);
+    EXPECT_EQ(ack.bits, 0x3u);
+    EXPECT_FALSE(receiver.ackPending());
+
+    // A new sender stream starts at its base, not at 1.
+    EXPECT_TRUE(receiver.receiveReliable(9, 40, 40, "T", "d", deliver));
+    EXPECT_EQ(delivered.back(), "d");
+}
+
+TEST(ReliableChannelTest, AckReleasesAndResendsTheRest) {
+    chan::Sender sender(5);
+    auto start = chan::Clock::now();
+    for (int i = 0; i < 4; ++i) {
+        sender.pushReliable("T", std::to_string(i), start);
+    }
+    EXPECT_EQ(sender.base(), 1u);
+
+    // 1 delivered in order, 4 received ahead of the lost 2 and 3.
+    chan::Ack ack{5, 1, 4, 0};
+    std::string wire = chan::encodeAck(ack);
+    chan::Ack decoded;
+    ASSERT_TRUE(chan::decodeAck(wire, decoded));
+    EXPECT_EQ(sender.onAck(decoded, start + std::chrono::milliseconds(20)), 2u);
+    EXPECT_EQ(sender.base(), 2u);
+    EXPECT_EQ(sender.onAck(chan::Ack{6, 4, 4, 0}, start), 0u);  // other stream
+
+    std::vector<uint32_t> resent;
+    auto collect = [&](uint32_t sequence, const chan::Sender::Pending &) { resent.push_back(sequence); };
+    EXPECT_EQ(sender.resendDue(start + std::chrono::milliseconds(25), collect), 0u);
+    EXPECT_EQ(sender.resendDue(start + std::chrono::seconds(2), collect), 2u);
+    EXPECT_EQ(resent, (std::vector<uint32_t>{2, 3}));
+}
+
+TEST(ReliableChannelTest, SequencedDropsStaleMessages) {
+    chan::Receiver receiver;
+    EXPECT_TRUE(receiver.acceptSequenced(3, "POS", "7 1 2 3", 2));
+    EXPECT_FALSE(receiver.acceptSequenced(3, "POS", "7 0 0 0", 1));
+    EXPECT_TRUE(receiver.acceptSequenced(3, "OTHER", "7 0 0 0", 1));
+    EXPECT_TRUE(receiver.acceptSequenced(3, "POS", "7 4 5 6", 5));
+    EXPECT_TRUE(receiver.acceptSequenced(4, "POS", "7 0 0 0", 1));  // sender restarted
+}
+
+TEST(ReliableChannelTest, SequencedKeysByEntity) {
+    chan::Receiver receiver;
+    // One sender counter: entity 2's update overtook entity 1's older one.
+    EXPECT_TRUE(receiver.acceptSequenced(3, "POS", "2 0 0 0", 6));
+    EXPECT_TRUE(receiver.acceptSequenced(3, "POS", "1 0 0 0", 5));
+    EXPECT_FALSE(receiver.acceptSequenced(3, "POS", "1 0 0 0", 4));
+    EXPECT_TRUE(receiver.acceptSequenced(3, "POS", "1", 7));  // no space: whole payload
+
+    // Keys idle for a full window are forgotten, so the table stays bounded.
+    uint32_t sequence = 8;
+    for (std::size_t i = 0; i < 2 * chan::MAX_SEQUENCED_KEYS; ++i) {
+        receiver.acceptSequenced(3, "POS", std::to_string(100 + i) + " 0", sequence++);
+    }
+    EXPECT_LE(receiver.sequencedKeyCount(), chan::MAX_SEQUENCED_KEYS + 1);
+}
+
+TEST(ReliableChannelTest, SenderWindowIsCapped) {
+    chan::Sender sender(5);
+    auto start = chan::Clock::now();
+    for (std::size_t i = 0; i < chan::MAX_PENDING; ++i) {
+        EXPECT_NE(sender.pushReliable("T", "x", start), 0u);
+    }
+    EXPECT_EQ(sender.pushReliable("T", "x", start), 0u);
+    EXPECT_EQ(sender.pendingCount(), chan::MAX_PENDING);
+
+    sender.onAck(chan::Ack{5, 1, 1, 0}, start);
+    EXPECT_EQ(sender.pushReliable("T", "x", start), chan::MAX_PENDING + 1);
+}
+
+// --- Io-thread handoff ring -------------------------------------------------
+
+struct RingMessage {
+    std::string topic;
+    std::string payload;
+};
+
+TEST(MessageRingTest, KeepsPerProducerOrder) {
+    rtypeEngine::MessageRing<RingMessage> ring(100);
+    EXPECT_EQ(ring.capacity(), 128u);
+
+    const int producers = 3;
+    const int count = 20000;
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&ring, p]() {
+            for (int i = 0; i < count; ++i) {
+                while (!ring.tryPush([&](RingMessage &slot) {
+                    slot.topic = std::to_string(p);
+                    slot.payload = std::to_string(i);
+                })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    bool ordered = true;
+    while (received < producers * count) {
+        ring.tryPop([&](RingMessage &slot) {
+            int &expected = next[std::stoi(slot.topic)];
+            ordered = ordered && std::stoi(slot.payload) == expected;
+            ++expected;
+            ++received;
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_FALSE(ring.tryPop([](RingMessage &) {}));
+}
+
+TEST(MessageRingTest, ShedTopicsGiveWayFirst) {
+    rtypeEngine::MessageRing<RingMessage> ring(8);
+    int accepted = 0;
+    for (int i = 0; i < 8; ++i) {
+        accepted += ring.tryPush([](RingMessage &) {}, rtypeEngine::DropPolicy::Shed) ? 1 : 0;
+    }
+    EXPECT_EQ(accepted, 4);  // refused once half full
+
+    accepted = 0;
+    for (int i = 0; i < 8; ++i) {
+        accepted += ring.tryPush([](RingMessage &) {}) ? 1 : 0;
+    }
+    EXPECT_EQ(accepted, 4);  // the rest of the ring is still there for kept topics
+    EXPECT_EQ(ring.size(), 8u);
+}
+
+#ifdef __linux__
+// --- Batched socket I/O -----------------------------------------------------
+
+TEST(MmsgBatcherTest, SendsAndReceivesInBatches) {
+    int receiver = socket(AF_INET, SOCK_DGRAM, 0);
+    int sender = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(receiver, 0);
+    ASSERT_GE(sender, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(bind(receiver, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    socklen_t addrLen = sizeof(addr);
+    getsockname(receiver, reinterpret_cast<sockaddr *>(&addr), &addrLen);
+
+    rtypeEngine::MmsgBatcher out(8, 1500);
+    const int count = 20;
+    for (int i = 0; i < count; ++i) {
+        std::string text = std::to_string(i);
+        out.queue(reinterpret_cast<sockaddr *>(&addr), addrLen,
+                  std::make_shared<std::vector<char>>(text.begin(), text.end()));
+    }
+    auto result = out.flush(sender);
+    EXPECT_EQ(result.sent, static_cast<size_t>(count));
+    EXPECT_EQ(result.calls, 3u);  // 8 + 8 + 4
+    EXPECT_FALSE(out.pending());
+
+    rtypeEngine::MmsgBatcher in(8, 1500);
+    std::vector<int> received;
+    for (int attempt = 0; attempt < 100 && received.size() < static_cast<size_t>(count); ++attempt) {
+        int got = in.receive(receiver, [&](const char *data, size_t size, const sockaddr *, socklen_t) {
+            received.push_back(std::stoi(std::string(data, size)));
+        });
+        ASSERT_GE(got, 0);
+        if (got == 0) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ASSERT_EQ(received.size(), static_cast<size_t>(count));
+    for (int i = 0; i < count; ++i) {
+        EXPECT_EQ(received[i], i);
+    }
+
+    close(sender);
+    close(receiver);
+}
+#endif
+
+// --- Client lookup ----------------------------------------------------------
+
+TEST(EndpointTableTest, FindsKeysAcrossGrowth) {
+    rtypeEngine::EndpointTable table;
+    auto keyOf = [](uint32_t i) {
+        rtypeEngine::EndpointKey key;
+        key.low = 0xFFFF00000000ull | (0x7F000000u + (i % 7));
+        key.port = static_cast<uint16_t>(4000 + i);
+        return key;
+    };
+    for (uint32_t i = 1; i <= 500; ++i) {
+        ASSERT_EQ(table.find(keyOf(i)), 0u);
+        table.insert(keyOf(i), i);
+    }
+    EXPECT_EQ(table.size(), 500u);
+    for (uint32_t i = 1; i <= 500; ++i) {
+        EXPECT_EQ(table.find(keyOf(i)), i);
+    }
+    rtypeEngine::EndpointKey otherPort = keyOf(3);
+    otherPort.port = 9;
+    EXPECT_EQ(table.find(otherPort), 0u);
+
+    table.clear();
+    EXPECT_EQ(table.find(keyOf(3)), 0u);
+    EXPECT_EQ(table.size(), 0u);
+}
+
+// --- Snapshot delta codec ---------------------------------------------------
+
+namespace snap = rtypeEngine::snapshot;
+
+static snap::EntityState makeState(uint32_t netId, float x, float y, float vx) {
+    snap::EntityState state;
+    state.netId = netId;
+    state.fields[snap::Kind] = 1;
+    state.fields[snap::X] = snap::quantize(x, snap::X);
+    state.fields[snap::Y] = snap::quantize(y, snap::Y);
+    state.fields[snap::VX] = snap::quantize(vx, snap::VX);
+    return state;
+}
+
+static void expectSameEntities(const snap::Snapshot &a, const snap::Snapshot &b) {
+    ASSERT_EQ(a.entities.size(), b.entities.size());
+    for (size_t i = 0; i < a.entities.size(); ++i) {
+        EXPECT_EQ(a.entities[i].netId, b.entities[i].netId);
+        for (size_t f = 0; f < snap::FIELD_COUNT; ++f) {
+            EXPECT_EQ(a.entities[i].fields[f], b.entities[i].fields[f]);
+        }
+    }
+}
+
+TEST(SnapshotCodecTest, FullSnapshotRoundTrip) {
+    std::map<uint32_t, std::string> ids{{1, "player-1"}, {2, "enemy-2"}};
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    snap::Snapshot server;
+    server.sequence = 1;
+    server.entities = {makeState(1, -8.0f, 1.5f, 0.0f), makeState(2, 12.25f, -3.0f, -4.5f)};
+
+    std::string packet = snap::encodeDelta(server, nullptr, idOf);
+    uint32_t sequence = 0;
+    uint32_t baseline = 0;
+    ASSERT_TRUE(snap::readHeader(packet, sequence, baseline));
+    EXPECT_EQ(sequence, 1u);
+    EXPECT_EQ(baseline, 0u);
+
+    snap::Snapshot client;
+    snap::AppliedDelta applied;
+    ASSERT_TRUE(snap::decodeDelta(packet, nullptr, client, applied));
+    expectSameEntities(server, client);
+    ASSERT_EQ(applied.newIds.size(), 2u);
+    EXPECT_EQ(applied.newIds[1].second, "enemy-2");
+    EXPECT_FLOAT_EQ(snap::dequantize(client.find(2)->fields[snap::X], snap::X), 12.25f);
+}
+
+TEST(SnapshotCodecTest, DeltaCarriesOnlyChanges) {
+    std::map<uint32_t, std::string> ids{{1, "player-1"}, {2, "enemy-2"}, {3, "bullet-3"}};
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    snap::Snapshot first;
+    first.sequence = 1;
+    first.entities = {makeState(1, -8.0f, 0.0f, 0.0f), makeState(2, 10.0f, 2.0f, -3.0f)};
+    snap::Snapshot client1;
+    snap::AppliedDelta applied1;
+    ASSERT_TRUE(snap::decodeDelta(snap::encodeDelta(first, nullptr, idOf), nullptr, client1, applied1));
+
+    // Entity 1 unchanged, 2 moved, 3 spawned.
+    snap::Snapshot second;
+    second.sequence = 2;
+    second.entities = {makeState(1, -8.0f, 0.0f, 0.0f), makeState(2, 9.7f, 2.0f, -3.0f),
+                       makeState(3, -7.0f, 0.0f, 20.0f)};
+    std::string full = snap::encodeDelta(second, nullptr, idOf);
+    std::string delta = snap::encodeDelta(second, &first, idOf);
+    EXPECT_LT(delta.size(), full.size());
+
+    snap::Snapshot client2;
+    snap::AppliedDelta applied2;
+    ASSERT_TRUE(snap::decodeDelta(delta, &client1, client2, applied2));
+    expectSameEntities(second, client2);
+    EXPECT_EQ(applied2.changed, (std::vector<uint32_t>{2, 3}));
+    ASSERT_EQ(applied2.newIds.size(), 1u);
+    EXPECT_EQ(applied2.newIds[0].second, "bullet-3");
+    EXPECT_TRUE(applied2.removed.empty());
+}
+
+TEST(SnapshotCodecTest, DeltaRoundTripsInt32Extremes) {
+    std::map<uint32_t, std::string> ids{{1, "extreme-1"}};
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    const int32_t values[] = {INT32_MIN, INT32_MAX, 0, -1, INT32_MIN + 1, INT32_MAX - 1};
+    snap::Snapshot previous;
+    snap::Snapshot client;
+    uint32_t sequence = 0;
+    for (int32_t before : values) {
+        for (int32_t after : values) {
+            snap::Snapshot base;
+            base.sequence = ++sequence;
+            base.entities.resize(1);
+            base.entities[0].netId = 1;
+            std::fill(std::begin(base.entities[0].fields), std::end(base.entities[0].fields), before);
+            snap::AppliedDelta appliedBase;
+            ASSERT_TRUE(snap::decodeDelta(snap::encodeDelta(base, nullptr, idOf), nullptr, client, appliedBase));
+            expectSameEntities(base, client);
+
+            snap::Snapshot next = base;
+            next.sequence = ++sequence;
+            std::fill(std::begin(next.entities[0].fields), std::end(next.entities[0].fields), after);
+            snap::Snapshot decoded;
+            snap::AppliedDelta applied;
+            ASSERT_TRUE(snap::decodeDelta(snap::encodeDelta(next, &base, idOf), &client, decoded, applied));
+            expectSameEntities(next, decoded);
+        }
+    }
+    EXPECT_EQ(snap::unzigzag(snap::zigzag(INT32_MIN)), INT32_MIN);
+    EXPECT_EQ(snap::unzigzag(snap::zigzag(INT32_MAX)), INT32_MAX);
+    EXPECT_EQ(snap::zigzag(snap::wrappingDelta(INT32_MAX, INT32_MIN)), 1u);  // wraps to -1
+}
+
+TEST(SnapshotCodecTest, DeltaReportsRemovals) {
+    std::map<uint32_t, std::string> ids{{4, "a"}, {9, "b"}, {11, "c"}};
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    snap::Snapshot before;
+    before.sequence = 5;
+    before.entities = {makeState(4, 1.0f, 1.0f, 0.0f), makeState(9, 2.0f, 2.0f, 0.0f),
+                       makeState(11, 3.0f, 3.0f, 0.0f)};
+    snap::Snapshot after;
+    after.sequence = 6;
+    after.entities = {makeState(9, 2.0f, 2.0f, 0.0f)};
+
+    snap::Snapshot client;
+    snap::AppliedDelta applied;
+    ASSERT_TRUE(snap::decodeDelta(snap::encodeDelta(after, &before, idOf), &before, client, applied));
+    expectSameEntities(after, client);
+    EXPECT_EQ(applied.removed, (std::vector<uint32_t>{4, 11}));
+    EXPECT_TRUE(applied.changed.empty());
+}
+
+TEST(SnapshotCodecTest, RejectsWrongBaselineAndTruncation) {
+    std::map<uint32_t, std::string> ids{{1, "player-1"}};
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    snap::Snapshot first;
+    first.sequence = 1;
+    first.entities = {makeState(1, 0.0f, 0.0f, 0.0f)};
+    snap::Snapshot second;
+    second.sequence = 2;
+    second.entities = {makeState(1, 5.0f, 0.0f, 1.0f)};
+    std::string delta = snap::encodeDelta(second, &first, idOf);
+
+    snap::Snapshot out;
+    snap::AppliedDelta applied;
+    EXPECT_FALSE(snap::decodeDelta(delta, nullptr, out, applied));
+    EXPECT_FALSE(snap::decodeDelta(delta.substr(0, delta.size() - 2), &first, out, applied));
+}
+
+TEST(SnapshotCodecTest, FullSnapshotChunksFitTheMtu) {
+    // Entity ids are UUIDs, the worst case for a client without a baseline.
+    constexpr size_t MTU = 1200;  // RTYPE_NET_MTU default
+    std::map<uint32_t, std::string> ids;
+    snap::Snapshot server;
+    server.sequence = 7;
+    for (uint32_t netId = 1; netId <= 600; ++netId) {
+        char uuid[37];
+        std::snprintf(uuid, sizeof(uuid), "%08x-0000-4000-8000-%012x", netId * 2654435761u, netId);
+        ids[netId] = uuid;
+        snap::EntityState state = makeState(netId, netId * 0.37f - 50.0f, netId * -0.11f, 3.5f);
+        for (size_t f = snap::Z; f < snap::FIELD_COUNT; ++f) {
+            state.fields[f] = static_cast<int32_t>(netId * 7919u % 20000u) - 10000;
+        }
+        server.entities.push_back(state);
+    }
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    std::vector<std::string> chunks =
+        snap::encodeChunks(server, nullptr, idOf, MTU - snap::ENVELOPE_OVERHEAD);
+    ASSERT_GE(chunks.size(), 20u);
+
+    // Every chunk decodes alone, whatever order they arrive in.
+    std::reverse(chunks.begin(), chunks.end());
+    std::map<uint32_t, snap::EntityState> client;
+    uint32_t nextFirst = UINT32_MAX;
+    for (const std::string &chunk : chunks) {
+        msgpack::sbuffer datagram;
+        msgpack::packer<msgpack::sbuffer> packer(datagram);
+        packer.pack_array(2);
+        packer.pack(std::string("_snapshot"));
+        packer.pack(chunk);
+        EXPECT_LE(datagram.size(), MTU);
+
+        snap::ChunkHeader header;
+        std::vector<snap::EntityState> entities;
+        snap::AppliedDelta applied;
+        ASSERT_TRUE(snap::decodeChunk(chunk, nullptr, header, entities, applied));
+        EXPECT_EQ(header.sequence, 7u);
+        EXPECT_EQ(header.count, chunks.size());
+        EXPECT_EQ(applied.newIds.size(), entities.size());
+        if (nextFirst != UINT32_MAX) {
+            EXPECT_EQ(header.last + 1, nextFirst);  // ranges are consecutive
+        }
+        nextFirst = header.first;
+        for (const snap::EntityState &state : entities) {
+            EXPECT_TRUE(state.netId >= header.first && state.netId <= header.last);
+            client[state.netId] = state;
+        }
+    }
+    EXPECT_EQ(nextFirst, 0u);
+
+    snap::Snapshot assembled;
+    for (const auto &entry : client) {
+        assembled.entities.push_back(entry.second);
+    }
+    expectSameEntities(server, assembled);
+}
+
+TEST(SnapshotCodecTest, DeltaChunksApplyRemovalsPerRange) {
+    std::map<uint32_t, std::string> ids;
+    snap::Snapshot before;
+    before.sequence = 1;
+    for (uint32_t netId = 1; netId <= 300; ++netId) {
+        ids[netId] = "entity-" + std::to_string(netId);
+        before.entities.push_back(makeState(netId, static_cast<float>(netId), 0.0f, 0.0f));
+    }
+    auto idOf = [&](uint32_t netId) -> const std::string & { return ids[netId]; };
+
+    // Every third entity gone, every other one moved.
+    snap::Snapshot after;
+    after.sequence = 2;
+    for (const snap::EntityState &state : before.entities) {
+        if (state.netId % 3 == 0) continue;
+        snap::EntityState moved = state;
+        if (state.netId % 2 == 0) moved.fields[snap::Y] += 250;
+        after.entities.push_back(moved);
+    }
+
+    std::vector<std::string> chunks = snap::encodeChunks(after, &before, idOf, 200);
+    ASSERT_GE(chunks.size(), 2u);
+    snap::Snapshot assembled;
+    size_t removed = 0;
+    for (const std::string &chunk : chunks) {
+        EXPECT_LE(chunk.size(), 200u);
+        snap::ChunkHeader header;
+        std::vector<snap::EntityState> entities;
+        snap::AppliedDelta applied;
+        ASSERT_TRUE(snap::decodeChunk(chunk, &before, header, entities, applied));
+        EXPECT_TRUE(applied.newIds.empty());
+        removed += applied.removed.size();
+        assembled.entities.insert(assembled.entities.end(), entities.begin(), entities.end());
+    }
+    EXPECT_EQ(removed, 100u);
+    expectSameEntities(after, assembled);
+
+    // A chunk is tied to its baseline like a whole delta.
+    snap::ChunkHeader header;
+    std::vector<snap::EntityState> entities;
+    snap::AppliedDelta applied;
+    EXPECT_FALSE(snap::decodeChunk(chunks[0], nullptr, header, entities, applied));
+}
+
 /*
 TEST_F(NetworkManagerTest, Aggressive_MalformedUdpPacket) {
     // ... kept commented out as requested to keep build green but show intent ...
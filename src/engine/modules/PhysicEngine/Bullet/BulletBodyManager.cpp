@@ -2,6 +2,7 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <new>
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -16,60 +17,129 @@ namespace rtypeEngine {
         clear();
     }
 
+    bool BulletBodyManager::ShapeKey::operator<(const ShapeKey& other) const {
+        if (type != other.type) return type < other.type;
+        return std::lexicographical_compare(dimensions, dimensions + 3, other.dimensions, other.dimensions + 3);
+    }
+
+    BulletSharedShape* BulletBodyManager::acquireShape(const ShapeKey& key) {
+        BulletSharedShape& cached = _shapes[key];
+        if (cached.shape) {
+            if (cached.users == 0) --_idleShapes;
+            ++_stats.shapesShared;
+        } else if (key.type == BulletShapeType::Box) {
+            cached.shape = new btBoxShape(btVector3(key.dimensions[0], key.dimensions[1], key.dimensions[2]));
+            ++_stats.shapesAllocated;
+        } else {
+            cached.shape = new btSphereShape(key.dimensions[0]);
+            ++_stats.shapesAllocated;
+        }
+        ++cached.users;
+        return &cached;
+    }
+
+    void BulletBodyManager::releaseShape(BulletSharedShape* shape) {
+        if (--shape->users > 0 || ++_idleShapes <= MAX_IDLE_SHAPES) return;
+        for (auto it = _shapes.begin(); it != _shapes.end();) {
+            if (it->second.users == 0) {
+                delete it->second.shape;
+                it = _shapes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _idleShapes = 0;
+    }
+
+    BulletBodyStorage* BulletBodyManager::allocateStorage() {
+        if (!_freeStorage.empty()) {
+            BulletBodyStorage* storage = _freeStorage.back();
+            _freeStorage.pop_back();
+            ++_stats.bodiesRecycled;
+            return storage;
+        }
+        if (_storageBlocks.empty() || _blockUsed == BODY_BLOCK) {
+            _storageBlocks.emplace_back(new BulletBodyStorage[BODY_BLOCK]);
+            _blockUsed = 0;
+            ++_stats.bodyBlocks;
+        }
+        return &_storageBlocks.back()[_blockUsed++];
+    }
+
+    void BulletBodyManager::deleteBody(BulletBody& entry) {
+        _dynamicsWorld->removeRigidBody(entry.body);
+        btMotionState* motionState = entry.body->getMotionState();
+        entry.body->~btRigidBody();
+        motionState->~btMotionState();
+        _freeStorage.push_back(entry.storage);
+        releaseShape(entry.shape);
+    }
+
     void BulletBodyManager::clear() {
-        for (auto& pair : _bodies) {
-            _dynamicsWorld->removeRigidBody(pair.second);
-            delete pair.second->getMotionState();
-            delete pair.second->getCollisionShape();
-            delete pair.second;
+        for (BulletBody& entry : _bodies) {
+            deleteBody(entry);
         }
         _bodies.clear();
-        _bodyIds.clear();
+        _indices.clear();
+        for (auto& pair : _shapes) {
+            delete pair.second.shape;
+        }
+        _shapes.clear();
+        _idleShapes = 0;
     }
 
     void BulletBodyManager::destroyBody(const std::string& id) {
-        auto it = _bodies.find(id);
-        if (it != _bodies.end()) {
-            btRigidBody* body = it->second;
-            _dynamicsWorld->removeRigidBody(body);
-            delete body->getMotionState();
-            delete body->getCollisionShape();
-            delete body;
-            _bodyIds.erase(body);
-            _bodies.erase(it);
+        auto it = _indices.find(id);
+        if (it == _indices.end()) return;
+        const int index = it->second;
+        _indices.erase(it);
+        deleteBody(_bodies[index]);
+
+        const int last = static_cast<int>(_bodies.size()) - 1;
+        if (index != last) {
+            _bodies[index] = std::move(_bodies[last]);
+            _bodies[index].body->setUserIndex(index);
+            _indices[_bodies[index].id] = index;
         }
+        _bodies.pop_back();
+    }
+
+    BulletBody* BulletBodyManager::find(const std::string& id) {
+        auto it = _indices.find(id);
+        return it != _indices.end() ? &_bodies[it->second] : nullptr;
     }
 
     btRigidBody* BulletBodyManager::getBody(const std::string& id) {
-        auto it = _bodies.find(id);
-        if (it != _bodies.end()) return it->second;
-        return nullptr;
+        BulletBody* entry = find(id);
+        return entry ? entry->body : nullptr;
     }
 
-    std::string BulletBodyManager::getBodyId(btRigidBody* body) {
-        auto it = _bodyIds.find(body);
-        if (it != _bodyIds.end()) return it->second;
-        return "";
+    const std::string& BulletBodyManager::getBodyId(const btCollisionObject* body) const {
+        static const std::string none;
+        if (!body) return none;
+        const int index = body->getUserIndex();
+        if (index < 0 || index >= static_cast<int>(_bodies.size()) || _bodies[index].body != body) return none;
+        return _bodies[index].id;
     }
 
     bool BulletBodyManager::hasBody(const std::string& id) const {
-        return _bodies.find(id) != _bodies.end();
+        return _indices.find(id) != _indices.end();
     }
 
     void BulletBodyManager::createBody(const std::string& id, const std::string& type, const std::vector<float>& params) {
-        btCollisionShape* shape = nullptr;
         btScalar mass(1.f);
         btScalar friction(0.5f);
 
         std::string typeLower = type;
         std::transform(typeLower.begin(), typeLower.end(), typeLower.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
 
+        ShapeKey key{BulletShapeType::Box, {0.f, 0.f, 0.f}};
         if (typeLower == "box" && params.size() >= 3) {
-            shape = new btBoxShape(btVector3(params[0], params[1], params[2]));
+            key = {BulletShapeType::Box, {params[0], params[1], params[2]}};
             if (params.size() >= 4) mass = params[3];
             if (params.size() >= 5) friction = params[4];
         } else if (typeLower == "sphere" && params.size() >= 1) {
-            shape = new btSphereShape(params[0]);
+            key = {BulletShapeType::Sphere, {params[0], 0.f, 0.f}};
             if (params.size() >= 2) mass = params[1];
             if (params.size() >= 3) friction = params[2];
         } else {
@@ -77,10 +147,9 @@ namespace rtypeEngine {
             return;
         }
 
-        if (!shape) {
-            std::cerr << "[Bullet] ERROR: CreateBody failed to create shape for '" << id << "'" << std::endl;
-            return;
-        }
+        // A second CreateBody for an id replaces its body.
+        destroyBody(id);
+        BulletSharedShape* shape = acquireShape(key);
 
         btTransform startTransform;
         startTransform.setIdentity();
@@ -89,30 +158,33 @@ namespace rtypeEngine {
         bool isDynamic = (mass != 0.f);
         btVector3 localInertia(0, 0, 0);
         if (isDynamic) {
-            shape->calculateLocalInertia(mass, localInertia);
+            shape->shape->calculateLocalInertia(mass, localInertia);
         }
 
-        btDefaultMotionState* myMotionState = new btDefaultMotionState(startTransform);
-        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, myMotionState, shape, localInertia);
+        BulletBodyStorage* storage = allocateStorage();
+        btDefaultMotionState* myMotionState = new (storage->motionState) btDefaultMotionState(startTransform);
+        btRigidBody::btRigidBodyConstructionInfo rbInfo(mass, myMotionState, shape->shape, localInertia);
         rbInfo.m_friction = friction;
-        btRigidBody* body = new btRigidBody(rbInfo);
+        btRigidBody* body = new (storage->body) btRigidBody(rbInfo);
+        ++_stats.bodiesCreated;
 
+        const int index = static_cast<int>(_bodies.size());
+        body->setUserIndex(index);
         _dynamicsWorld->addRigidBody(body);
-        _bodies[id] = body;
-        _bodyIds[body] = id;
-        std::cout << "[Bullet] Created Body for ID: " << id << " (Mass: " << mass << ", Friction: " << friction << ")" << std::endl;
+        _bodies.push_back({id, body, storage, shape});
+        _indices[id] = index;
     }
 
     void BulletBodyManager::applyForce(const std::string& id, const std::vector<float>& force) {
-        if (_bodies.find(id) != _bodies.end()) {
-            _bodies[id]->activate(true);
-            _bodies[id]->applyCentralForce(btVector3(force[0], force[1], force[2]));
+        if (btRigidBody* body = getBody(id)) {
+            body->activate(true);
+            body->applyCentralForce(btVector3(force[0], force[1], force[2]));
         }
     }
 
     void BulletBodyManager::setTransform(const std::string& id, const std::vector<float>& pos, const std::vector<float>& rot) {
-        if (_bodies.find(id) != _bodies.end()) {
-            btRigidBody* body = _bodies[id];
+        if (BulletBody* entry = find(id)) {
+            btRigidBody* body = entry->body;
             btTransform trans;
             trans.setIdentity();
             trans.setOrigin(btVector3(pos[0], pos[1], pos[2]));
@@ -127,30 +199,32 @@ namespace rtypeEngine {
                 body->getMotionState()->setWorldTransform(trans);
             }
             body->activate(true);
+            entry->published = false; // static bodies are not compared again otherwise
         }
     }
 
     void BulletBodyManager::setLinearVelocity(const std::string& id, const std::vector<float>& vel) {
-        if (_bodies.find(id) == _bodies.end()) {
+        btRigidBody* body = getBody(id);
+        if (!body) {
             std::cerr << "[Bullet] ERROR: SetLinearVelocity failed. Entity ID '" << id << "' does not exist in Physics World." << std::endl;
             return;
         }
-        _bodies[id]->activate(true);
-        _bodies[id]->setLinearVelocity(btVector3(vel[0], vel[1], vel[2]));
+        body->activate(true);
+        body->setLinearVelocity(btVector3(vel[0], vel[1], vel[2]));
     }
 
     void BulletBodyManager::setAngularVelocity(const std::string& id, const std::vector<float>& vel) {
-        if (_bodies.find(id) == _bodies.end()) {
+        btRigidBody* body = getBody(id);
+        if (!body) {
             std::cerr << "[Bullet] ERROR: SetAngularVelocity failed. Entity ID '" << id << "' does not exist in Physics World." << std::endl;
             return;
         }
-        _bodies[id]->activate(true);
-        _bodies[id]->setAngularVelocity(btVector3(vel[0], vel[1], vel[2]));
+        body->activate(true);
+        body->setAngularVelocity(btVector3(vel[0], vel[1], vel[2]));
     }
 
     void BulletBodyManager::setMass(const std::string& id, float mass) {
-        if (_bodies.find(id) != _bodies.end()) {
-            btRigidBody* body = _bodies[id];
+        if (btRigidBody* body = getBody(id)) {
             btVector3 localInertia(0, 0, 0);
             if (mass != 0.f) {
                 body->getCollisionShape()->calculateLocalInertia(mass, localInertia);
@@ -162,15 +236,14 @@ namespace rtypeEngine {
     }
 
     void BulletBodyManager::setFriction(const std::string& id, float friction) {
-        if (_bodies.find(id) != _bodies.end()) {
-            _bodies[id]->setFriction(friction);
-            _bodies[id]->activate(true);
+        if (btRigidBody* body = getBody(id)) {
+            body->setFriction(friction);
+            body->activate(true);
         }
     }
 
     void BulletBodyManager::setVelocityXZ(const std::string& id, float vx, float vz) {
-        if (_bodies.find(id) != _bodies.end()) {
-            btRigidBody* body = _bodies[id];
+        if (btRigidBody* body = getBody(id)) {
             body->activate(true);
             btVector3 vel = body->getLinearVelocity();
             vel.setX(vx);
@@ -180,16 +253,16 @@ namespace rtypeEngine {
     }
 
     void BulletBodyManager::applyImpulse(const std::string& id, const std::vector<float>& impulse) {
-        if (_bodies.find(id) != _bodies.end()) {
-            _bodies[id]->activate(true);
-            _bodies[id]->applyCentralImpulse(btVector3(impulse[0], impulse[1], impulse[2]));
+        if (btRigidBody* body = getBody(id)) {
+            body->activate(true);
+            body->applyCentralImpulse(btVector3(impulse[0], impulse[1], impulse[2]));
         }
     }
 
     void BulletBodyManager::setAngularFactor(const std::string& id, const std::vector<float>& factor) {
-        if (_bodies.find(id) != _bodies.end()) {
-            _bodies[id]->activate(true);
-            _bodies[id]->setAngularFactor(btVector3(factor[0], factor[1], factor[2]));
+        if (btRigidBody* body = getBody(id)) {
+            body->activate(true);
+            body->setAngularFactor(btVector3(factor[0], factor[1], factor[2]));
         }
     }
 
@@ -1,11 +1,49 @@
 #pragma once
 
 #include <btBulletDynamicsCommon.h>
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace rtypeEngine {
+    /// Storage for one body and its motion state, recycled by BulletBodyManager.
+    struct BulletBodyStorage {
+        alignas(btRigidBody) unsigned char body[sizeof(btRigidBody)];
+        alignas(btDefaultMotionState) unsigned char motionState[sizeof(btDefaultMotionState)];
+    };
+
+    enum class BulletShapeType : uint8_t { Box, Sphere };
+
+    /// A collision shape shared by every body with the same type and dimensions.
+    struct BulletSharedShape {
+        btCollisionShape* shape = nullptr;
+        int users = 0;
+    };
+
+    /// Cumulative since the manager was created.
+    struct BulletAllocationStats {
+        uint64_t bodiesCreated = 0;
+        uint64_t bodiesRecycled = 0;  // placed in storage freed by an earlier body
+        uint64_t bodyBlocks = 0;      // heap allocations of BODY_BLOCK storages
+        uint64_t shapesAllocated = 0;
+        uint64_t shapesShared = 0;    // bodies given an already cached shape
+    };
+
+    /// One live body. The btRigidBody's user index is its position in the registry.
+    struct BulletBody {
+        std::string id;
+        btRigidBody* body = nullptr;
+        BulletBodyStorage* storage = nullptr;
+        BulletSharedShape* shape = nullptr;
+
+        // Owned by BulletPhysicEngine::sendUpdates: transform as last published.
+        bool published = false;
+        float publishedValues[6] = {}; // x,y,z,pitch,yaw,roll
+    };
+
     class BulletBodyManager {
     public:
         BulletBodyManager(btDiscreteDynamicsWorld* world);
@@ -16,10 +54,15 @@ namespace rtypeEngine {
         void clear();
 
         btRigidBody* getBody(const std::string& id);
-        std::string getBodyId(btRigidBody* body);
+        /// Id of a registered body (read from its user index), or an empty string.
+        const std::string& getBodyId(const btCollisionObject* body) const;
         bool hasBody(const std::string& id) const;
 
-        const std::map<std::string, btRigidBody*>& getBodies() const { return _bodies; }
+        const BulletAllocationStats& allocationStats() const { return _stats; }
+
+        /// Densely packed; destroying a body moves the last one into its place.
+        std::vector<BulletBody>& getBodies() { return _bodies; }
+        const std::vector<BulletBody>& getBodies() const { return _bodies; }
 
         void applyForce(const std::string& id, const std::vector<float>& force);
         void setTransform(const std::string& id, const std::vector<float>& pos, const std::vector<float>& rot);
@@ -31,9 +74,33 @@ namespace rtypeEngine {
         void applyImpulse(const std::string& id, const std::vector<float>& impulse);
         void setAngularFactor(const std::string& id, const std::vector<float>& factor);
 
+        static constexpr size_t BODY_BLOCK = 64;
+        static constexpr size_t MAX_IDLE_SHAPES = 64;
+
     private:
+        struct ShapeKey {
+            BulletShapeType type;
+            float dimensions[3]; // box half extents, or sphere radius first
+
+            bool operator<(const ShapeKey& other) const;
+        };
+
+        BulletBody* find(const std::string& id);
+        void deleteBody(BulletBody& entry);
+        BulletSharedShape* acquireShape(const ShapeKey& key);
+        void releaseShape(BulletSharedShape* shape);
+        BulletBodyStorage* allocateStorage();
+
         btDiscreteDynamicsWorld* _dynamicsWorld; // Weak reference
-        std::map<std::string, btRigidBody*> _bodies;
-        std::map<btRigidBody*, std::string> _bodyIds;
+        std::vector<BulletBody> _bodies;
+        std::unordered_map<std::string, int> _indices; // id -> index in _bodies
+
+        // Shapes stay cached while unused, up to MAX_IDLE_SHAPES of them.
+        std::map<ShapeKey, BulletSharedShape> _shapes;
+        size_t _idleShapes = 0;
+        std::vector<std::unique_ptr<BulletBodyStorage[]>> _storageBlocks;
+        size_t _blockUsed = 0; // storages handed out from the newest block
+        std::vector<BulletBodyStorage*> _freeStorage;
+        BulletAllocationStats _stats;
     };
 }
@@ -1,4 +1,7 @@
 #include "BulletPhysicEngine.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <iostream>
 #include <sstream>
 #include <vector>
@@ -18,6 +21,13 @@ static float safeStof(const std::string &str, float fallback = 0.0f) {
         return fallback;
     }
 }
+static float envEpsilon(const char *name, float fallback) {
+    const char *value = std::getenv(name);
+    if (value == nullptr || value[0] == '\0') return fallback;
+    char *end = nullptr;
+    float parsed = std::strtof(value, &end);
+    return (end != nullptr && *end == '\0' && parsed >= 0.0f) ? parsed : fallback;
+}
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -27,7 +37,10 @@ namespace rtypeEngine {
 BulletPhysicEngine::BulletPhysicEngine(const char* pubEndpoint, const char* subEndpoint)
     : IPhysicEngine(pubEndpoint, subEndpoint),
       _bulletWorld(nullptr),
-      _bodyManager(nullptr) {}
+      _bodyManager(nullptr) {
+    _positionEpsilon = envEpsilon("RTYPE_PHYSICS_POS_EPSILON", _positionEpsilon);
+    _rotationEpsilon = envEpsilon("RTYPE_PHYSICS_ROT_EPSILON", _rotationEpsilon);
+}
 
 void BulletPhysicEngine::init() {
     _bulletWorld = new BulletWorld();
@@ -49,9 +62,17 @@ void BulletPhysicEngine::cleanup() {
 }
 
 void BulletPhysicEngine::loop() {
-    static int heartbeat = 0;
-    if (++heartbeat % 60 == 0 && _bodyManager) {
-        std::cout << "[Bullet] Heartbeat - Loop Running. Bodies tracked: " << _bodyManager->getBodies().size() << std::endl;
+    if (++_heartbeatLoops >= HEARTBEAT_LOOPS && _bodyManager) {
+        std::cout << "[Bullet] Heartbeat - Loop Running. Bodies tracked: " << _bodyManager->getBodies().size()
+                  << ", step " << _stepSequence << ", published " << _bodiesPublished << "/" << _bodiesTracked
+                  << " body updates since last heartbeat" << std::endl;
+        const BulletAllocationStats& alloc = _bodyManager->allocationStats();
+        std::cout << "[Bullet] Allocations - bodies created: " << alloc.bodiesCreated << " (" << alloc.bodiesRecycled
+                  << " in recycled storage, " << alloc.bodyBlocks << " blocks of " << BulletBodyManager::BODY_BLOCK
+                  << "), shapes allocated: " << alloc.shapesAllocated << " (" << alloc.shapesShared << " reuses)" << std::endl;
+        _heartbeatLoops = 0;
+        _bodiesPublished = 0;
+        _bodiesTracked = 0;
     }
 
     stepSimulation();
@@ -81,6 +102,8 @@ void BulletPhysicEngine::stepSimulation() {
         // This mirrors _dynamicsWorld->stepSimulation(fixedTimeStep, 10).
         _bulletWorld->step(fixedTimeStep, 10);
         _timeAccumulator -= fixedTimeStep;
+        ++_stepSequence;
+        ++_unpublishedSteps;
     }
 }
 
@@ -106,8 +129,8 @@ void BulletPhysicEngine::checkCollisions() {
                 const btRigidBody* bodyB = btRigidBody::upcast(obB);
 
                 if (bodyA && bodyB) {
-                    std::string idA = _bodyManager->getBodyId(const_cast<btRigidBody*>(bodyA));
-                    std::string idB = _bodyManager->getBodyId(const_cast<btRigidBody*>(bodyB));
+                    const std::string& idA = _bodyManager->getBodyId(bodyA);
+                    const std::string& idB = _bodyManager->getBodyId(bodyB);
 
                     if (!idA.empty() && !idB.empty()) {
                         std::stringstream ss;
@@ -122,38 +145,107 @@ void BulletPhysicEngine::checkCollisions() {
     }
 }
 
+bool BulletPhysicEngine::takeChangedTransform(BulletBody& entry, float values[6]) {
+    btRigidBody* body = entry.body;
+    // Nothing moves a sleeping or static body but a SetTransform, which clears `published`.
+    if (entry.published && (!body->isActive() || body->isStaticObject())) return false;
+
+    btTransform trans;
+    body->getMotionState()->getWorldTransform(trans);
+    const btVector3& pos = trans.getOrigin();
+    btScalar yaw, pitch, roll;
+    trans.getBasis().getEulerYPR(yaw, pitch, roll);
+    values[0] = static_cast<float>(pos.x());
+    values[1] = static_cast<float>(pos.y());
+    values[2] = static_cast<float>(pos.z());
+    values[3] = static_cast<float>(pitch);
+    values[4] = static_cast<float>(yaw);
+    values[5] = static_cast<float>(roll);
+
+    if (entry.published) {
+        bool changed = false;
+        for (int i = 0; i < 6 && !changed; ++i) {
+            const float epsilon = i < 3 ? _positionEpsilon : _rotationEpsilon;
+            changed = std::fabs(values[i] - entry.publishedValues[i]) > epsilon;
+        }
+        if (!changed) return false;
+    }
+    entry.published = true;
+    std::copy(values, values + 6, entry.publishedValues);
+    return true;
+}
+
 void BulletPhysicEngine::sendUpdates() {
+    if (!_bodyManager || _unpublishedSteps == 0) return;
+    _unpublishedSteps = 0;
+
+    const bool text = busCodec::textFallbackEnabled();
+    auto& bodies = _bodyManager->getBodies();
     std::stringstream batchStream;
-    bool hasUpdates = false;
-
-    if (!_bodyManager) return;
-    const auto& bodies = _bodyManager->getBodies();
-
-    for (auto& pair : bodies) {
-        btTransform trans;
-        if (pair.second && pair.second->getMotionState()) {
-            pair.second->getMotionState()->getWorldTransform(trans);
-            btVector3 pos = trans.getOrigin();
-
-            btScalar yaw, pitch, roll;
-            trans.getBasis().getEulerYPR(yaw, pitch, roll);
-
-            batchStream << "EntityUpdated:" << pair.first << ":"
-               << pos.x() << "," << pos.y() << "," << pos.z() << ":"
-               << pitch << "," << yaw << "," << roll << ";";
-            
-            hasUpdates = true;
-        } else {
-            std::cout << "[Bullet] DEBUG: Missing MotionState for body " << pair.first << std::endl;
+    size_t published = 0;
+    float values[6];
+    for (BulletBody& entry : bodies) {
+        if (!entry.body->getMotionState()) continue;
+        if (!takeChangedTransform(entry, values)) continue;
+
+        if (published++ == 0) {
+            if (text) {
+                batchStream << "PhysicsStep:" << _stepSequence << ";";
+            } else {
+                // Split in 16-bit halves so the sequence stays exact as floats.
+                const float step[2] = {static_cast<float>(_stepSequence & 0xFFFFu),
+                                       static_cast<float>(_stepSequence >> 16)};
+                _updateBatch.add(busCodec::Op::PhysicsStep, "step", step, 2);
+            }
+        }
+        if (text) {
+            batchStream << "EntityUpdated:" << entry.id << ":" << values[0] << "," << values[1] << "," << values[2]
+                        << ":" << values[3] << "," << values[4] << "," << values[5] << ";";
+        } else if (!_updateBatch.add(busCodec::Op::EntityUpdated, entry.id, values, 6)) {
+            // Ids that do not fit a fixed-size record still go out as text.
+            std::stringstream ss;
+            ss << "EntityUpdated:" << entry.id << ":" << values[0] << "," << values[1] << "," << values[2]
+               << ":" << values[3] << "," << values[4] << "," << values[5] << ";";
+            sendMessage("EntityUpdated", ss.str());
         }
     }
+    _bodiesTracked += bodies.size();
+    _bodiesPublished += published;
+
+    if (published == 0) return;
+    sendMessage("EntityUpdated", text ? batchStream.str() : _updateBatch.take());
+}
 
-    if (hasUpdates) {
-        sendMessage("EntityUpdated", batchStream.str());
+void BulletPhysicEngine::onBinaryPhysicCommand(const std::string& message) {
+    std::vector<float> values(3);
+    std::vector<float> rotation(3);
+    bool ok = busCodec::decode(message, [&](busCodec::Op op, const std::string& id, const float* v, uint16_t count) {
+        if (count < 3) return;
+        values.assign(v, v + 3);
+        switch (op) {
+            case busCodec::Op::SetLinearVelocity: setLinearVelocity(id, values); break;
+            case busCodec::Op::SetAngularVelocity: setAngularVelocity(id, values); break;
+            case busCodec::Op::ApplyForce: applyForce(id, values); break;
+            case busCodec::Op::ApplyImpulse: applyImpulse(id, values); break;
+            case busCodec::Op::SetTransform:
+                if (count >= 6) {
+                    rotation.assign(v + 3, v + 6);
+                    setTransform(id, values, rotation);
+                }
+                break;
+            default: break;
+        }
+    });
+    if (!ok) {
+        std::cerr << "[BulletPhysicEngine] Malformed binary PhysicCommand (" << message.size() << " bytes)" << std::endl;
     }
 }
 
 void BulletPhysicEngine::onPhysicCommand(const std::string& message) {
+    if (busCodec::isBinary(message)) {
+        onBinaryPhysicCommand(message);
+        return;
+    }
     try {
         std::stringstream ss(message);
         std::string segment;
@@ -399,7 +491,7 @@ void BulletPhysicEngine::raycast(const std::vector<float>& origin, const std::ve
     if (rayCallback.hasHit()) {
         const btRigidBody* body = btRigidBody::upcast(rayCallback.m_collisionObject);
         if (body) {
-            std::string id = _bodyManager->getBodyId(const_cast<btRigidBody*>(body));
+            const std::string& id = _bodyManager->getBodyId(body);
             if (!id.empty()) {
                 std::stringstream ss;
                 // RaycastHit:id:distance
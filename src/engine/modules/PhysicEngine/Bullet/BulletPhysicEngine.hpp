@@ -8,7 +8,7 @@
  * @section channels_sub Subscribed Channels
  * | Channel | Payload | Description |
  * |---------|---------|-------------|
- * | `PhysicCommand` | Command string | Physics commands (see formats below) |
+ * | `PhysicCommand` | Command string or busCodec batch | Physics commands (see formats below) |
  * 
  * @section physic_commands PhysicCommand Formats
  * - `CreateBody:id,mass,friction,fixedRotation,useGravity;` - Create rigid body
@@ -21,12 +21,28 @@
  * - `SetAngularFactor:id:x,y,z;` - Constrain rotation axes
  * - `SetMass:id,mass;` - Update body mass
  * - `SetFriction:id,friction;` - Update friction coefficient
+ *
+ * Binary busCodec batches (see types/busCodec.hpp) are accepted for
+ * SetLinearVelocity, SetAngularVelocity, ApplyForce, ApplyImpulse and
+ * SetTransform.
  * 
  * @section channels_pub Published Channels
  * | Channel | Payload | Description |
  * |---------|---------|-------------|
  * | `Collision` | "id1:id2" | Collision between two bodies |
- * | `PhysicUpdate` | Transform data | Body transform updates |
+ * | `EntityUpdated` | busCodec batch (text with `RTYPE_BUS_TEXT=1`) | Body transform updates |
+ *
+ * @section updates EntityUpdated Publishing
+ * Updates go out at most once per loop iteration, and only if at least one
+ * fixed step ran since the previous publish. Each body is compared with the
+ * transform it was last published with: it is sent again only once a
+ * position axis moved by more than `RTYPE_PHYSICS_POS_EPSILON` (default
+ * 1e-4) or a rotation axis by more than `RTYPE_PHYSICS_ROT_EPSILON` radians
+ * (default 1e-4). Sleeping and static bodies are not read at all after
+ * their first publish. A batch starts with a `PhysicsStep` record (text:
+ * `PhysicsStep:seq;`) carrying the number of fixed steps run so far; no
+ * batch is sent when no body changed. The heartbeat log reports how many
+ * body updates were published out of the bodies tracked.
  * 
  * @see docs/CHANNELS.md for complete channel reference
  */
@@ -40,6 +56,7 @@
 #include <vector>
 #include "BulletWorld.hpp"
 #include "BulletBodyManager.hpp"
+#include "../../../types/busCodec.hpp"
 
 namespace rtypeEngine {
 
@@ -68,12 +85,25 @@ class BulletPhysicEngine : public IPhysicEngine {
 
   private:
     void onPhysicCommand(const std::string& message);
+    void onBinaryPhysicCommand(const std::string& message);
     void stepSimulation();
     void sendUpdates();
+    bool takeChangedTransform(BulletBody& entry, float values[6]);
     void checkCollisions();
 
     BulletWorld* _bulletWorld;
     BulletBodyManager* _bodyManager;
+    busCodec::BatchWriter _updateBatch;
+    float _positionEpsilon = 1e-4f;
+    float _rotationEpsilon = 1e-4f;
+
+    uint32_t _stepSequence = 0;   // fixed steps run since init
+    uint32_t _unpublishedSteps = 0;
+    static constexpr uint32_t HEARTBEAT_LOOPS = 60;
+    // Since the last heartbeat
+    uint32_t _heartbeatLoops = 0;
+    uint64_t _bodiesTracked = 0;
+    uint64_t _bodiesPublished = 0;
 
     std::chrono::high_resolution_clock::time_point _lastFrameTime;
     float _timeAccumulator = 0.0f;
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include "../BulletBodyManager.hpp"
+#include "../BulletWorld.hpp"
+#include <string>
+
+class BulletBodyManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override { world.init(); }
+    void TearDown() override { world.cleanup(); }
+
+    rtypeEngine::BulletWorld world;
+};
+
+TEST_F(BulletBodyManagerTest, RegistryFollowsSwapRemove) {
+    rtypeEngine::BulletBodyManager manager(world.getWorld());
+    for (const char* id : {"a", "b", "c", "d"}) {
+        manager.createBody(id, "box", {1, 1, 1, 1});
+    }
+    btRigidBody* d = manager.getBody("d");
+
+    manager.destroyBody("b");
+    EXPECT_FALSE(manager.hasBody("b"));
+    EXPECT_EQ(manager.getBodies().size(), 3u);
+    EXPECT_EQ(manager.getBodyId(d), "d");
+    EXPECT_EQ(d->getUserIndex(), 1);
+    for (size_t i = 0; i < manager.getBodies().size(); ++i) {
+        EXPECT_EQ(manager.getBodies()[i].body->getUserIndex(), static_cast<int>(i));
+    }
+
+    manager.clear();
+    EXPECT_EQ(world.getWorld()->getNumCollisionObjects(), 0);
+}
+
+TEST_F(BulletBodyManagerTest, SpawnDestroyChurnReusesStorageAndShapes) {
+    rtypeEngine::BulletBodyManager manager(world.getWorld());
+
+    // 100 waves of 50 identical projectiles, then 200 rocks of distinct sizes.
+    for (int wave = 0; wave < 100; ++wave) {
+        for (int i = 0; i < 50; ++i) {
+            manager.createBody("bullet" + std::to_string(wave) + "_" + std::to_string(i), "box", {0.1f, 0.1f, 0.1f, 1});
+        }
+        for (int i = 0; i < 50; ++i) {
+            manager.destroyBody("bullet" + std::to_string(wave) + "_" + std::to_string(i));
+        }
+    }
+    for (int i = 0; i < 200; ++i) {
+        manager.createBody("rock" + std::to_string(i), "sphere", {static_cast<float>(i), 1});
+    }
+    for (int i = 0; i < 200; ++i) {
+        manager.destroyBody("rock" + std::to_string(i));
+    }
+
+    const rtypeEngine::BulletAllocationStats& stats = manager.allocationStats();
+    EXPECT_EQ(stats.bodiesCreated, 5200u);
+    // 200 rocks alive at once need 4 blocks; the projectile waves fit in the first.
+    EXPECT_EQ(stats.bodyBlocks, 4u);
+    EXPECT_EQ(stats.bodiesRecycled, 5200u - 200u);
+    // One box shared by every projectile, one sphere per rock size.
+    EXPECT_EQ(stats.shapesAllocated, 201u);
+    EXPECT_EQ(stats.shapesShared, 4999u);
+    EXPECT_TRUE(manager.getBodies().empty());
+}
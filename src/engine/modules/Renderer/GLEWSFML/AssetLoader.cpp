@@ -0,0 +1,81 @@
+#include "AssetLoader.hpp"
+
+namespace rtypeEngine {
+
+    void LoadTimeHistogram::add(double milliseconds)
+    {
+        size_t bucket = 0;
+        double limit = 1.0;
+        while (bucket + 1 < BUCKETS && milliseconds >= limit)
+        {
+            ++bucket;
+            limit *= 2.0;
+        }
+        ++counts[bucket];
+    }
+
+    AssetLoader::~AssetLoader()
+    {
+        stop();
+    }
+
+    void AssetLoader::start(unsigned int workers)
+    {
+        stop();
+        _stopping = false;
+        for (unsigned int i = 0; i < workers; ++i)
+            _workers.emplace_back([this]() { run(); });
+    }
+
+    void AssetLoader::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stopping = true;
+        }
+        _wake.notify_all();
+        for (std::thread& worker : _workers)
+            worker.join();
+        _workers.clear();
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.clear();
+    }
+
+    void AssetLoader::submit(LoadedAsset asset, Decoder decode)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs.push_back({std::move(asset), decode});
+        }
+        _wake.notify_one();
+    }
+
+    bool AssetLoader::poll(LoadedAsset& asset)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_done.empty())
+            return false;
+        asset = std::move(_done.front());
+        _done.pop_front();
+        return true;
+    }
+
+    void AssetLoader::run()
+    {
+        for (;;)
+        {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _wake.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+                if (_stopping)
+                    return;
+                job = std::move(_jobs.front());
+                _jobs.pop_front();
+            }
+            job.decode(job.asset);
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.push_back(std::move(job.asset));
+        }
+    }
+}
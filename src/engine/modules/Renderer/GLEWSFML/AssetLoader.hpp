@@ -0,0 +1,99 @@
+/**
+ * @file AssetLoader.hpp
+ * @brief Background decoding of textures and meshes for the renderer
+ *
+ * @details Worker threads read and decode asset files (image decoding, OBJ
+ * parsing or mesh cache mapping) and queue the results; they never touch
+ * OpenGL. The render thread polls the finished assets once per frame and
+ * uploads them within a byte budget (see ResourceManager::uploadLoadedAssets).
+ *
+ * With no workers, ResourceManager decodes on the calling thread instead,
+ * the synchronous behaviour the renderer had before.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "RenderStructs.hpp"
+
+namespace rtypeEngine {
+
+    enum class AssetStatus {
+        Unknown, // never requested
+        Pending,
+        Ready,
+        Failed
+    };
+
+    struct LoadedAsset {
+        enum class Kind {
+            Texture,
+            Mesh
+        };
+
+        Kind kind = Kind::Texture;
+        std::string path;
+        bool ok = false;
+        std::chrono::steady_clock::time_point requested;
+
+        // Kind::Texture: RGBA8, top row first
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> pixels;
+
+        // Kind::Mesh
+        MeshData mesh;
+    };
+
+    /// Request-to-ready times, bucket i counting loads under 2^i ms (the last one is open).
+    struct LoadTimeHistogram {
+        static constexpr size_t BUCKETS = 12;
+        std::array<uint32_t, BUCKETS> counts{};
+
+        void add(double milliseconds);
+    };
+
+    class AssetLoader {
+    public:
+        using Decoder = void (*)(LoadedAsset& asset);
+
+        AssetLoader() = default;
+        ~AssetLoader();
+        AssetLoader(const AssetLoader&) = delete;
+        AssetLoader& operator=(const AssetLoader&) = delete;
+
+        void start(unsigned int workers);
+        /// Joins the workers; queued requests are dropped.
+        void stop();
+        bool running() const { return !_workers.empty(); }
+
+        /// Queues `asset` for `decode` on a worker (running() only).
+        void submit(LoadedAsset asset, Decoder decode);
+        /// Takes the oldest decoded asset, if any.
+        bool poll(LoadedAsset& asset);
+
+    private:
+        struct Job {
+            LoadedAsset asset;
+            Decoder decode = nullptr;
+        };
+
+        void run();
+
+        std::vector<std::thread> _workers;
+        std::mutex _mutex;
+        std::condition_variable _wake;
+        std::deque<Job> _jobs;
+        std::deque<LoadedAsset> _done;
+        bool _stopping = false;
+    };
+}
@@ -0,0 +1,68 @@
+/**
+ * @file Frustum.hpp
+ * @brief Camera frustum planes for culling world objects
+ *
+ * @details Built once per frame from the projection and view matrices
+ * (column-major, as OpenGL stores them); objects are tested as bounding
+ * spheres, so the test is conservative: a sphere near a frustum corner
+ * may pass although the object itself is outside.
+ */
+
+#pragma once
+
+#include <cmath>
+#include "../I3DRenderer.hpp"
+
+namespace rtypeEngine {
+
+    class Frustum {
+    public:
+        static Frustum fromMatrices(const float projection[16], const float view[16])
+        {
+            float clip[16];
+            for (int column = 0; column < 4; ++column)
+            {
+                for (int row = 0; row < 4; ++row)
+                {
+                    float sum = 0.0f;
+                    for (int k = 0; k < 4; ++k)
+                        sum += projection[k * 4 + row] * view[column * 4 + k];
+                    clip[column * 4 + row] = sum;
+                }
+            }
+
+            // Gribb/Hartmann: each plane is row 3 plus or minus row 0, 1 or 2.
+            Frustum frustum;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                for (int side = 0; side < 2; ++side)
+                {
+                    float* plane = frustum._planes[axis * 2 + side];
+                    const float sign = side == 0 ? 1.0f : -1.0f;
+                    for (int column = 0; column < 4; ++column)
+                        plane[column] = clip[column * 4 + 3] + sign * clip[column * 4 + axis];
+                    const float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+                    if (length > 0.0f)
+                    {
+                        for (int i = 0; i < 4; ++i)
+                            plane[i] /= length;
+                    }
+                }
+            }
+            return frustum;
+        }
+
+        bool intersectsSphere(const Vector3f& center, float radius) const
+        {
+            for (const float* plane : _planes)
+            {
+                if (plane[0] * center.x + plane[1] * center.y + plane[2] * center.z + plane[3] < -radius)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        float _planes[6][4] = {};
+    };
+}
@@ -1,5 +1,6 @@
 
 #include "GLEWSFMLRenderer.hpp"
+#include "HeadlessContext.hpp"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -19,6 +20,7 @@
 #include <cstdlib>
 #include <cerrno>
 #include <algorithm>
+#include <cstring>
 
 constexpr float PI = 3.14159265f;
 
@@ -41,6 +43,10 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
     if (end == str.c_str() || errno == ERANGE) return fallback;
     return static_cast<int>(value);
 }
+
+bool isMeshPath(const std::string& path) noexcept {
+    return path.size() > 4 && path.compare(path.size() - 4, 4, ".obj") == 0;
+}
 } // namespace
 
     GLEWSFMLRenderer::GLEWSFMLRenderer(const char *pubEndpoint, const char *subEndpoint)
@@ -60,9 +66,31 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
           _lightColor{1.0f, 1.0f, 1.0f},
           _lightIntensity(1.0f),
           _lastFrameTime(std::chrono::steady_clock::now()),
-          _resourceManager(_hdc, _hwnd, _hglrc)
+          _resourceManager(_hdc, _hwnd, _hglrc, _headless)
     {
-        _pixelBuffer.resize(_resolution.x * _resolution.y);
+        setTickRate(RENDER_TICK_RATE);
+        const char *transport = std::getenv("RTYPE_FRAME_TRANSPORT");
+        _useFrameRing = !(transport && std::string(transport) == "bus");
+        const char *immediate = std::getenv("RTYPE_RENDER_IMMEDIATE");
+        _retained = !(immediate && std::string(immediate) == "1");
+        const char *culling = std::getenv("RTYPE_RENDER_CULLING");
+        _culling = !(culling && std::string(culling) == "0");
+        const char *headless = std::getenv("RTYPE_RENDER_HEADLESS");
+        _headless = headless && std::string(headless) == "1";
+#ifndef RTYPE_RENDER_EGL
+        if (_headless)
+        {
+            std::cerr << "[GLEWSFMLRenderer] Built without EGL, RTYPE_RENDER_HEADLESS ignored" << std::endl;
+            _headless = false;
+        }
+#endif
+        if (const char *latency = std::getenv("RTYPE_READBACK_LATENCY"))
+            _readback.setLatency(static_cast<uint32_t>(std::max(0, safeParseInt(latency, PixelReadback::DEFAULT_LATENCY))));
+        if (const char *workers = std::getenv("RTYPE_ASSET_WORKERS"))
+            _resourceManager.setLoaderWorkers(static_cast<unsigned int>(
+                std::clamp(safeParseInt(workers, ResourceManager::DEFAULT_LOADER_WORKERS), 0, 8)));
+        if (const char *budget = std::getenv("RTYPE_UPLOAD_BUDGET_KB"))
+            _resourceManager.setUploadBudget(static_cast<size_t>(std::max(1, safeParseInt(budget, 4096))) * 1024);
     }
 
     void GLEWSFMLRenderer::init()
@@ -71,11 +99,18 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                   { this->onRenderEntityCommand(msg); });
         subscribe("WindowResized", [this](const std::string &msg)
                   { this->handleWindowResized(msg); });
+        subscribe("PreloadAssets", [this](const std::string &msg)
+                  { this->onPreloadAssets(msg); });
 
         initContext();
+        _resourceManager.startLoader();
 
         ensureGLEWInitialized();
         createFramebuffer();
+        if (_retained)
+            _retained = _glewInitialized && _meshPipeline.init();
+        _instancing = _retained && _meshPipeline.instancing();
+        _statsWindowStart = std::chrono::steady_clock::now();
 
         glEnable(GL_DEPTH_TEST);
 
@@ -88,6 +123,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         {
             glewExperimental = GL_TRUE;
             GLenum err = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+            // A GLX build of GLEW still loads the core entry points under EGL.
+            if (_headless && err == GLEW_ERROR_NO_GLX_DISPLAY)
+                err = GLEW_OK;
+#endif
             if (GLEW_OK != err)
             {
                 std::cerr << "Error: " << glewGetErrorString(err) << std::endl;
@@ -102,6 +142,15 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
     void GLEWSFMLRenderer::loop()
     {
+#ifdef RTYPE_RENDER_EGL
+        if (_headless)
+        {
+            headless::makeCurrent(_hdc, _hglrc);
+            render();
+            headless::releaseCurrent(_hdc);
+            return;
+        }
+#endif
 #ifdef _WIN32
         wglMakeCurrent((HDC)_hdc, (HGLRC)_hglrc);
 #else
@@ -115,6 +164,42 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 #endif
     }
 
+    // Format: "path;path;..." - .obj files are models, anything else a texture.
+    // Models are requested right away; textures wait for the next frame.
+    void GLEWSFMLRenderer::onPreloadAssets(const std::string &message)
+    {
+        std::stringstream ss(message);
+        std::string path;
+        while (std::getline(ss, path, ';'))
+        {
+            if (path.empty())
+                continue;
+            if (isMeshPath(path))
+                _resourceManager.loadMesh(path);
+            _pendingPreloads.push_back(path);
+        }
+    }
+
+    void GLEWSFMLRenderer::finishPreloads()
+    {
+        for (const std::string &path : _pendingPreloads)
+        {
+            if (!isMeshPath(path))
+                _resourceManager.loadTexture(path);
+            else if (_retained && _resourceManager.assetStatus(path) == AssetStatus::Ready)
+                _resourceManager.prepareMesh(path);
+        }
+        std::cout << "[GLEWSFMLRenderer] Preloading " << _pendingPreloads.size() << " assets" << std::endl;
+        _pendingPreloads.clear();
+    }
+
+    void GLEWSFMLRenderer::setDeterministic(float frameSeconds, uint32_t seed)
+    {
+        _fixedTimestep = frameSeconds;
+        _particleSystem.seed(seed);
+        _resourceManager.setLoaderWorkers(0); // assets ready on the frame that asks for them
+    }
+
     void GLEWSFMLRenderer::handleWindowResized(const std::string &message)
     {
         std::stringstream ss(message);
@@ -140,8 +225,95 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         }
     }
 
+    // `obj` is the render object resolved from `id`, or null.
+    void GLEWSFMLRenderer::setEntityPosition(RenderObject *obj, const std::string &id, const Vector3f &position)
+    {
+        bool handled = false;
+        if (obj)
+        {
+            obj->position = position;
+            handled = true;
+        }
+        if (_particleSystem.hasGenerator(id))
+        {
+            _particleSystem.setGeneratorPosition(id, position);
+            handled = true;
+        }
+
+        if (!handled) {
+            if (id == _activeCameraId) {
+                _cameraPos = position;
+            } else if (id == _activeLightId) {
+                _lightPos = position;
+            }
+        }
+    }
+
+    void GLEWSFMLRenderer::setEntityRotation(RenderObject *obj, const std::string &id, const Vector3f &rotation)
+    {
+        bool handled = false;
+        if (obj)
+        {
+            obj->rotation = rotation;
+            handled = true;
+        }
+        if (_particleSystem.hasGenerator(id))
+        {
+            _particleSystem.setGeneratorRotation(id, rotation);
+            handled = true;
+        }
+
+        if (!handled && id == _activeCameraId) {
+            _cameraRot = rotation;
+        }
+    }
+
+    void GLEWSFMLRenderer::setEntityScale(RenderObject *obj, const Vector3f &scale)
+    {
+        if (obj)
+            obj->scale = scale;
+    }
+
+    void GLEWSFMLRenderer::setEntityColor(RenderObject *obj, const Vector3f &color)
+    {
+        if (obj)
+            obj->color = color;
+    }
+
+    void GLEWSFMLRenderer::onBinaryRenderCommand(const std::string &message)
+    {
+        bool ok = busCodec::decode(message, [this](busCodec::Op op, const std::string &id, const float *v, uint16_t count) {
+            if (count < 3)
+                return;
+            const Vector3f first{v[0], v[1], v[2]};
+            RenderObject *obj = _objects.find(id);
+            switch (op)
+            {
+            case busCodec::Op::RenderSetPosition: setEntityPosition(obj, id, first); break;
+            case busCodec::Op::RenderSetRotation: setEntityRotation(obj, id, first); break;
+            case busCodec::Op::RenderSetScale: setEntityScale(obj, first); break;
+            case busCodec::Op::RenderSetColor: setEntityColor(obj, first); break;
+            case busCodec::Op::RenderSetTransform:
+                setEntityPosition(obj, id, first);
+                if (count >= 6)
+                    setEntityRotation(obj, id, {v[3], v[4], v[5]});
+                if (count >= 9)
+                    setEntityScale(obj, {v[6], v[7], v[8]});
+                break;
+            default: break;
+            }
+        });
+        if (!ok)
+            std::cerr << "[GLEWSFMLRenderer] Malformed binary RenderEntityCommand (" << message.size() << " bytes)" << std::endl;
+    }
+
     void GLEWSFMLRenderer::onRenderEntityCommand(const std::string &message)
     {
+        if (busCodec::isBinary(message))
+        {
+            onBinaryRenderCommand(message);
+            return;
+        }
         std::stringstream ss(message);
         std::string segment;
         while (std::getline(ss, segment, ';'))
@@ -167,12 +339,12 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.meshPath = "";
+                        obj.kind = RenderKind::Camera;
                         obj.position = {0, 0, 0};
                         obj.rotation = {0, 0, 0};
                         obj.scale = {1, 1, 1};
                         obj.color = {1.0f, 1.0f, 1.0f};
-                        _renderObjects[id] = obj;
+                        _objects.add(std::move(obj));
                     }
                     else if (type == "Light" || type == "LIGHT")
                     {
@@ -188,13 +360,13 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
                             RenderObject obj;
                             obj.id = realId;
-                            obj.isSprite = true;
+                            obj.kind = RenderKind::Sprite;
                             obj.texturePath = texturePath;
                             obj.position = {0, 0, 0};
                             obj.rotation = {0, 0, 0};
                             obj.scale = {1, 1, 1};
                             obj.color = {1.0f, 1.0f, 1.0f};
-                            _renderObjects[realId] = obj;
+                            _objects.add(std::move(obj));
                         }
                     }
                     else if (type == "HUDSprite" || type == "HUDSPRITE")
@@ -207,14 +379,14 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
                             RenderObject obj;
                             obj.id = realId;
-                            obj.isSprite = true;
+                            obj.kind = RenderKind::Sprite;
                             obj.isScreenSpace = true;
                             obj.texturePath = texturePath;
                             obj.position = {0, 0, 0};
                             obj.rotation = {0, 0, 0};
                             obj.scale = {1, 1, 1};
                             obj.color = {1.0f, 1.0f, 1.0f};
-                            _renderObjects[realId] = obj;
+                            _objects.add(std::move(obj));
                         }
                     }
                     else
@@ -230,9 +402,8 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         obj.rotation = {0, 0, 0};
                         obj.scale = {1, 1, 1};
                         obj.color = {1.0f, 0.5f, 0.2f};
-                        _renderObjects[id] = obj;
-
                         _resourceManager.loadMesh(obj.meshPath);
+                        _objects.add(std::move(obj));
                     }
                 }
             }
@@ -255,8 +426,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.isText = true;
-                        obj.isSprite = true;
+                        obj.kind = RenderKind::Text;
                         obj.text = textContent;
                         obj.fontPath = fontPath;
                         obj.fontSize = safeParseInt(fontSizeStr, 24);
@@ -266,8 +436,8 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         obj.scale = {1, 1, 1};
                         obj.color = {1.0f, 1.0f, 1.0f};
 
-                        obj.textureID = _resourceManager.createTextTexture(obj.text, obj.fontPath, obj.fontSize, obj.color);
-                        _renderObjects[id] = obj;
+                        obj.shapedText = _resourceManager.shapeText(obj.text, obj.fontPath, obj.fontSize);
+                        _objects.add(std::move(obj));
                     }
                     catch (const std::exception &e)
                     {
@@ -303,7 +473,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.isRect = true;
+                        obj.kind = RenderKind::Rect;
                         obj.isScreenSpace = (isScreenSpaceStr == "1" || isScreenSpaceStr == "true");
                         obj.position = {pos[0], pos[1], 0};
                         // Validate dimensions
@@ -311,7 +481,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         obj.color = {col[0], col[1], col[2]};
                         float alphaRaw = (col.size() >= 4) ? col[3] : 1.0f;
                         obj.alpha = std::max(0.0f, std::min(1.0f, alphaRaw));
-                        _renderObjects[id] = obj;
+                        _objects.add(std::move(obj));
                     }
                 }
             }
@@ -329,11 +499,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::vector<float> v;
                     while(std::getline(pss, val, ',')) v.push_back(safeParseFloat(val));
 
-                    if (v.size() >= 4 && _renderObjects.find(id) != _renderObjects.end())
+                    RenderObject *obj = v.size() >= 4 ? _objects.find(id) : nullptr;
+                    if (obj)
                     {
-                        auto& obj = _renderObjects[id];
-                        obj.position = {v[0], v[1], 0};
-                        obj.scale = {std::max(0.0f, v[2]), std::max(0.0f, v[3]), 1};
+                        obj->position = {v[0], v[1], 0};
+                        obj->scale = {std::max(0.0f, v[2]), std::max(0.0f, v[3]), 1};
                     }
                 }
             }
@@ -346,10 +516,10 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::string id = data.substr(0, split);
                     float alpha = safeParseFloat(data.substr(split + 1), 1.0f);
 
-                    if (_renderObjects.find(id) != _renderObjects.end())
+                    if (RenderObject *obj = _objects.find(id))
                     {
                         // Clamp alpha between 0.0 and 1.0
-                        _renderObjects[id].alpha = std::max(0.0f, std::min(1.0f, alpha));
+                        obj->alpha = std::max(0.0f, std::min(1.0f, alpha));
                     }
                 }
             }
@@ -362,9 +532,9 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::string id = data.substr(0, split);
                     int zorder = safeParseInt(data.substr(split + 1), 0);
 
-                    if (_renderObjects.find(id) != _renderObjects.end())
+                    if (RenderObject *obj = _objects.find(id))
                     {
-                        _renderObjects[id].zOrder = zorder;
+                        _objects.setZOrder(*obj, zorder);
                     }
                 }
             }
@@ -397,7 +567,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.isCircle = true;
+                        obj.kind = RenderKind::Circle;
                         obj.isScreenSpace = (isScreenSpaceStr == "1" || isScreenSpaceStr == "true");
                         obj.position = {pos[0], pos[1], 0};
                         obj.radius = std::max(0.0f, pos[2]);
@@ -407,7 +577,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         if (segments < 3) segments = 3;
                         else if (segments > 128) segments = 128;
                         obj.segments = segments;
-                        _renderObjects[id] = obj;
+                        _objects.add(std::move(obj));
                     }
                 }
             }
@@ -439,7 +609,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.isRoundedRect = true;
+                        obj.kind = RenderKind::RoundedRect;
                         obj.isScreenSpace = (isScreenSpaceStr == "1" || isScreenSpaceStr == "true");
                         obj.position = {pos[0], pos[1], 0};
                         float w = std::max(0.0f, pos[2]);
@@ -451,7 +621,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         obj.color = {col[0], col[1], col[2]};
                         float alphaRaw = (col.size() >= 4) ? col[3] : 1.0f;
                         obj.alpha = std::max(0.0f, std::min(1.0f, alphaRaw));
-                        _renderObjects[id] = obj;
+                        _objects.add(std::move(obj));
                     }
                 }
             }
@@ -483,7 +653,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.isLine = true;
+                        obj.kind = RenderKind::Line;
                         obj.isScreenSpace = (isScreenSpaceStr == "1" || isScreenSpaceStr == "true");
                         obj.position = {pos[0], pos[1], 0};
                         obj.endPosition = {pos[2], pos[3], 0};
@@ -491,7 +661,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         obj.color = {col[0], col[1], col[2]};
                         float alphaRaw = (col.size() >= 4) ? col[3] : 1.0f;
                         obj.alpha = std::max(0.0f, std::min(1.0f, alphaRaw));
-                        _renderObjects[id] = obj;
+                        _objects.add(std::move(obj));
                     }
                 }
             }
@@ -520,7 +690,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     {
                         RenderObject obj;
                         obj.id = id;
-                        obj.isSprite = true;
+                        obj.kind = RenderKind::Sprite;
                         obj.isScreenSpace = (isScreenSpaceStr == "1" || isScreenSpaceStr == "true");
                         obj.texturePath = texturePath;
                         obj.position = {pos[0], pos[1], 0};
@@ -528,7 +698,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         obj.color = {1.0f, 1.0f, 1.0f};
                         obj.alpha = 1.0f;
                         obj.zOrder = zOrderStr.empty() ? 0 : safeParseInt(zOrderStr, 0);
-                        _renderObjects[id] = obj;
+                        _objects.add(std::move(obj));
                     }
                 }
             }
@@ -547,12 +717,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::getline(ss2, widthStr, ':');
                     std::getline(ss2, colorStr);
 
-                    if (_renderObjects.find(id) != _renderObjects.end())
+                    if (RenderObject *obj = _objects.find(id))
                     {
-                        auto& obj = _renderObjects[id];
-                        obj.outlined = (enabledStr == "1" || enabledStr == "true");
+                        obj->outlined = (enabledStr == "1" || enabledStr == "true");
                         float rawWidth = safeParseFloat(widthStr, 2.0f);
-                        obj.outlineWidth = std::max(1.0f, std::min(rawWidth, 50.0f));
+                        obj->outlineWidth = std::max(1.0f, std::min(rawWidth, 50.0f));
 
                         std::stringstream css(colorStr);
                         std::string val;
@@ -560,7 +729,7 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                         while(std::getline(css, val, ',')) col.push_back(safeParseFloat(val));
                         if (col.size() >= 3)
                         {
-                            obj.outlineColor = {col[0], col[1], col[2]};
+                            obj->outlineColor = {col[0], col[1], col[2]};
                         }
                     }
                 }
@@ -574,9 +743,9 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::string id = data.substr(0, split);
                     float radius = safeParseFloat(data.substr(split + 1), 10.0f);
 
-                    if (_renderObjects.find(id) != _renderObjects.end())
+                    if (RenderObject *obj = _objects.find(id))
                     {
-                        _renderObjects[id].radius = radius;
+                        obj->radius = radius;
                     }
                 }
             }
@@ -589,12 +758,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::string id = data.substr(0, split);
                     float radius = safeParseFloat(data.substr(split + 1), 5.0f);
 
-                    if (_renderObjects.find(id) != _renderObjects.end())
+                    if (RenderObject *obj = _objects.find(id))
                     {
-                        auto& obj = _renderObjects[id];
                         // Clamp corner radius to half of smallest dimension
-                        float maxRadius = std::min(obj.scale.x, obj.scale.y) / 2.0f;
-                        obj.cornerRadius = std::min(radius, maxRadius);
+                        float maxRadius = std::min(obj->scale.x, obj->scale.y) / 2.0f;
+                        obj->cornerRadius = std::min(radius, maxRadius);
                     }
                 }
             }
@@ -606,13 +774,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::string id = data.substr(0, split);
                     std::string newText = data.substr(split + 1);
 
-                if (_renderObjects.find(id) != _renderObjects.end()) {
-                    auto& obj = _renderObjects[id];
-                    if (obj.isText) {
-                        obj.text = newText;
-                        if (obj.textureID) glDeleteTextures(1, &obj.textureID);
-                        // Always create white texture so glColor3f in render() can tint it correctly
-                        obj.textureID = _resourceManager.createTextTexture(obj.text, obj.fontPath, obj.fontSize, {1.0f, 1.0f, 1.0f});
+                if (RenderObject *obj = _objects.find(id)) {
+                    if (obj->kind == RenderKind::Text && obj->text != newText) {
+                        obj->text = newText;
+                        // Glyphs are white in the atlas, tinted by obj.color in render()
+                        obj->shapedText = _resourceManager.shapeText(obj->text, obj->fontPath, obj->fontSize);
                     }
                 }
             }
@@ -625,28 +791,8 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
             std::vector<float> v;
             while(std::getline(dss, val, ',')) v.push_back(safeParseFloat(val));
 
-                if (v.size() >= 3)
-                {
-                    bool handled = false;
-                    if (_renderObjects.find(id) != _renderObjects.end())
-                    {
-                        _renderObjects[id].position = {v[0], v[1], v[2]};
-                        handled = true;
-                    }
-                    if (_particleSystem.hasGenerator(id))
-                    {
-                        _particleSystem.setGeneratorPosition(id, {v[0], v[1], v[2]});
-                        handled = true;
-                    }
-
-                if (!handled) {
-                    if (id == _activeCameraId) {
-                        _cameraPos = {v[0], v[1], v[2]};
-                    } else if (id == _activeLightId) {
-                        _lightPos = {v[0], v[1], v[2]};
-                    }
-                }
-            }
+            if (v.size() >= 3)
+                setEntityPosition(_objects.find(id), id, {v[0], v[1], v[2]});
         } else if (command == "SetRotation") {
             std::stringstream dss(data);
             std::string id, val;
@@ -654,26 +800,8 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
             std::vector<float> v;
             while(std::getline(dss, val, ',')) v.push_back(safeParseFloat(val));
 
-                if (v.size() >= 3)
-                {
-                    bool handled = false;
-                    if (_renderObjects.find(id) != _renderObjects.end())
-                    {
-                        _renderObjects[id].rotation = {v[0], v[1], v[2]};
-                        handled = true;
-                    }
-                    if (_particleSystem.hasGenerator(id))
-                    {
-                        _particleSystem.setGeneratorRotation(id, {v[0], v[1], v[2]});
-                        handled = true;
-                    }
-
-                if (!handled) {
-                    if (id == _activeCameraId) {
-                        _cameraRot = {v[0], v[1], v[2]};
-                    }
-                }
-            }
+            if (v.size() >= 3)
+                setEntityRotation(_objects.find(id), id, {v[0], v[1], v[2]});
         } else if (command == "SetScale") {
             std::stringstream dss(data);
             std::string id, val;
@@ -681,9 +809,8 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
             std::vector<float> v;
             while(std::getline(dss, val, ',')) v.push_back(safeParseFloat(val));
 
-            if (v.size() >= 3 && _renderObjects.find(id) != _renderObjects.end()) {
-                _renderObjects[id].scale = {v[0], v[1], v[2]};
-            }
+            if (v.size() >= 3)
+                setEntityScale(_objects.find(id), {v[0], v[1], v[2]});
         } else if (command == "SetColor") {
             std::stringstream dss(data);
             std::string id, val;
@@ -691,10 +818,8 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
             std::vector<float> v;
             while(std::getline(dss, val, ',')) v.push_back(safeParseFloat(val));
 
-                if (v.size() >= 3 && _renderObjects.find(id) != _renderObjects.end())
-                {
-                    _renderObjects[id].color = {v[0], v[1], v[2]};
-                }
+            if (v.size() >= 3)
+                setEntityColor(_objects.find(id), {v[0], v[1], v[2]});
             }
             else if (command == "SetTexture")
             {
@@ -704,9 +829,9 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     std::string id = data.substr(0, split);
                     std::string texturePath = data.substr(split + 1);
 
-                    if (_renderObjects.find(id) != _renderObjects.end())
+                    if (RenderObject *obj = _objects.find(id))
                     {
-                        _renderObjects[id].texturePath = texturePath;
+                        obj->texturePath = texturePath;
                         // loadTexture(texturePath);
                     }
                 }
@@ -729,13 +854,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
             else if (command == "SetActiveCamera")
             {
                 _activeCameraId = data;
+                _activeCamera = _objects.handle(data);
             }
             else if (command == "DestroyEntity")
             {
-                if (_renderObjects.find(data) != _renderObjects.end())
-                {
-                    _renderObjects.erase(data);
-                }
+                _objects.remove(data);
                 if (_particleSystem.hasGenerator(data))
                 {
                     _particleSystem.destroyGenerator(data);
@@ -825,7 +948,21 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
     void GLEWSFMLRenderer::cleanup()
     {
+        _resourceManager.stopLoader();
+        _meshPipeline.destroy();
+        _resourceManager.releaseMeshBuffers();
+        _resourceManager.releaseTextAtlases();
+        _particleSystem.releaseBuffers();
+        _readback.destroy();
         destroyFramebuffer();
+        _frameRing.close();
+#ifdef RTYPE_RENDER_EGL
+        if (_headless)
+        {
+            headless::destroyContext(_hdc, _hglrc);
+            return;
+        }
+#endif
 #ifdef _WIN32
         if (_hglrc)
         {
@@ -929,16 +1066,21 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         {
             _resolution = _newResolution;
             _hudResolution = _newResolution;  // Also update HUD resolution
-            _pixelBuffer.resize(_resolution.x * _resolution.y);
+            _readback.reset(); // frames in flight have the old size
             destroyFramebuffer();
             createFramebuffer();
             _pendingResize = false;
             std::cout << "[GLEWSFMLRenderer] Resized to " << _resolution.x << "x" << _resolution.y << std::endl;
         }
 
+        if (!_pendingPreloads.empty())
+            finishPreloads();
+        _resourceManager.uploadLoadedAssets(_retained);
+
         auto now = std::chrono::steady_clock::now();
-        float dt = std::chrono::duration<float>(now - _lastFrameTime).count();
+        float dt = _fixedTimestep > 0.0f ? _fixedTimestep : std::chrono::duration<float>(now - _lastFrameTime).count();
         _lastFrameTime = now;
+        const DrawStats drawsBefore = _meshPipeline.stats();
 
         _particleSystem.update(dt);
 
@@ -970,10 +1112,16 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         glLoadIdentity();
 
         // Update camera from render objects if active
-        if (!_activeCameraId.empty() && _renderObjects.find(_activeCameraId) != _renderObjects.end())
+        RenderObject *camera = _objects.get(_activeCamera);
+        if (!camera && !_activeCameraId.empty())
+        {
+            _activeCamera = _objects.handle(_activeCameraId);
+            camera = _objects.get(_activeCamera);
+        }
+        if (camera)
         {
-            _cameraPos = _renderObjects[_activeCameraId].position;
-            _cameraRot = _renderObjects[_activeCameraId].rotation;
+            _cameraPos = camera->position;
+            _cameraRot = camera->rotation;
         }
 
         // Apply camera rotation (convert radians to degrees)
@@ -982,6 +1130,12 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         glRotatef(-_cameraRot.z * 180.0f / 3.14159f, 0.0f, 0.0f, 1.0f);
         glTranslatef(-_cameraPos.x, -_cameraPos.y, -_cameraPos.z);
 
+        float view[16];
+        glGetFloatv(GL_MODELVIEW_MATRIX, view);
+        const Frustum frustum = Frustum::fromMatrices(m, view);
+        _lastFrame.visible = 0;
+        _lastFrame.culled = 0;
+
         glEnable(GL_LIGHTING);
         glEnable(GL_LIGHT0);
 
@@ -998,176 +1152,102 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         glEnable(GL_COLOR_MATERIAL);
         glColorMaterial(GL_FRONT, GL_AMBIENT_AND_DIFFUSE);
 
-        for (const auto &pair : _renderObjects)
+        // Only these kinds have a world-space draw.
+        for (RenderKind kind : {RenderKind::Mesh, RenderKind::Sprite, RenderKind::Text})
         {
-            const auto &obj = pair.second;
-            if (obj.isScreenSpace)
-                continue;
-
-            glPushMatrix();
-
-            glTranslatef(obj.position.x, obj.position.y, obj.position.z);
-            glRotatef(obj.rotation.x * 180.0f / 3.14159f, 1.0f, 0.0f, 0.0f);
-            glRotatef(obj.rotation.y * 180.0f / 3.14159f, 0.0f, 1.0f, 0.0f);
-            glRotatef(obj.rotation.z * 180.0f / 3.14159f, 0.0f, 0.0f, 1.0f);
-            glScalef(obj.scale.x, obj.scale.y, obj.scale.z);
-
-            if (obj.isSprite)
+            for (const RenderObject &obj : _objects.objects(kind))
             {
-                GLuint tex = 0;
-                if (obj.isText)
+                if (obj.isScreenSpace)
+                    continue;
+                if (!worldVisible(obj, frustum))
+                    continue;
+                if (_instancing && batchWorldObject(obj))
+                    continue;
+
+                glPushMatrix();
+
+                glTranslatef(obj.position.x, obj.position.y, obj.position.z);
+                glRotatef(obj.rotation.x * 180.0f / 3.14159f, 1.0f, 0.0f, 0.0f);
+                glRotatef(obj.rotation.y * 180.0f / 3.14159f, 0.0f, 1.0f, 0.0f);
+                glRotatef(obj.rotation.z * 180.0f / 3.14159f, 0.0f, 0.0f, 1.0f);
+                glScalef(obj.scale.x, obj.scale.y, obj.scale.z);
+
+                if (obj.kind == RenderKind::Text)
                 {
-                    tex = obj.textureID;
+                    // One world unit high, centered, keeping the aspect ratio of the text box.
+                    if (obj.shapedText)
+                    {
+                        const float unit = 1.0f / obj.shapedText->height;
+                        glDisable(GL_LIGHTING);
+                        glTranslatef(-0.5f * obj.shapedText->width * unit, -0.5f, 0.0f);
+                        glScalef(unit, unit, 1.0f);
+                        drawText(obj, 1.0f);
+                        glEnable(GL_LIGHTING);
+                    }
                 }
-                else
+                else if (obj.kind == RenderKind::Sprite)
                 {
-                    tex = _resourceManager.loadTexture(obj.texturePath);
-                }
+                    GLuint tex = _resourceManager.loadTexture(obj.texturePath);
 
-                if (tex)
-                {
-                    glDisable(GL_LIGHTING); // Disable lighting for sprites/text
-                    glEnable(GL_TEXTURE_2D);
-                    glBindTexture(GL_TEXTURE_2D, tex);
-                    glColor3f(obj.color.x, obj.color.y, obj.color.z);
+                    if (tex)
+                    {
+                        glDisable(GL_LIGHTING); // Disable lighting for sprites
+                        glBindTexture(GL_TEXTURE_2D, tex);
 
-                    float w = 0.5f;
-                    float h = 0.5f;
+                        float w = 0.5f;
+                        float h = 0.5f;
 
-                    if (obj.isText)
-                    {
-                        int texW = 0, texH = 0;
-                        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &texW);
-                        glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &texH);
-                        if (texH > 0)
+                        if (_retained)
                         {
-                            float aspect = (float)texW / (float)texH;
-                            w = aspect * 0.5f;
+                            glTranslatef(-w, -h, 0.0f);
+                            glScalef(2.0f * w, 2.0f * h, 1.0f);
+                            _meshPipeline.drawQuad(obj.color, 1.0f, tex);
                         }
+                        else
+                        {
+                            ++_meshPipeline.stats().immediate;
+                            glEnable(GL_TEXTURE_2D);
+                            glColor3f(obj.color.x, obj.color.y, obj.color.z);
+                            glBegin(GL_QUADS);
+                            glNormal3f(0.0f, 0.0f, 1.0f);
+                            glTexCoord2f(0, 1);
+                            glVertex3f(-w, -h, 0.0f);
+                            glTexCoord2f(1, 1);
+                            glVertex3f(w, -h, 0.0f);
+                            glTexCoord2f(1, 0);
+                            glVertex3f(w, h, 0.0f);
+                            glTexCoord2f(0, 0);
+                            glVertex3f(-w, h, 0.0f);
+                            glEnd();
+                            glDisable(GL_TEXTURE_2D);
+                        }
+                        glEnable(GL_LIGHTING); // Re-enable lighting
                     }
-
-                    glBegin(GL_QUADS);
-                    glNormal3f(0.0f, 0.0f, 1.0f);
-                    glTexCoord2f(0, 1);
-                    glVertex3f(-w, -h, 0.0f);
-                    glTexCoord2f(1, 1);
-                    glVertex3f(w, -h, 0.0f);
-                    glTexCoord2f(1, 0);
-                    glVertex3f(w, h, 0.0f);
-                    glTexCoord2f(0, 0);
-                    glVertex3f(-w, h, 0.0f);
-                    glEnd();
-
-                    glDisable(GL_TEXTURE_2D);
-                    glEnable(GL_LIGHTING); // Re-enable lighting
-                }
-            }
-            else if (const MeshData* meshPtr = _resourceManager.getMesh(obj.meshPath))
-            {
-                const auto &mesh = *meshPtr;
-                GLuint texID;
-
-                if (!obj.texturePath.empty())
-                {
-                    texID = _resourceManager.loadTexture(obj.texturePath);
-                    glDisable(GL_LIGHTING);
-                    glEnable(GL_TEXTURE_2D);
-                    glBindTexture(GL_TEXTURE_2D, texID);
-
-                    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-                    glColor3f(obj.color.x, obj.color.y, obj.color.z);
-                }
-                else
-                {
-                    glEnable(GL_LIGHTING);
-                    glDisable(GL_TEXTURE_2D);
-                    // Reset to modulate for non-textured objects (though disabled texture makes this moot)
-                    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
-                    glColor3f(obj.color.x, obj.color.y, obj.color.z);
                 }
-                glBegin(GL_TRIANGLES);
-
-                for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+                else if (const MeshData* meshPtr = _retained ? _resourceManager.prepareMesh(obj.meshPath)
+                                                             : _resourceManager.getMesh(obj.meshPath))
                 {
-                    unsigned int idx0 = mesh.indices[i];
-                    unsigned int idx1 = mesh.indices[i + 1];
-                    unsigned int idx2 = mesh.indices[i + 2];
-
-                    unsigned int uvIdx0 = 0;
-                    unsigned int uvIdx1 = 0;
-                    unsigned int uvIdx2 = 0;
-
-                    if (i + 2 < mesh._textureIndices.size())
+                    if (meshPtr->vao)
                     {
-                        uvIdx0 = mesh._textureIndices[i];
-                        uvIdx1 = mesh._textureIndices[i + 1];
-                        uvIdx2 = mesh._textureIndices[i + 2];
+                        // Textured meshes are unlit, as in the immediate path.
+                        GLuint texID = obj.texturePath.empty() ? 0 : _resourceManager.loadTexture(obj.texturePath);
+                        _meshPipeline.drawMesh(*meshPtr, obj.color, texID, obj.texturePath.empty());
                     }
-
-                    if (idx0 * 3 + 2 < mesh.vertices.size() &&
-                        idx1 * 3 + 2 < mesh.vertices.size() &&
-                        idx2 * 3 + 2 < mesh.vertices.size())
+                    else
                     {
-
-                        float x0 = mesh.vertices[idx0 * 3];
-                        float y0 = mesh.vertices[idx0 * 3 + 1];
-                        float z0 = mesh.vertices[idx0 * 3 + 2];
-
-                        float x1 = mesh.vertices[idx1 * 3];
-                        float y1 = mesh.vertices[idx1 * 3 + 1];
-                        float z1 = mesh.vertices[idx1 * 3 + 2];
-
-                        float x2 = mesh.vertices[idx2 * 3];
-                        float y2 = mesh.vertices[idx2 * 3 + 1];
-                        float z2 = mesh.vertices[idx2 * 3 + 2];
-
-                        // Calculate face normal
-                        float ux = x1 - x0;
-                        float uy = y1 - y0;
-                        float uz = z1 - z0;
-
-                        float vx = x2 - x0;
-                        float vy = y2 - y0;
-                        float vz = z2 - z0;
-
-                        float nx = uy * vz - uz * vy;
-                        float ny = uz * vx - ux * vz;
-                        float nz = ux * vy - uy * vx;
-
-                        float len = sqrt(nx * nx + ny * ny + nz * nz);
-                        if (len > 0)
-                        {
-                            nx /= len;
-                            ny /= len;
-                            nz /= len;
-                            glNormal3f(nx, ny, nz);
-                        }
-
-                        if (!obj.texturePath.empty() && uvIdx0 * 2 + 1 < mesh.uvs.size())
-                        {
-                            glTexCoord2f(mesh.uvs[uvIdx0 * 2], mesh.uvs[uvIdx0 * 2 + 1]);
-                        }
-                        glVertex3f(x0, y0, z0);
-                        if (!obj.texturePath.empty() && uvIdx1 * 2 + 1 < mesh.uvs.size())
-                        {
-                            glTexCoord2f(mesh.uvs[uvIdx1 * 2], mesh.uvs[uvIdx1 * 2 + 1]);
-                        }
-                        glVertex3f(x1, y1, z1);
-                        if (!obj.texturePath.empty() && uvIdx2 * 2 + 1 < mesh.uvs.size())
-                        {
-                            glTexCoord2f(mesh.uvs[uvIdx2 * 2], mesh.uvs[uvIdx2 * 2 + 1]);
-                        }
-                        glVertex3f(x2, y2, z2);
+                        _meshPipeline.end();
+                        drawMeshImmediate(*meshPtr, obj);
                     }
                 }
-                glEnd();
-                glDisable(GL_TEXTURE_2D);
-            }
 
-            glPopMatrix();
+                glPopMatrix();
+            }
         }
 
-        _particleSystem.render();
+        if (_instancing)
+            drawBatches();
+        _meshPipeline.end();
+        _meshPipeline.stats().drawCalls += _particleSystem.render();
 
         // HUD Rendering
         glMatrixMode(GL_PROJECTION);
@@ -1182,43 +1262,48 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-        // Sort HUD objects by zOrder
-        std::vector<std::pair<int, const RenderObject*>> sortedHUD;
-        for (const auto &pair : _renderObjects)
-        {
-            if (pair.second.isScreenSpace)
-            {
-                sortedHUD.push_back({pair.second.zOrder, &pair.second});
-            }
-        }
-        std::sort(sortedHUD.begin(), sortedHUD.end(),
-            [](const auto& a, const auto& b) { return a.first < b.first; });
-
-        for (const auto &sortedPair : sortedHUD)
+        // HUD objects by zOrder, sorted again only when the list changed
+        for (RenderHandle handle : _objects.hudOrder())
         {
-            const auto &obj = *sortedPair.second;
+            const RenderObject *hudObject = _objects.get(handle);
+            if (!hudObject || !hudVisible(*hudObject))
+                continue;
+            const auto &obj = *hudObject;
 
             // Render rectangles (button backgrounds, panels, etc.)
-            if (obj.isRect)
+            if (obj.kind == RenderKind::Rect)
             {
-                glDisable(GL_TEXTURE_2D);
-                glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
-
                 float x = obj.position.x;
                 float y = obj.position.y;
                 float w = obj.scale.x;  // width
                 float h = obj.scale.y;  // height
 
-                glBegin(GL_QUADS);
-                glVertex2f(x, y);
-                glVertex2f(x + w, y);
-                glVertex2f(x + w, y + h);
-                glVertex2f(x, y + h);
-                glEnd();
+                if (_retained)
+                {
+                    glPushMatrix();
+                    glTranslatef(x, y, 0.0f);
+                    glScalef(w, h, 1.0f);
+                    _meshPipeline.drawQuad(obj.color, obj.alpha, 0);
+                    glPopMatrix();
+                }
+                else
+                {
+                    ++_meshPipeline.stats().immediate;
+                    glDisable(GL_TEXTURE_2D);
+                    glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
+                    glBegin(GL_QUADS);
+                    glVertex2f(x, y);
+                    glVertex2f(x + w, y);
+                    glVertex2f(x + w, y + h);
+                    glVertex2f(x, y + h);
+                    glEnd();
+                }
 
                 // Draw outline if enabled
                 if (obj.outlined)
                 {
+                    _meshPipeline.end();
+                    glDisable(GL_TEXTURE_2D);
                     glLineWidth(obj.outlineWidth);
                     glColor4f(obj.outlineColor.x, obj.outlineColor.y, obj.outlineColor.z, obj.alpha);
                     glBegin(GL_LINE_LOOP);
@@ -1231,28 +1316,41 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                 }
             }
             // Render circles
-            else if (obj.isCircle)
+            else if (obj.kind == RenderKind::Circle)
             {
-                glDisable(GL_TEXTURE_2D);
-                glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
-
                 float cx = obj.position.x;
                 float cy = obj.position.y;
                 float r = obj.radius;
                 int segments = obj.segments;
 
-                glBegin(GL_TRIANGLE_FAN);
-                glVertex2f(cx, cy);  // Center
-                for (int i = 0; i <= segments; i++)
+                if (_retained)
                 {
-                    float angle = 2.0f * PI * (float)i / (float)segments;
-                    glVertex2f(cx + r * cos(angle), cy + r * sin(angle));
+                    glPushMatrix();
+                    glTranslatef(cx, cy, 0.0f);
+                    glScalef(r, r, 1.0f);
+                    _meshPipeline.drawCircle(segments, obj.color, obj.alpha);
+                    glPopMatrix();
+                }
+                else
+                {
+                    ++_meshPipeline.stats().immediate;
+                    glDisable(GL_TEXTURE_2D);
+                    glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
+                    glBegin(GL_TRIANGLE_FAN);
+                    glVertex2f(cx, cy);  // Center
+                    for (int i = 0; i <= segments; i++)
+                    {
+                        float angle = 2.0f * PI * (float)i / (float)segments;
+                        glVertex2f(cx + r * cos(angle), cy + r * sin(angle));
+                    }
+                    glEnd();
                 }
-                glEnd();
 
                 // Draw outline if enabled
                 if (obj.outlined)
                 {
+                    _meshPipeline.end();
+                    glDisable(GL_TEXTURE_2D);
                     glLineWidth(obj.outlineWidth);
                     glColor4f(obj.outlineColor.x, obj.outlineColor.y, obj.outlineColor.z, obj.alpha);
                     glBegin(GL_LINE_LOOP);
@@ -1266,8 +1364,11 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                 }
             }
             // Render rounded rectangles
-            else if (obj.isRoundedRect)
+            else if (obj.kind == RenderKind::RoundedRect)
             {
+                // Per-object geometry, few of them: still immediate mode.
+                _meshPipeline.end();
+                ++_meshPipeline.stats().immediate;
                 glDisable(GL_TEXTURE_2D);
                 glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
 
@@ -1367,8 +1468,10 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                 }
             }
             // Render lines
-            else if (obj.isLine)
+            else if (obj.kind == RenderKind::Line)
             {
+                _meshPipeline.end();
+                ++_meshPipeline.stats().immediate;
                 glDisable(GL_TEXTURE_2D);
                 glLineWidth(obj.lineWidth);
                 glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
@@ -1380,25 +1483,25 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
                 glLineWidth(1.0f);
             }
-            // Render sprites and text
-            else if (obj.isSprite)
+            else if (obj.kind == RenderKind::Text)
             {
-                GLuint tex = 0;
-                if (obj.isText)
-                {
-                    tex = obj.textureID;
-                }
-                else
+                // Text box in pixels, scaled like the texture it replaces.
+                if (obj.shapedText)
                 {
-                    tex = _resourceManager.loadTexture(obj.texturePath);
+                    glPushMatrix();
+                    glTranslatef(obj.position.x, obj.position.y, 0.0f);
+                    glScalef(obj.scale.x, obj.scale.y, 1.0f);
+                    drawText(obj, obj.alpha);
+                    glPopMatrix();
                 }
+            }
+            // Render sprites
+            else if (obj.kind == RenderKind::Sprite)
+            {
+                GLuint tex = _resourceManager.loadTexture(obj.texturePath);
 
                 if (tex)
                 {
-                    glEnable(GL_TEXTURE_2D);
-                    glBindTexture(GL_TEXTURE_2D, tex);
-                    glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
-
                     int texW = 0, texH = 0;
                     glBindTexture(GL_TEXTURE_2D, tex);
                     glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &texW);
@@ -1408,31 +1511,38 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
                     float w = (obj.scale.x > 0) ? obj.scale.x : (float)texW;
                     float h = (obj.scale.y > 0) ? obj.scale.y : (float)texH;
 
-                    // For text, scale is typically 1.0, so use texture size
-                    if (obj.isText)
-                    {
-                        w = (float)texW * obj.scale.x;
-                        h = (float)texH * obj.scale.y;
-                    }
-
                     float x = obj.position.x;
                     float y = obj.position.y;
 
-                    glBegin(GL_QUADS);
-                    glTexCoord2f(0, 1);
-                    glVertex2f(x, y);
-                    glTexCoord2f(1, 1);
-                    glVertex2f(x + w, y);
-                    glTexCoord2f(1, 0);
-                    glVertex2f(x + w, y + h);
-                    glTexCoord2f(0, 0);
-                    glVertex2f(x, y + h);
-                    glEnd();
-
-                    glDisable(GL_TEXTURE_2D);
+                    if (_retained)
+                    {
+                        glPushMatrix();
+                        glTranslatef(x, y, 0.0f);
+                        glScalef(w, h, 1.0f);
+                        _meshPipeline.drawQuad(obj.color, obj.alpha, tex);
+                        glPopMatrix();
+                    }
+                    else
+                    {
+                        ++_meshPipeline.stats().immediate;
+                        glEnable(GL_TEXTURE_2D);
+                        glColor4f(obj.color.x, obj.color.y, obj.color.z, obj.alpha);
+                        glBegin(GL_QUADS);
+                        glTexCoord2f(0, 1);
+                        glVertex2f(x, y);
+                        glTexCoord2f(1, 1);
+                        glVertex2f(x + w, y);
+                        glTexCoord2f(1, 0);
+                        glVertex2f(x + w, y + h);
+                        glTexCoord2f(0, 0);
+                        glVertex2f(x, y + h);
+                        glEnd();
+                        glDisable(GL_TEXTURE_2D);
+                    }
                 }
             }
         }
+        _meshPipeline.end();
 
         glEnable(GL_DEPTH_TEST);
         glMatrixMode(GL_PROJECTION);
@@ -1442,37 +1552,410 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
         glDisable(GL_LIGHTING);
 
-        glReadPixels(0, 0, _resolution.x, _resolution.y, GL_RGBA, GL_UNSIGNED_BYTE, _pixelBuffer.data());
+        auto readbackStart = std::chrono::steady_clock::now();
+        publishFrame();
+        auto frameEnd = std::chrono::steady_clock::now();
+
+        const DrawStats &draws = _meshPipeline.stats();
+        _lastFrame.renderMs = std::chrono::duration<double, std::milli>(frameEnd - now).count();
+        _lastFrame.readbackMs = std::chrono::duration<double, std::milli>(frameEnd - readbackStart).count();
+        _lastFrame.draws.drawCalls = draws.drawCalls - drawsBefore.drawCalls;
+        _lastFrame.draws.batches = draws.batches - drawsBefore.batches;
+        _lastFrame.draws.instances = draws.instances - drawsBefore.instances;
+        _lastFrame.draws.immediate = draws.immediate - drawsBefore.immediate;
+        _statsVisible += _lastFrame.visible;
+        _statsCulled += _lastFrame.culled;
+        publishRenderStats(frameEnd);
+
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    // Glyph quads of a text in the current modelview, one draw.
+    void GLEWSFMLRenderer::drawText(const RenderObject &obj, float alpha)
+    {
+        const ShapedText &shaped = *obj.shapedText;
+        if (shaped.vertices.empty())
+            return;
+        GLuint tex = shaped.atlas->texture();
+
+        if (_retained)
+        {
+            _meshPipeline.drawTriangles(shaped.vertices.data(), shaped.vertices.size(), obj.color, alpha, tex);
+            return;
+        }
+        ++_meshPipeline.stats().immediate;
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, tex);
+        glColor4f(obj.color.x, obj.color.y, obj.color.z, alpha);
+        glBegin(GL_TRIANGLES);
+        glNormal3f(0.0f, 0.0f, 1.0f);
+        for (const GpuVertex &vertex : shaped.vertices)
+        {
+            glTexCoord2f(vertex.uv[0], vertex.uv[1]);
+            glVertex2f(vertex.position[0], vertex.position[1]);
+        }
+        glEnd();
+        glDisable(GL_TEXTURE_2D);
+    }
+
+    // Bounding sphere against the frustum, scaled by the largest axis so any
+    // rotation stays inside it. Objects with nothing to draw are not counted.
+    bool GLEWSFMLRenderer::worldVisible(const RenderObject &obj, const Frustum &frustum)
+    {
+        float radius;
+        if (obj.kind == RenderKind::Text)
+        {
+            if (!obj.shapedText)
+                return true;
+            const float aspect = obj.shapedText->width / obj.shapedText->height;
+            radius = 0.5f * std::sqrt(aspect * aspect + 1.0f);
+        }
+        else if (obj.kind == RenderKind::Sprite)
+            radius = 0.70711f; // unit quad
+        else
+        {
+            radius = _resourceManager.meshRadius(obj.meshPath);
+            if (radius < 0.0f)
+                return true;
+        }
+        const float scale = std::max({std::fabs(obj.scale.x), std::fabs(obj.scale.y), std::fabs(obj.scale.z)});
+        const bool visible = !_culling || frustum.intersectsSphere(obj.position, radius * scale);
+        ++(visible ? _lastFrame.visible : _lastFrame.culled);
+        return visible;
+    }
+
+    // Screen-space box against the HUD viewport; outlines and line widths
+    // count as margin. Sprites sized by their texture are kept, uncounted.
+    bool GLEWSFMLRenderer::hudVisible(const RenderObject &obj)
+    {
+        float minX, minY, maxX, maxY;
+        float margin = obj.outlined ? obj.outlineWidth : 0.0f;
+        if (obj.kind == RenderKind::Rect || obj.kind == RenderKind::RoundedRect ||
+            (obj.kind == RenderKind::Sprite && obj.scale.x > 0 && obj.scale.y > 0))
+        {
+            minX = std::min(obj.position.x, obj.position.x + obj.scale.x);
+            maxX = std::max(obj.position.x, obj.position.x + obj.scale.x);
+            minY = std::min(obj.position.y, obj.position.y + obj.scale.y);
+            maxY = std::max(obj.position.y, obj.position.y + obj.scale.y);
+        }
+        else if (obj.kind == RenderKind::Circle)
+        {
+            minX = obj.position.x - obj.radius;
+            maxX = obj.position.x + obj.radius;
+            minY = obj.position.y - obj.radius;
+            maxY = obj.position.y + obj.radius;
+        }
+        else if (obj.kind == RenderKind::Line)
+        {
+            minX = std::min(obj.position.x, obj.endPosition.x);
+            maxX = std::max(obj.position.x, obj.endPosition.x);
+            minY = std::min(obj.position.y, obj.endPosition.y);
+            maxY = std::max(obj.position.y, obj.endPosition.y);
+            margin = obj.lineWidth;
+        }
+        else if (obj.kind == RenderKind::Text && obj.shapedText)
+        {
+            const float width = obj.shapedText->width * obj.scale.x;
+            const float height = obj.shapedText->height * obj.scale.y;
+            minX = std::min(obj.position.x, obj.position.x + width);
+            maxX = std::max(obj.position.x, obj.position.x + width);
+            minY = std::min(obj.position.y, obj.position.y + height);
+            maxY = std::max(obj.position.y, obj.position.y + height);
+        }
+        else
+            return true;
+
+        const bool visible = !_culling || (maxX + margin >= 0.0f && minX - margin <= _hudResolution.x &&
+                                           maxY + margin >= 0.0f && minY - margin <= _hudResolution.y);
+        ++(visible ? _lastFrame.visible : _lastFrame.culled);
+        return visible;
+    }
+
+    // Queues a world object for this frame's instanced draws. Returns false
+    // when it has to be drawn on its own (text, mesh not uploaded).
+    bool GLEWSFMLRenderer::batchWorldObject(const RenderObject &obj)
+    {
+        if (obj.kind == RenderKind::Text)
+            return false;
+        BatchKey key;
+        InstanceData instance;
+        const Vector3f degrees{obj.rotation.x * 180.0f / 3.14159f,
+                               obj.rotation.y * 180.0f / 3.14159f,
+                               obj.rotation.z * 180.0f / 3.14159f};
+        composeModelMatrix(instance.model, obj.position, degrees, obj.scale);
+        instance.color[0] = obj.color.x;
+        instance.color[1] = obj.color.y;
+        instance.color[2] = obj.color.z;
+        instance.color[3] = 1.0f;
+
+        if (obj.kind == RenderKind::Sprite)
+        {
+            GLuint tex = _resourceManager.loadTexture(obj.texturePath);
+            if (!tex)
+                return true; // nothing to draw, as in the per-object path
+            applySpriteExtent(instance.model, 0.5f, 0.5f);
+            key.blended = true;
+            key.texture = tex;
+        }
+        else
+        {
+            const MeshData *mesh = _resourceManager.prepareMesh(obj.meshPath);
+            if (!mesh)
+                return true;
+            if (!mesh->vao)
+                return false;
+            key.mesh = mesh;
+            // Textured meshes are unlit, as in the immediate path.
+            key.texture = obj.texturePath.empty() ? 0 : _resourceManager.loadTexture(obj.texturePath);
+            key.blended = key.texture != 0;
+            key.lit = obj.texturePath.empty();
+        }
+        _batcher.add(key, instance);
+        return true;
+    }
+
+    void GLEWSFMLRenderer::drawBatches()
+    {
+        _batcher.build();
+        const auto &instances = _batcher.instances();
+        if (!instances.empty())
+        {
+            _meshPipeline.uploadInstances(instances.data(), instances.size());
+            for (const auto &batch : _batcher.batches())
+                _meshPipeline.drawInstanced(batch.key.mesh, batch.key.texture, batch.key.lit, batch.first, batch.count);
+        }
+        _batcher.clear();
+    }
+
+    void GLEWSFMLRenderer::publishRenderStats(std::chrono::steady_clock::time_point now)
+    {
+        ++_statsFrames;
+        if (now - _statsWindowStart < std::chrono::seconds(1))
+            return;
+
+        DrawStats &stats = _meshPipeline.stats();
+        const float frames = static_cast<float>(_statsFrames);
+        std::ostringstream oss;
+        oss.setf(std::ios::fixed);
+        oss.precision(1);
+        oss << "frames=" << _statsFrames
+            << " drawCalls=" << stats.drawCalls / frames
+            << " batches=" << stats.batches / frames
+            << " instances=" << stats.instances / frames
+            << " immediate=" << stats.immediate / frames
+            << " visible=" << _statsVisible / frames
+            << " culled=" << _statsCulled / frames
+            << " atlasMisses=" << _resourceManager.takeAtlasMisses()
+            << " assetsPending=" << _resourceManager.pendingAssets()
+            << " assetsFailed=" << _resourceManager.failedAssets()
+            << " assetLoadHist=";
+        const LoadTimeHistogram loadTimes = _resourceManager.takeLoadTimes();
+        for (size_t i = 0; i < loadTimes.counts.size(); ++i)
+            oss << (i ? "," : "") << loadTimes.counts[i];
+        sendMessage("RenderStats", oss.str());
+
+        stats = DrawStats{};
+        _statsFrames = 0;
+        _statsVisible = 0;
+        _statsCulled = 0;
+        _statsWindowStart = now;
+    }
+
+    // Compatibility fallback: one glVertex call per index, every frame.
+    void GLEWSFMLRenderer::drawMeshImmediate(const MeshData &mesh, const RenderObject &obj)
+    {
+        ++_meshPipeline.stats().immediate;
+        GLuint texID;
+
+        if (!obj.texturePath.empty())
+        {
+            texID = _resourceManager.loadTexture(obj.texturePath);
+            glDisable(GL_LIGHTING);
+            glEnable(GL_TEXTURE_2D);
+            glBindTexture(GL_TEXTURE_2D, texID);
+
+            glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+            glColor3f(obj.color.x, obj.color.y, obj.color.z);
+        }
+        else
+        {
+            glEnable(GL_LIGHTING);
+            glDisable(GL_TEXTURE_2D);
+            // Reset to modulate for non-textured objects (though disabled texture makes this moot)
+            glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+            glColor3f(obj.color.x, obj.color.y, obj.color.z);
+        }
+        glBegin(GL_TRIANGLES);
 
-        std::vector<uint32_t> flippedBuffer(_pixelBuffer.size());
-        for (unsigned int y = 0; y < _resolution.y; ++y)
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
         {
-            for (unsigned int x = 0; x < _resolution.x; ++x)
+            unsigned int idx0 = mesh.indices[i];
+            unsigned int idx1 = mesh.indices[i + 1];
+            unsigned int idx2 = mesh.indices[i + 2];
+
+            unsigned int uvIdx0 = 0;
+            unsigned int uvIdx1 = 0;
+            unsigned int uvIdx2 = 0;
+
+            if (i + 2 < mesh._textureIndices.size())
+            {
+                uvIdx0 = mesh._textureIndices[i];
+                uvIdx1 = mesh._textureIndices[i + 1];
+                uvIdx2 = mesh._textureIndices[i + 2];
+            }
+
+            if (idx0 * 3 + 2 < mesh.vertices.size() &&
+                idx1 * 3 + 2 < mesh.vertices.size() &&
+                idx2 * 3 + 2 < mesh.vertices.size())
             {
-                flippedBuffer[y * _resolution.x + x] = _pixelBuffer[(_resolution.y - 1 - y) * _resolution.x + x];
+
+                float x0 = mesh.vertices[idx0 * 3];
+                float y0 = mesh.vertices[idx0 * 3 + 1];
+                float z0 = mesh.vertices[idx0 * 3 + 2];
+
+                float x1 = mesh.vertices[idx1 * 3];
+                float y1 = mesh.vertices[idx1 * 3 + 1];
+                float z1 = mesh.vertices[idx1 * 3 + 2];
+
+                float x2 = mesh.vertices[idx2 * 3];
+                float y2 = mesh.vertices[idx2 * 3 + 1];
+                float z2 = mesh.vertices[idx2 * 3 + 2];
+
+                // Calculate face normal
+                float ux = x1 - x0;
+                float uy = y1 - y0;
+                float uz = z1 - z0;
+
+                float vx = x2 - x0;
+                float vy = y2 - y0;
+                float vz = z2 - z0;
+
+                float nx = uy * vz - uz * vy;
+                float ny = uz * vx - ux * vz;
+                float nz = ux * vy - uy * vx;
+
+                float len = sqrt(nx * nx + ny * ny + nz * nz);
+                if (len > 0)
+                {
+                    nx /= len;
+                    ny /= len;
+                    nz /= len;
+                    glNormal3f(nx, ny, nz);
+                }
+
+                if (!obj.texturePath.empty() && uvIdx0 * 2 + 1 < mesh.uvs.size())
+                {
+                    glTexCoord2f(mesh.uvs[uvIdx0 * 2], mesh.uvs[uvIdx0 * 2 + 1]);
+                }
+                glVertex3f(x0, y0, z0);
+                if (!obj.texturePath.empty() && uvIdx1 * 2 + 1 < mesh.uvs.size())
+                {
+                    glTexCoord2f(mesh.uvs[uvIdx1 * 2], mesh.uvs[uvIdx1 * 2 + 1]);
+                }
+                glVertex3f(x1, y1, z1);
+                if (!obj.texturePath.empty() && uvIdx2 * 2 + 1 < mesh.uvs.size())
+                {
+                    glTexCoord2f(mesh.uvs[uvIdx2 * 2], mesh.uvs[uvIdx2 * 2 + 1]);
+                }
+                glVertex3f(x2, y2, z2);
             }
         }
-        _pixelBuffer = flippedBuffer;
+        glEnd();
+        glDisable(GL_TEXTURE_2D);
+    }
 
-    // Prepend a small text header with the resolution so the consumer knows sizes
-    std::string header;
-    header.reserve(32);
-    header += std::to_string(_resolution.x);
-    header += ",";
-    header += std::to_string(_resolution.y);
-    header += ";";
+    bool GLEWSFMLRenderer::ensureFrameRing()
+    {
+        const std::size_t frameBytes = static_cast<std::size_t>(_resolution.x) * _resolution.y * sizeof(uint32_t);
+        if (_frameRing.isOpen() && _frameRing.slotCapacity() >= frameBytes)
+            return true;
+
+        // The consumer keeps its old mapping alive until it sees a ticket with
+        // the new name, so a resize always moves to a fresh shared object.
+        std::string name = FrameRing::makeName("frames", ++_frameRingGeneration);
+        if (!_frameRing.create(name, FrameRing::DEFAULT_SLOTS, frameBytes))
+        {
+            std::cerr << "[GLEWSFMLRenderer] Shared frame ring unavailable, falling back to bus transport" << std::endl;
+            _useFrameRing = false;
+            return false;
+        }
+        return true;
+    }
 
-    std::string pixelData(reinterpret_cast<const char *>(_pixelBuffer.data()),
-                  _pixelBuffer.size() * sizeof(uint32_t));
-    std::string message = header + pixelData;
-    sendMessage("ImageRendered", message);
+    void GLEWSFMLRenderer::publishFrame()
+    {
+        glPixelStorei(GL_PACK_ALIGNMENT, 4);
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (_useFrameRing && !_readback.asynchronous() && ensureFrameRing())
+        {
+            // Synchronous: read straight into shared memory, no CPU copy.
+            uint32_t slot = _frameRing.beginWrite();
+            glReadPixels(0, 0, _resolution.x, _resolution.y, GL_RGBA, GL_UNSIGNED_BYTE, _frameRing.slotData(slot));
+            _lastTicket = _frameRing.commit(slot, _resolution.x, _resolution.y);
+            sendMessage("ImageRendered", FrameRing::encodeTicket(_lastTicket));
+            return;
+        }
+
+        // Start this frame's readback and publish the one queued
+        // `latency` frames ago, whose transfer has had time to finish.
+        _readback.queue(_resolution.x, _resolution.y);
+        PixelReadback::Frame frame;
+        if (!_readback.acquire(frame))
+            return;
+        const std::size_t frameBytes = static_cast<std::size_t>(frame.width) * frame.height * sizeof(uint32_t);
+
+        if (_useFrameRing && ensureFrameRing())
+        {
+            // Rows stay bottom-up and the window manager flips when drawing.
+            // The one copy left: the mapped buffer is driver memory, not ours.
+            uint32_t slot = _frameRing.beginWrite();
+            std::memcpy(_frameRing.slotData(slot), frame.pixels, frameBytes);
+            _readback.release();
+            _lastTicket = _frameRing.commit(slot, frame.width, frame.height);
+            sendMessage("ImageRendered", FrameRing::encodeTicket(_lastTicket));
+            return;
+        }
+
+        // Legacy payload: a small text header with the resolution, then
+        // top-down rows copied in reverse order straight from the mapped buffer.
+        std::string header = std::to_string(frame.width) + "," + std::to_string(frame.height) + ";";
+        _busFrame.resize(header.size() + frameBytes);
+        std::memcpy(&_busFrame[0], header.data(), header.size());
+        _busPixelsOffset = header.size();
+
+        const std::size_t rowBytes = static_cast<std::size_t>(frame.width) * sizeof(uint32_t);
+        char *dst = &_busFrame[_busPixelsOffset];
+        for (uint32_t y = 0; y < frame.height; ++y)
+        {
+            std::memcpy(dst + y * rowBytes, frame.pixels + (frame.height - 1 - y) * rowBytes, rowBytes);
+        }
+        _readback.release();
+        _busResolution = {frame.width, frame.height};
+        sendMessage("ImageRendered", _busFrame);
     }
 
     std::vector<uint32_t> GLEWSFMLRenderer::getPixels() const
     {
-        return _pixelBuffer;
+        if (!_useFrameRing)
+        {
+            std::vector<uint32_t> pixels(static_cast<std::size_t>(_busResolution.x) * _busResolution.y);
+            if (!pixels.empty() && _busFrame.size() >= _busPixelsOffset + pixels.size() * sizeof(uint32_t))
+                std::memcpy(pixels.data(), _busFrame.data() + _busPixelsOffset, pixels.size() * sizeof(uint32_t));
+            return pixels;
+        }
+
+        // Shared-memory frames are bottom-up; hand callers the usual top-down image.
+        std::vector<uint32_t> pixels(static_cast<std::size_t>(_lastTicket.width) * _lastTicket.height);
+        const uint8_t *src = _frameRing.acquire(_lastTicket);
+        if (!src)
+            return pixels;
+        const uint32_t *rows = reinterpret_cast<const uint32_t *>(src);
+        for (unsigned int y = 0; y < _lastTicket.height; ++y)
+        {
+            std::copy_n(rows + static_cast<std::size_t>(_lastTicket.height - 1 - y) * _lastTicket.width,
+                        _lastTicket.width, pixels.begin() + static_cast<std::size_t>(y) * _lastTicket.width);
+        }
+        return pixels;
     }
 
     Vector2u GLEWSFMLRenderer::getResolution() const
@@ -1484,6 +1967,14 @@ int safeParseInt(const std::string& str, int fallback = 0) noexcept {
 
     void GLEWSFMLRenderer::initContext()
     {
+#ifdef RTYPE_RENDER_EGL
+        if (_headless)
+        {
+            if (!headless::createContext(_hdc, _hglrc))
+                std::cerr << "Failed to create headless EGL context" << std::endl;
+            return;
+        }
+#endif
 #ifdef _WIN32
         // Register a dummy window class
         WNDCLASSA wc = {0};
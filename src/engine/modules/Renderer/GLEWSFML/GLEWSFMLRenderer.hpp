@@ -8,8 +8,9 @@
  * @section channels_sub Subscribed Channels
  * | Channel | Payload | Description |
  * |---------|---------|-------------|
- * | `RenderEntityCommand` | Command string | Entity rendering commands |
+ * | `RenderEntityCommand` | Command string or busCodec batch | Entity rendering commands |
  * | `WindowResized` | "width,height" | Handle window resize |
+ * | `PreloadAssets` | "path;path;..." | Load models (.obj) and textures before they are used |
  * 
  * @section render_commands RenderEntityCommand Formats
  * - `CreateEntity:mesh:id` - Create entity with mesh
@@ -21,12 +22,59 @@
  * - `SetTexture:id:path` - Set entity texture
  * - `SetActiveCamera:id` - Set active camera
  * - `CreateParticleGenerator:params` - Create particle system
+ *
+ * Binary busCodec batches (see types/busCodec.hpp) are accepted for
+ * SetPosition, SetRotation, SetScale, SetColor and a combined SetTransform.
  * 
  * @section channels_pub Published Channels
  * | Channel | Payload | Description |
  * |---------|---------|-------------|
- * | `ImageRendered` | Raw pixel data | Frame ready for display |
+ * | `ImageRendered` | "ring:name:slot:seq:w,h" or "w,h;pixels" | Frame ready for display |
+ * | `RenderStats` | "frames=N drawCalls=F ... visible=F culled=F ... assetLoadHist=N,..." | Per-frame draw averages and asset loading, once per second |
+ *
+ * @section draw_path Draw Path
+ * Meshes, sprites, rectangles and circles are drawn from GPU buffers with a
+ * small shader program (see MeshPipeline.hpp). `RTYPE_RENDER_IMMEDIATE=1`,
+ * or a context without shaders/VAOs, keeps the immediate-mode path.
+ * With GL 3.3, textured sprites and uploaded meshes in the world pass are
+ * grouped by (mesh, texture, lighting) and each group is one instanced draw
+ * (see InstanceBatcher.hpp); opaque groups go first. HUD elements keep
+ * their per-object draws since their zOrder decides blending order.
+ * Text is laid out from a per font/size glyph atlas (see GlyphAtlas.hpp)
+ * and drawn as one batch of quads per text object.
+ *
+ * Objects are kept in per-kind dense arrays (see RenderObjectStore.hpp):
+ * the world pass walks meshes, sprites and texts, the HUD pass a draw list
+ * sorted by zOrder only when it changes.
+ *
+ * World objects whose bounding sphere is outside the camera frustum (see
+ * Frustum.hpp) and HUD objects outside the viewport are skipped before any
+ * GL work; `RTYPE_RENDER_CULLING=0` draws them anyway.
+ *
+ * Models are compiled once into `<model>.obj.rtmesh` files that later runs
+ * map and upload without parsing (see MeshCache.hpp).
+ *
+ * Textures and models are decoded by `RTYPE_ASSET_WORKERS` threads (default
+ * 2; see AssetLoader.hpp) and uploaded in a per-frame budget of
+ * `RTYPE_UPLOAD_BUDGET_KB`; objects whose assets are still loading are drawn
+ * with a white texture or a unit cube.
+ *
+ * @section frame_transport Frame Transport
+ * Frames are written into a shared-memory FrameRing (see types/frameRing.hpp)
+ * and only a ticket goes over the bus. Set `RTYPE_FRAME_TRANSPORT=bus` to
+ * send the full top-down pixel payload instead (the legacy format).
+ *
+ * Readback goes through a ring of pixel buffer objects (see
+ * PixelReadback.hpp): each frame is published `RTYPE_READBACK_LATENCY`
+ * frames after it was rendered (default 1, max 3) and copied once from the
+ * mapped buffer into the FrameRing slot. Latency 0 reads synchronously,
+ * straight into the slot.
  * 
+ * @section headless Headless Context
+ * `RTYPE_RENDER_HEADLESS=1` creates an offscreen EGL context instead of
+ * the hidden X11/GLX window (see HeadlessContext.hpp), for machines without
+ * a display. Text needs SFML, which still requires an X display.
+ *
  * @see docs/CHANNELS.md for complete channel reference
  */
 
@@ -41,8 +89,15 @@
 #include <chrono>
 #include "../I3DRenderer.hpp"
 #include "RenderStructs.hpp"
+#include "RenderObjectStore.hpp"
 #include "ResourceManager.hpp"
+#include "MeshPipeline.hpp"
+#include "InstanceBatcher.hpp"
+#include "Frustum.hpp"
 #include "ParticleSystem.hpp"
+#include "PixelReadback.hpp"
+#include "../../../types/frameRing.hpp"
+#include "../../../types/busCodec.hpp"
 
 namespace rtypeEngine {
 class GLEWSFMLRenderer : public I3DRenderer {
@@ -56,36 +111,76 @@ class GLEWSFMLRenderer : public I3DRenderer {
 
     void onRenderEntityCommand(const std::string& message);
     void handleWindowResized(const std::string& message);
+    void onPreloadAssets(const std::string& message);
 
     void clearBuffer() override;
     void render() override;
     std::vector<uint32_t> getPixels() const override;
     Vector2u getResolution() const override;
 
+    /// Timings and draw counts of the last render() call.
+    struct FrameProfile {
+        double renderMs = 0.0;   // whole frame, readback included
+        double readbackMs = 0.0; // publishFrame(): readback, copy, send
+        DrawStats draws;
+        uint32_t visible = 0; // world and HUD objects that passed culling
+        uint32_t culled = 0;  // outside the camera frustum or the HUD viewport
+    };
+    const FrameProfile& lastFrameProfile() const { return _lastFrame; }
+
+    /// Fixed frame time and particle seed instead of the wall clock and
+    /// random_device, for reproducible runs (render_bench).
+    void setDeterministic(float frameSeconds, uint32_t seed);
+
   private:
+    static constexpr double RENDER_TICK_RATE = 60.0;
+
     void createFramebuffer();
     void destroyFramebuffer();
     void ensureGLEWInitialized();
     void initContext();
+    void onBinaryRenderCommand(const std::string& message);
+    void setEntityPosition(RenderObject* obj, const std::string& id, const Vector3f& position);
+    void setEntityRotation(RenderObject* obj, const std::string& id, const Vector3f& rotation);
+    void setEntityScale(RenderObject* obj, const Vector3f& scale);
+    void setEntityColor(RenderObject* obj, const Vector3f& color);
+    void drawMeshImmediate(const MeshData& mesh, const RenderObject& obj);
+    void drawText(const RenderObject& obj, float alpha);
+    void finishPreloads();
+    bool worldVisible(const RenderObject& obj, const Frustum& frustum);
+    bool hudVisible(const RenderObject& obj);
+    bool batchWorldObject(const RenderObject& obj);
+    void drawBatches();
+    void publishRenderStats(std::chrono::steady_clock::time_point now);
+    bool ensureFrameRing();
+    void publishFrame();
 
     // Moved to ResourceManager
     // void loadMesh(const std::string& path);
     // GLuint loadTexture(const std::string& path);
-    // GLuint createTextTexture(const std::string& text, const std::string& fontPath, unsigned int fontSize, Vector3f color);
 
     Vector2u _resolution;
     Vector2u _hudResolution;
     bool _pendingResize = false;
+    std::vector<std::string> _pendingPreloads; // PreloadAssets waiting for the GL context
     Vector2u _newResolution;
     GLuint _framebuffer;
     GLuint _renderTexture;
     GLuint _depthBuffer;
-    std::vector<uint32_t> _pixelBuffer;
+    PixelReadback _readback;
+    std::string _busFrame;          // last legacy ImageRendered payload, reused
+    std::size_t _busPixelsOffset = 0;
+    Vector2u _busResolution{0, 0};
+    FrameRing _frameRing;
+    FrameRingTicket _lastTicket;
+    uint32_t _frameRingGeneration = 0;
+    bool _useFrameRing = true;
 
-    std::map<std::string, RenderObject> _renderObjects;
+    RenderObjectStore _objects;
     std::chrono::steady_clock::time_point _lastFrameTime;
 
     std::string _activeCameraId;
+    RenderHandle _activeCamera;
     Vector3f _cameraPos;
     Vector3f _cameraRot;
     Vector3f _lightPos;
@@ -93,11 +188,23 @@ class GLEWSFMLRenderer : public I3DRenderer {
     float _lightIntensity;
     std::string _activeLightId;
     bool _glewInitialized = false;
+    bool _headless = false; // EGL surfaceless context (RTYPE_RENDER_HEADLESS=1)
+    float _fixedTimestep = 0.0f;
+    FrameProfile _lastFrame;
     void* _hwnd = nullptr;
     void* _hdc = nullptr;
     void* _hglrc = nullptr;
 
     ResourceManager _resourceManager;
+    MeshPipeline _meshPipeline;
+    bool _retained = true; // false: immediate mode (RTYPE_RENDER_IMMEDIATE=1 or no shader support)
+    bool _instancing = false;
+    InstanceBatcher _batcher;
+    std::chrono::steady_clock::time_point _statsWindowStart;
+    uint32_t _statsFrames = 0;
+    uint64_t _statsVisible = 0;
+    uint64_t _statsCulled = 0;
+    bool _culling = true; // false: draw off-screen objects too (RTYPE_RENDER_CULLING=0)
     ParticleSystem _particleSystem;
 };
 }  // namespace rtypeEngine
@@ -0,0 +1,243 @@
+#include "GlyphAtlas.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+
+namespace rtypeEngine {
+
+    namespace {
+        constexpr int PADDING = 1; // transparent border kept around glyphs, as in sf::Text
+        constexpr char32_t FIRST_PRELOADED = U' ';
+        constexpr char32_t LAST_PRELOADED = U'~';
+    }
+
+    GlyphAtlas::GlyphAtlas(sf::Font& font, unsigned int characterSize)
+        : _font(font), _characterSize(characterSize)
+    {
+        // Room for a few hundred glyphs of this size.
+        const unsigned int cell = characterSize + 2 * PADDING + 2;
+        _side = 256;
+        while (_side < 4096 && _side * _side < 256u * cell * cell)
+            _side *= 2;
+        // Transparent white, so filtering at glyph edges does not darken them.
+        _pixels.resize(static_cast<size_t>(_side) * _side * 4);
+        for (size_t i = 0; i < _pixels.size(); i += 4)
+        {
+            _pixels[i] = _pixels[i + 1] = _pixels[i + 2] = 255;
+            _pixels[i + 3] = 0;
+        }
+        _dirtyTop = _side;
+        _dirtyBottom = 0;
+
+        std::vector<char32_t> ascii;
+        for (char32_t codepoint = FIRST_PRELOADED; codepoint <= LAST_PRELOADED; ++codepoint)
+            ascii.push_back(codepoint);
+        rasterize(ascii);
+    }
+
+    void GlyphAtlas::rasterize(const std::vector<char32_t>& codepoints)
+    {
+        // Load every glyph first, so one copy of SFML's page covers them all.
+        for (char32_t codepoint : codepoints)
+            _font.getGlyph(codepoint, _characterSize, false);
+        const sf::Image page = _font.getTexture(_characterSize).copyToImage();
+        const sf::Vector2u pageSize = page.getSize();
+        const uint8_t* source = page.getPixelsPtr();
+
+        for (char32_t codepoint : codepoints)
+        {
+            const sf::Glyph& sfGlyph = _font.getGlyph(codepoint, _characterSize, false);
+            Glyph& glyph = _glyphs[codepoint];
+            glyph.advance = sfGlyph.advance;
+            glyph.left = sfGlyph.bounds.position.x;
+            glyph.top = sfGlyph.bounds.position.y;
+            glyph.right = sfGlyph.bounds.position.x + sfGlyph.bounds.size.x;
+            glyph.bottom = sfGlyph.bounds.position.y + sfGlyph.bounds.size.y;
+
+            const sf::IntRect& rect = sfGlyph.textureRect;
+            if (rect.size.x <= 0 || rect.size.y <= 0)
+                continue;
+            const int sourceX = rect.position.x - PADDING;
+            const int sourceY = rect.position.y - PADDING;
+            const unsigned int width = rect.size.x + 2 * PADDING;
+            const unsigned int height = rect.size.y + 2 * PADDING;
+            if (sourceX < 0 || sourceY < 0 || sourceX + width > pageSize.x || sourceY + height > pageSize.y)
+                continue;
+
+            unsigned int x = 0, y = 0;
+            if (!pack(width, height, x, y))
+            {
+                if (!_full)
+                    std::cerr << "[GlyphAtlas] Atlas full (" << _side << "px, size " << _characterSize
+                              << "), further glyphs are not drawn" << std::endl;
+                _full = true;
+                continue;
+            }
+            for (unsigned int row = 0; row < height; ++row)
+            {
+                std::memcpy(&_pixels[(static_cast<size_t>(y + row) * _side + x) * 4],
+                            source + (static_cast<size_t>(sourceY + row) * pageSize.x + sourceX) * 4,
+                            width * 4);
+            }
+            const float side = static_cast<float>(_side);
+            glyph.u0 = x / side;
+            glyph.v0 = y / side;
+            glyph.u1 = (x + width) / side;
+            glyph.v1 = (y + height) / side;
+            glyph.visible = true;
+            _dirtyTop = std::min(_dirtyTop, y);
+            _dirtyBottom = std::max(_dirtyBottom, y + height);
+        }
+    }
+
+    bool GlyphAtlas::pack(unsigned int width, unsigned int height, unsigned int& x, unsigned int& y)
+    {
+        if (width > _side)
+            return false;
+        if (_penX + width > _side)
+        {
+            _penX = 0;
+            _penY += _shelfHeight;
+            _shelfHeight = 0;
+        }
+        if (_penY + height > _side)
+            return false;
+        x = _penX;
+        y = _penY;
+        _penX += width;
+        _shelfHeight = std::max(_shelfHeight, height);
+        return true;
+    }
+
+    std::shared_ptr<const ShapedText> GlyphAtlas::shape(const std::string& text)
+    {
+        auto cached = _shaped.find(text);
+        if (cached != _shaped.end())
+            return cached->second;
+
+        // Same conversion as sf::Text::setString(std::string).
+        const sf::String string(text);
+
+        std::vector<char32_t> missing;
+        for (char32_t codepoint : string)
+        {
+            if (codepoint == U'\n' || codepoint == U'\r' || codepoint == U'\t')
+                continue;
+            if (_glyphs.find(codepoint) == _glyphs.end() &&
+                std::find(missing.begin(), missing.end(), codepoint) == missing.end())
+                missing.push_back(codepoint);
+        }
+        if (!missing.empty())
+        {
+            _misses += static_cast<uint32_t>(missing.size());
+            rasterize(missing);
+        }
+
+        // Pen walk of sf::Text: baseline of the first line at characterSize.
+        struct Placement {
+            float x, y;
+            const Glyph* glyph;
+        };
+        std::vector<Placement> placements;
+        placements.reserve(string.getSize());
+        const float whitespace = _glyphs[U' '].advance;
+        const float lineSpacing = _font.getLineSpacing(_characterSize);
+        float x = 0.0f;
+        float y = static_cast<float>(_characterSize);
+        float maxX = 0.0f;
+        float maxY = 0.0f;
+        char32_t previous = 0;
+        for (char32_t codepoint : string)
+        {
+            if (codepoint == U'\r')
+                continue;
+            x += _font.getKerning(previous, codepoint, _characterSize);
+            previous = codepoint;
+
+            if (codepoint == U' ' || codepoint == U'\t' || codepoint == U'\n')
+            {
+                if (codepoint == U' ')
+                    x += whitespace;
+                else if (codepoint == U'\t')
+                    x += whitespace * 4;
+                else
+                {
+                    y += lineSpacing;
+                    x = 0.0f;
+                }
+                maxX = std::max(maxX, x);
+                maxY = std::max(maxY, y);
+                continue;
+            }
+
+            const Glyph& glyph = _glyphs[codepoint];
+            placements.push_back({x, y, &glyph});
+            maxX = std::max(maxX, x + glyph.right);
+            maxY = std::max(maxY, y + glyph.bottom);
+            x += glyph.advance;
+        }
+
+        auto shaped = std::make_shared<ShapedText>();
+        shaped->atlas = this;
+        shaped->width = std::max(1.0f, std::ceil(maxX));
+        shaped->height = std::max(1.0f, std::ceil(maxY));
+        shaped->vertices.reserve(placements.size() * 6);
+        for (const Placement& placement : placements)
+        {
+            const Glyph& glyph = *placement.glyph;
+            if (!glyph.visible)
+                continue;
+            // Flip to y up inside the box.
+            const float x0 = placement.x + glyph.left - PADDING;
+            const float x1 = placement.x + glyph.right + PADDING;
+            const float y0 = shaped->height - (placement.y + glyph.bottom + PADDING);
+            const float y1 = shaped->height - (placement.y + glyph.top - PADDING);
+            const GpuVertex bottomLeft{{x0, y0, 0.0f}, {0.0f, 0.0f, 1.0f}, {glyph.u0, glyph.v1}};
+            const GpuVertex bottomRight{{x1, y0, 0.0f}, {0.0f, 0.0f, 1.0f}, {glyph.u1, glyph.v1}};
+            const GpuVertex topRight{{x1, y1, 0.0f}, {0.0f, 0.0f, 1.0f}, {glyph.u1, glyph.v0}};
+            const GpuVertex topLeft{{x0, y1, 0.0f}, {0.0f, 0.0f, 1.0f}, {glyph.u0, glyph.v0}};
+            shaped->vertices.insert(shaped->vertices.end(),
+                                    {bottomLeft, bottomRight, topRight, bottomLeft, topRight, topLeft});
+        }
+
+        if (_shaped.size() >= MAX_SHAPED)
+        {
+            for (auto it = _shaped.begin(); it != _shaped.end();)
+                it = it->second.use_count() == 1 ? _shaped.erase(it) : std::next(it);
+        }
+        _shaped[text] = shaped;
+        return shaped;
+    }
+
+    GLuint GlyphAtlas::texture()
+    {
+        if (!_texture)
+        {
+            glGenTextures(1, &_texture);
+            glBindTexture(GL_TEXTURE_2D, _texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, _side, _side, 0, GL_RGBA, GL_UNSIGNED_BYTE, _pixels.data());
+        }
+        else if (_dirtyBottom > _dirtyTop)
+        {
+            glBindTexture(GL_TEXTURE_2D, _texture);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _dirtyTop, _side, _dirtyBottom - _dirtyTop, GL_RGBA, GL_UNSIGNED_BYTE,
+                            &_pixels[static_cast<size_t>(_dirtyTop) * _side * 4]);
+        }
+        _dirtyTop = _side;
+        _dirtyBottom = 0;
+        return _texture;
+    }
+
+    void GlyphAtlas::releaseTexture()
+    {
+        if (_texture)
+            glDeleteTextures(1, &_texture);
+        _texture = 0;
+    }
+}
@@ -0,0 +1,87 @@
+/**
+ * @file GlyphAtlas.hpp
+ * @brief Per font and size glyph atlas, and the shaped-string cache built on it
+ *
+ * @details The first string shaped for a (font, size) pair rasterizes
+ * printable ASCII through SFML and packs it into one RGBA texture. Text is
+ * then laid out from the cached glyph metrics into textured triangles
+ * (ShapedText) and drawn in one call, so changing a score or a HUD label
+ * no longer rasterizes the string or allocates a texture.
+ *
+ * Glyphs outside the atlas are rasterized when first met and counted as
+ * misses. Shaping happens while handling commands; the texture is created
+ * or updated on the render thread by texture(), so SFML never runs with
+ * the renderer's context current.
+ *
+ * The layout reproduces sf::Text (kerning, whitespace, new lines, one pixel
+ * of padding around glyphs), and its box matches the texture the renderer
+ * used to create per string, so text keeps its size and position.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <GL/glew.h>
+#include <SFML/Graphics.hpp>
+#include "MeshPipeline.hpp"
+
+namespace rtypeEngine {
+
+    class GlyphAtlas;
+
+    struct ShapedText {
+        /// Six vertices per glyph, in pixels, y up from the bottom of the box.
+        std::vector<GpuVertex> vertices;
+        float width = 0.0f;
+        float height = 0.0f;
+        GlyphAtlas* atlas = nullptr;
+    };
+
+    class GlyphAtlas {
+    public:
+        /// Shaped strings kept per atlas; unused ones are dropped past this.
+        static constexpr size_t MAX_SHAPED = 256;
+
+        GlyphAtlas(sf::Font& font, unsigned int characterSize);
+        ~GlyphAtlas() = default;
+
+        /// Cached layout of `text`, shaped on first use.
+        std::shared_ptr<const ShapedText> shape(const std::string& text);
+
+        /// Atlas texture with pending glyphs uploaded (GL context current).
+        GLuint texture();
+        void releaseTexture();
+
+        /// Glyphs rasterized after the atlas was built.
+        uint32_t misses() const { return _misses; }
+
+    private:
+        struct Glyph {
+            float advance = 0.0f;
+            float left = 0.0f, top = 0.0f, right = 0.0f, bottom = 0.0f; // from the pen, y down
+            float u0 = 0.0f, v0 = 0.0f, u1 = 0.0f, v1 = 0.0f;
+            bool visible = false;
+        };
+
+        void rasterize(const std::vector<char32_t>& codepoints);
+        bool pack(unsigned int width, unsigned int height, unsigned int& x, unsigned int& y);
+
+        sf::Font& _font;
+        unsigned int _characterSize;
+        std::unordered_map<char32_t, Glyph> _glyphs;
+        std::unordered_map<std::string, std::shared_ptr<ShapedText>> _shaped;
+        uint32_t _misses = 0;
+
+        // Shelf packing into a square RGBA image mirrored by _texture
+        unsigned int _side = 0;
+        std::vector<uint8_t> _pixels;
+        unsigned int _penX = 0, _penY = 0, _shelfHeight = 0;
+        bool _full = false;
+        GLuint _texture = 0;
+        unsigned int _dirtyTop = 0, _dirtyBottom = 0; // rows to upload
+    };
+}
@@ -0,0 +1,103 @@
+/**
+ * @file HeadlessContext.hpp
+ * @brief Offscreen OpenGL context through EGL, without a window system
+ *
+ * @details Used when `RTYPE_RENDER_HEADLESS=1` (e.g. render_bench on a CI
+ * machine without X or a GPU). The context is created on Mesa's surfaceless
+ * platform when available, falling back to the default EGL display, and
+ * binds the desktop OpenGL API so the compatibility-profile code paths keep
+ * working (Mesa llvmpipe provides them in software). The renderer only
+ * draws into its own framebuffer object, so no surface is created.
+ *
+ * Compiled in when the module is built with `RTYPE_RENDER_EGL` (libEGL
+ * found by CMake).
+ */
+
+#pragma once
+
+#ifdef RTYPE_RENDER_EGL
+
+#include <GL/glew.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <iostream>
+
+namespace rtypeEngine {
+namespace headless {
+
+    inline bool createContext(void*& display, void*& context)
+    {
+        EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay)
+            eglDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+#endif
+        if (eglDisplay == EGL_NO_DISPLAY)
+            eglDisplay = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+        EGLint major = 0, minor = 0;
+        if (eglDisplay == EGL_NO_DISPLAY || !eglInitialize(eglDisplay, &major, &minor))
+        {
+            std::cerr << "[HeadlessContext] No EGL display (error 0x" << std::hex << eglGetError() << std::dec << ")" << std::endl;
+            return false;
+        }
+        if (!eglBindAPI(EGL_OPENGL_API))
+        {
+            std::cerr << "[HeadlessContext] EGL implementation has no desktop OpenGL" << std::endl;
+            eglTerminate(eglDisplay);
+            return false;
+        }
+
+        const EGLint configAttribs[] = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE};
+        EGLConfig config = nullptr;
+        EGLint configCount = 0;
+        eglChooseConfig(eglDisplay, configAttribs, &config, 1, &configCount);
+
+        // Surfaceless contexts do not need a config (EGL_KHR_no_config_context).
+        EGLContext eglContext = eglCreateContext(eglDisplay, configCount > 0 ? config : nullptr, EGL_NO_CONTEXT, nullptr);
+        if (eglContext == EGL_NO_CONTEXT ||
+            !eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, eglContext))
+        {
+            std::cerr << "[HeadlessContext] Failed to create a surfaceless context (error 0x" << std::hex
+                      << eglGetError() << std::dec << ")" << std::endl;
+            if (eglContext != EGL_NO_CONTEXT)
+                eglDestroyContext(eglDisplay, eglContext);
+            eglTerminate(eglDisplay);
+            return false;
+        }
+
+        std::cout << "[HeadlessContext] EGL " << major << "." << minor << ", "
+                  << reinterpret_cast<const char*>(glGetString(GL_RENDERER)) << std::endl;
+        display = eglDisplay;
+        context = eglContext;
+        return true;
+    }
+
+    inline void makeCurrent(void* display, void* context)
+    {
+        eglMakeCurrent(static_cast<EGLDisplay>(display), EGL_NO_SURFACE, EGL_NO_SURFACE, static_cast<EGLContext>(context));
+    }
+
+    inline void releaseCurrent(void* display)
+    {
+        eglMakeCurrent(static_cast<EGLDisplay>(display), EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    }
+
+    inline void destroyContext(void*& display, void*& context)
+    {
+        if (!display)
+            return;
+        releaseCurrent(display);
+        if (context)
+            eglDestroyContext(static_cast<EGLDisplay>(display), static_cast<EGLContext>(context));
+        eglTerminate(static_cast<EGLDisplay>(display));
+        display = nullptr;
+        context = nullptr;
+    }
+
+} // namespace headless
+} // namespace rtypeEngine
+
+#endif // RTYPE_RENDER_EGL
@@ -0,0 +1,132 @@
+/**
+ * @file InstanceBatcher.hpp
+ * @brief Groups world objects by geometry and material for instanced draws
+ *
+ * @details The renderer queues one InstanceData (model matrix + color) per
+ * world object under a BatchKey; build() packs every group into one
+ * contiguous array so the whole frame is uploaded with a single buffer
+ * update, and each group becomes one MeshPipeline::drawInstanced call.
+ *
+ * Groups are kept from frame to frame so their storage is reused; a group
+ * left empty for a whole frame is dropped on the next clear().
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <vector>
+#include "MeshPipeline.hpp"
+
+namespace rtypeEngine {
+
+    struct BatchKey {
+        bool blended = false;          // textured: drawn after the opaque groups
+        const MeshData* mesh = nullptr; // nullptr: the unit quad (sprites)
+        GLuint texture = 0;
+        bool lit = false;
+
+        bool operator<(const BatchKey& other) const
+        {
+            return std::tie(blended, mesh, texture, lit) <
+                   std::tie(other.blended, other.mesh, other.texture, other.lit);
+        }
+    };
+
+    class InstanceBatcher {
+    public:
+        struct Batch {
+            BatchKey key;
+            size_t first = 0;
+            size_t count = 0;
+        };
+
+        void add(const BatchKey& key, const InstanceData& instance)
+        {
+            _groups[key].push_back(instance);
+        }
+
+        /// Packs the queued groups; results stay valid until clear().
+        void build()
+        {
+            _instances.clear();
+            _batches.clear();
+            for (const auto& group : _groups)
+            {
+                if (group.second.empty())
+                    continue;
+                _batches.push_back({group.first, _instances.size(), group.second.size()});
+                _instances.insert(_instances.end(), group.second.begin(), group.second.end());
+            }
+        }
+
+        const std::vector<InstanceData>& instances() const { return _instances; }
+        const std::vector<Batch>& batches() const { return _batches; }
+
+        void clear()
+        {
+            for (auto it = _groups.begin(); it != _groups.end();)
+            {
+                if (it->second.empty())
+                {
+                    it = _groups.erase(it);
+                }
+                else
+                {
+                    it->second.clear();
+                    ++it;
+                }
+            }
+            _instances.clear();
+            _batches.clear();
+        }
+
+    private:
+        std::map<BatchKey, std::vector<InstanceData>> _groups;
+        std::vector<InstanceData> _instances;
+        std::vector<Batch> _batches;
+    };
+
+    /**
+     * Column-major translate * rotX * rotY * rotZ * scale, the same matrix
+     * the world pass builds with glTranslatef/glRotatef/glScalef. Angles in
+     * degrees, as passed to glRotatef.
+     */
+    inline void composeModelMatrix(float out[16], const Vector3f& position, const Vector3f& degrees, const Vector3f& scale)
+    {
+        const float toRadians = 3.14159265f / 180.0f;
+        const float cx = std::cos(degrees.x * toRadians), sx = std::sin(degrees.x * toRadians);
+        const float cy = std::cos(degrees.y * toRadians), sy = std::sin(degrees.y * toRadians);
+        const float cz = std::cos(degrees.z * toRadians), sz = std::sin(degrees.z * toRadians);
+
+        out[0] = cy * cz * scale.x;
+        out[1] = (cx * sz + sx * sy * cz) * scale.x;
+        out[2] = (sx * sz - cx * sy * cz) * scale.x;
+        out[3] = 0.0f;
+        out[4] = -cy * sz * scale.y;
+        out[5] = (cx * cz - sx * sy * sz) * scale.y;
+        out[6] = (sx * cz + cx * sy * sz) * scale.y;
+        out[7] = 0.0f;
+        out[8] = sy * scale.z;
+        out[9] = -sx * cy * scale.z;
+        out[10] = cx * cy * scale.z;
+        out[11] = 0.0f;
+        out[12] = position.x;
+        out[13] = position.y;
+        out[14] = position.z;
+        out[15] = 1.0f;
+    }
+
+    /// Follows `model` with translate(-w, -h, 0) * scale(2w, 2h, 1): the unit quad as a centred sprite.
+    inline void applySpriteExtent(float model[16], float w, float h)
+    {
+        for (int row = 0; row < 3; ++row)
+        {
+            model[12 + row] -= w * model[row] + h * model[4 + row];
+            model[row] *= 2.0f * w;
+            model[4 + row] *= 2.0f * h;
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#include "MeshCache.hpp"
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rtypeEngine {
+
+    bool MeshSourceStamp::read(const std::string& path, MeshSourceStamp& stamp)
+    {
+        std::error_code error;
+        const auto size = std::filesystem::file_size(path, error);
+        if (error)
+            return false;
+        const auto time = std::filesystem::last_write_time(path, error);
+        if (error)
+            return false;
+        stamp.size = static_cast<uint64_t>(size);
+        stamp.time = static_cast<int64_t>(time.time_since_epoch().count());
+        return true;
+    }
+
+    std::shared_ptr<CompiledMesh> CompiledMesh::fromBuffers(std::vector<GpuVertex> vertices, std::vector<uint32_t> indices)
+    {
+        std::shared_ptr<CompiledMesh> mesh(new CompiledMesh());
+        mesh->_ownedVertices = std::move(vertices);
+        mesh->_ownedIndices = std::move(indices);
+        mesh->_vertices = mesh->_ownedVertices.data();
+        mesh->_indices = mesh->_ownedIndices.data();
+        mesh->_vertexCount = static_cast<uint32_t>(mesh->_ownedVertices.size());
+        mesh->_indexCount = static_cast<uint32_t>(mesh->_ownedIndices.size());
+        return mesh;
+    }
+
+    std::shared_ptr<CompiledMesh> CompiledMesh::map(const std::string& cachePath, const MeshSourceStamp& stamp)
+    {
+        std::shared_ptr<CompiledMesh> mesh(new CompiledMesh());
+#ifdef _WIN32
+        HANDLE file = CreateFileA(cachePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return nullptr;
+        mesh->_file = file;
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(MeshFileHeader)))
+            return nullptr;
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping)
+            return nullptr;
+        mesh->_mapping = mapping;
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view)
+            return nullptr;
+        mesh->_base = view;
+        mesh->_size = static_cast<size_t>(size.QuadPart);
+#else
+        int fd = ::open(cachePath.c_str(), O_RDONLY);
+        if (fd < 0)
+            return nullptr;
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(MeshFileHeader)))
+        {
+            ::close(fd);
+            return nullptr;
+        }
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED)
+            return nullptr;
+        mesh->_base = view;
+        mesh->_size = static_cast<size_t>(info.st_size);
+#endif
+
+        MeshFileHeader header;
+        std::memcpy(&header, mesh->_base, sizeof(header));
+        const size_t expected = sizeof(MeshFileHeader) + sizeof(GpuVertex) * static_cast<size_t>(header.vertexCount) +
+                                sizeof(uint32_t) * static_cast<size_t>(header.indexCount);
+        if (header.magic != MeshFileHeader::MAGIC || header.version != MeshFileHeader::VERSION ||
+            header.sourceSize != stamp.size || header.sourceTime != stamp.time || expected != mesh->_size)
+            return nullptr;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(mesh->_base);
+        mesh->_vertices = reinterpret_cast<const GpuVertex*>(bytes + sizeof(MeshFileHeader));
+        mesh->_indices = reinterpret_cast<const uint32_t*>(bytes + sizeof(MeshFileHeader) + sizeof(GpuVertex) * header.vertexCount);
+        mesh->_vertexCount = header.vertexCount;
+        mesh->_indexCount = header.indexCount;
+        // A damaged file must not send the GPU out of bounds.
+        for (uint32_t i = 0; i < mesh->_indexCount; ++i)
+        {
+            if (mesh->_indices[i] >= mesh->_vertexCount)
+                return nullptr;
+        }
+        return mesh;
+    }
+
+    bool CompiledMesh::write(const std::string& cachePath, const MeshSourceStamp& stamp) const
+    {
+        MeshFileHeader header;
+        header.magic = MeshFileHeader::MAGIC;
+        header.version = MeshFileHeader::VERSION;
+        header.sourceSize = stamp.size;
+        header.sourceTime = stamp.time;
+        header.vertexCount = _vertexCount;
+        header.indexCount = _indexCount;
+
+        const std::string temporary = cachePath + ".tmp";
+        {
+            std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+            if (!file)
+                return false;
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(_vertices), sizeof(GpuVertex) * _vertexCount);
+            file.write(reinterpret_cast<const char*>(_indices), sizeof(uint32_t) * _indexCount);
+            if (!file)
+            {
+                file.close();
+                std::error_code ignored;
+                std::filesystem::remove(temporary, ignored);
+                return false;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary, cachePath, error);
+        if (error)
+        {
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+        return true;
+    }
+
+    CompiledMesh::~CompiledMesh()
+    {
+#ifdef _WIN32
+        if (_base)
+            UnmapViewOfFile(_base);
+        if (_mapping)
+            CloseHandle(static_cast<HANDLE>(_mapping));
+        if (_file)
+            CloseHandle(static_cast<HANDLE>(_file));
+#else
+        if (_base)
+            munmap(_base, _size);
+#endif
+    }
+}
@@ -0,0 +1,93 @@
+/**
+ * @file MeshCache.hpp
+ * @brief Compiled meshes and their binary cache files
+ *
+ * @details A CompiledMesh is the upload-ready form of a model: interleaved
+ * GpuVertex data and 32-bit indices, exactly what goes into the VBO/IBO.
+ * The first time an OBJ is parsed, its compiled form is written next to it
+ * as `<model>.obj.rtmesh`; later runs map that file and hand the mapped
+ * memory straight to glBufferData, skipping the text parser.
+ *
+ * File layout (native endianness):
+ * | Offset | Content |
+ * |--------|---------|
+ * | 0  | MeshFileHeader (32 bytes) |
+ * | 32 | GpuVertex[vertexCount] (32 bytes each) |
+ * | .. | uint32_t[indexCount] |
+ *
+ * The header records the size and modification time of the OBJ it was
+ * built from; a cache file that does not match them, or is truncated or
+ * from another format version, is ignored and rewritten.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MeshPipeline.hpp"
+
+namespace rtypeEngine {
+
+    constexpr const char* MESH_CACHE_SUFFIX = ".rtmesh";
+
+    /// Identifies the source file a cache entry was built from.
+    struct MeshSourceStamp {
+        uint64_t size = 0;
+        int64_t time = 0;
+
+        static bool read(const std::string& path, MeshSourceStamp& stamp);
+    };
+
+    struct MeshFileHeader {
+        static constexpr uint32_t MAGIC = 0x534D5452; // "RTMS"
+        static constexpr uint32_t VERSION = 1;
+
+        uint32_t magic;
+        uint32_t version;
+        uint64_t sourceSize;
+        int64_t sourceTime;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+    };
+    static_assert(sizeof(MeshFileHeader) == 32, "MeshFileHeader is part of the file format");
+    static_assert(sizeof(GpuVertex) == 32, "GpuVertex is part of the file format");
+
+    class CompiledMesh {
+    public:
+        ~CompiledMesh();
+        CompiledMesh(const CompiledMesh&) = delete;
+        CompiledMesh& operator=(const CompiledMesh&) = delete;
+
+        static std::shared_ptr<CompiledMesh> fromBuffers(std::vector<GpuVertex> vertices, std::vector<uint32_t> indices);
+        /// Maps `cachePath`; null when missing, stale or malformed.
+        static std::shared_ptr<CompiledMesh> map(const std::string& cachePath, const MeshSourceStamp& stamp);
+        /// Writes the cache file (through a temporary file, then renamed).
+        bool write(const std::string& cachePath, const MeshSourceStamp& stamp) const;
+
+        const GpuVertex* vertices() const { return _vertices; }
+        uint32_t vertexCount() const { return _vertexCount; }
+        const uint32_t* indices() const { return _indices; }
+        uint32_t indexCount() const { return _indexCount; }
+        bool mapped() const { return _base != nullptr; }
+
+    private:
+        CompiledMesh() = default;
+
+        std::vector<GpuVertex> _ownedVertices;
+        std::vector<uint32_t> _ownedIndices;
+        const GpuVertex* _vertices = nullptr;
+        const uint32_t* _indices = nullptr;
+        uint32_t _vertexCount = 0;
+        uint32_t _indexCount = 0;
+
+        void* _base = nullptr; // mapped file
+        size_t _size = 0;
+#ifdef _WIN32
+        void* _file = nullptr;
+        void* _mapping = nullptr;
+#endif
+    };
+}
@@ -0,0 +1,402 @@
+#include "MeshPipeline.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace rtypeEngine {
+
+namespace {
+constexpr float TWO_PI = 6.28318531f;
+
+// Lighting per vertex, as the fixed-function pipeline does it: global
+// ambient + light ambient + diffuse from GL_LIGHT0 (a point light).
+// The instance model is translate * rotate * scale, so its inverse
+// transpose is each column divided by its squared length.
+const char* VERTEX_SHADER = R"(#version 120
+attribute vec3 a_position;
+attribute vec3 a_normal;
+attribute vec2 a_uv;
+attribute vec4 a_model0;
+attribute vec4 a_model1;
+attribute vec4 a_model2;
+attribute vec4 a_model3;
+attribute vec4 a_color;
+uniform bool u_lit;
+varying vec3 v_light;
+varying vec2 v_uv;
+varying vec4 v_color;
+
+void main()
+{
+    mat4 model = mat4(a_model0, a_model1, a_model2, a_model3);
+    vec4 eye = gl_ModelViewMatrix * (model * vec4(a_position, 1.0));
+    v_light = vec3(1.0);
+    if (u_lit)
+    {
+        vec3 normal = a_model0.xyz * (a_normal.x / max(dot(a_model0.xyz, a_model0.xyz), 1e-8)) +
+                      a_model1.xyz * (a_normal.y / max(dot(a_model1.xyz, a_model1.xyz), 1e-8)) +
+                      a_model2.xyz * (a_normal.z / max(dot(a_model2.xyz, a_model2.xyz), 1e-8));
+        vec3 n = normalize(gl_NormalMatrix * normal);
+        vec4 light = gl_LightSource[0].position;
+        vec3 l = normalize(light.xyz - eye.xyz * light.w);
+        v_light = gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb +
+                  gl_LightSource[0].diffuse.rgb * max(dot(n, l), 0.0);
+    }
+    v_uv = a_uv;
+    v_color = a_color;
+    gl_Position = gl_ProjectionMatrix * eye;
+}
+)";
+
+const char* FRAGMENT_SHADER = R"(#version 120
+uniform vec4 u_color;
+uniform bool u_useTexture;
+uniform sampler2D u_texture;
+varying vec3 v_light;
+varying vec2 v_uv;
+varying vec4 v_color;
+
+void main()
+{
+    vec4 base = u_color * v_color;
+    vec4 color = vec4(clamp(base.rgb * v_light, 0.0, 1.0), base.a);
+    if (u_useTexture)
+        color *= texture2D(u_texture, v_uv);
+    gl_FragColor = color;
+}
+)";
+
+GLuint compileShader(GLenum type, const char* source)
+{
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, nullptr);
+    glCompileShader(shader);
+
+    GLint ok = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (ok != GL_TRUE)
+    {
+        GLint length = 0;
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+        std::string log(static_cast<size_t>(std::max(length, 1)), '\0');
+        glGetShaderInfoLog(shader, length, nullptr, &log[0]);
+        std::cerr << "[MeshPipeline] Shader compile failed: " << log << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+} // namespace
+
+    bool MeshPipeline::init()
+    {
+        if (_program)
+            return true;
+        if (!GLEW_VERSION_2_0 || !(GLEW_VERSION_3_0 || GLEW_ARB_vertex_array_object))
+        {
+            std::cerr << "[MeshPipeline] Shaders or vertex array objects unsupported" << std::endl;
+            return false;
+        }
+
+        GLuint vertex = compileShader(GL_VERTEX_SHADER, VERTEX_SHADER);
+        GLuint fragment = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER);
+        if (!vertex || !fragment)
+        {
+            if (vertex)
+                glDeleteShader(vertex);
+            if (fragment)
+                glDeleteShader(fragment);
+            return false;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glBindAttribLocation(program, ATTRIB_POSITION, "a_position");
+        glBindAttribLocation(program, ATTRIB_NORMAL, "a_normal");
+        glBindAttribLocation(program, ATTRIB_UV, "a_uv");
+        glBindAttribLocation(program, ATTRIB_MODEL + 0, "a_model0");
+        glBindAttribLocation(program, ATTRIB_MODEL + 1, "a_model1");
+        glBindAttribLocation(program, ATTRIB_MODEL + 2, "a_model2");
+        glBindAttribLocation(program, ATTRIB_MODEL + 3, "a_model3");
+        glBindAttribLocation(program, ATTRIB_COLOR, "a_color");
+        glLinkProgram(program);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+
+        GLint ok = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &ok);
+        if (ok != GL_TRUE)
+        {
+            GLint length = 0;
+            glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+            std::string log(static_cast<size_t>(std::max(length, 1)), '\0');
+            glGetProgramInfoLog(program, length, nullptr, &log[0]);
+            std::cerr << "[MeshPipeline] Program link failed: " << log << std::endl;
+            glDeleteProgram(program);
+            return false;
+        }
+
+        _program = program;
+        _colorLoc = glGetUniformLocation(_program, "u_color");
+        _useTextureLoc = glGetUniformLocation(_program, "u_useTexture");
+        _litLoc = glGetUniformLocation(_program, "u_lit");
+        glUseProgram(_program);
+        glUniform1i(glGetUniformLocation(_program, "u_texture"), 0);
+        glUseProgram(0);
+        resetInstanceAttribs();
+
+        _instancing = GLEW_VERSION_3_3 != 0;
+        if (_instancing)
+            glGenBuffers(1, &_instanceVbo);
+
+        const GpuVertex quad[4] = {
+            {{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 1.0f}},
+            {{1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 1.0f}},
+            {{1.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {1.0f, 0.0f}},
+            {{0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}},
+        };
+        _quad = buildShape(quad, 4);
+
+        std::cout << "[MeshPipeline] Retained-mode rendering enabled"
+                  << (_instancing ? " (instanced)" : "") << std::endl;
+        return true;
+    }
+
+    void MeshPipeline::destroy()
+    {
+        end();
+        destroyShape(_quad);
+        for (auto& pair : _circles)
+            destroyShape(pair.second);
+        _circles.clear();
+        destroyShape(_stream);
+        _streamCapacity = 0;
+        if (_instanceVbo)
+        {
+            glDeleteBuffers(1, &_instanceVbo);
+            _instanceVbo = 0;
+            _instanceCapacity = 0;
+        }
+        _instancing = false;
+        if (_program)
+        {
+            glDeleteProgram(_program);
+            _program = 0;
+        }
+    }
+
+    void MeshPipeline::setVertexLayout()
+    {
+        const GLsizei stride = sizeof(GpuVertex);
+        glEnableVertexAttribArray(ATTRIB_POSITION);
+        glVertexAttribPointer(ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(offsetof(GpuVertex, position)));
+        glEnableVertexAttribArray(ATTRIB_NORMAL);
+        glVertexAttribPointer(ATTRIB_NORMAL, 3, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(offsetof(GpuVertex, normal)));
+        glEnableVertexAttribArray(ATTRIB_UV);
+        glVertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(offsetof(GpuVertex, uv)));
+    }
+
+    void MeshPipeline::begin()
+    {
+        if (_active)
+            return;
+        glUseProgram(_program);
+        _active = true;
+    }
+
+    void MeshPipeline::end()
+    {
+        if (!_active)
+            return;
+        glBindVertexArray(0);
+        glUseProgram(0);
+        _active = false;
+    }
+
+    void MeshPipeline::setMaterial(const Vector3f& color, float alpha, GLuint texture, bool lit)
+    {
+        glUniform4f(_colorLoc, color.x, color.y, color.z, alpha);
+        glUniform1i(_litLoc, lit ? 1 : 0);
+        glUniform1i(_useTextureLoc, texture ? 1 : 0);
+        if (texture)
+        {
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, texture);
+        }
+    }
+
+    void MeshPipeline::drawMesh(const MeshData& mesh, const Vector3f& color, GLuint texture, bool lit)
+    {
+        if (!mesh.vao || mesh.indexCount == 0)
+            return;
+        begin();
+        setMaterial(color, 1.0f, texture, lit);
+        glBindVertexArray(mesh.vao);
+        glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, nullptr);
+        ++_stats.drawCalls;
+    }
+
+    void MeshPipeline::drawQuad(const Vector3f& color, float alpha, GLuint texture)
+    {
+        begin();
+        setMaterial(color, alpha, texture, false);
+        glBindVertexArray(_quad.vao);
+        glDrawArrays(GL_TRIANGLE_FAN, 0, _quad.count);
+        ++_stats.drawCalls;
+    }
+
+    void MeshPipeline::drawCircle(int segments, const Vector3f& color, float alpha)
+    {
+        const Shape& shape = circle(segments);
+        begin();
+        setMaterial(color, alpha, 0, false);
+        glBindVertexArray(shape.vao);
+        glDrawArrays(GL_TRIANGLE_FAN, 0, shape.count);
+        ++_stats.drawCalls;
+    }
+
+    void MeshPipeline::drawTriangles(const GpuVertex* vertices, size_t count, const Vector3f& color, float alpha, GLuint texture)
+    {
+        if (count == 0)
+            return;
+        if (!_stream.vao)
+        {
+            glGenVertexArrays(1, &_stream.vao);
+            glGenBuffers(1, &_stream.vbo);
+            glBindVertexArray(_stream.vao);
+            glBindBuffer(GL_ARRAY_BUFFER, _stream.vbo);
+            setVertexLayout();
+        }
+        glBindVertexArray(_stream.vao);
+        glBindBuffer(GL_ARRAY_BUFFER, _stream.vbo);
+        size_t bytes = sizeof(GpuVertex) * count;
+        if (bytes > _streamCapacity)
+            _streamCapacity = std::max(bytes, _streamCapacity * 2);
+        // Orphaned on every text, as for the instance stream.
+        glBufferData(GL_ARRAY_BUFFER, _streamCapacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, vertices);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        begin();
+        setMaterial(color, alpha, texture, false);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(count));
+        ++_stats.drawCalls;
+    }
+
+    void MeshPipeline::uploadInstances(const InstanceData* instances, size_t count)
+    {
+        if (!_instanceVbo)
+            return;
+        size_t bytes = sizeof(InstanceData) * count;
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceVbo);
+        if (bytes > _instanceCapacity)
+            _instanceCapacity = std::max(bytes, _instanceCapacity * 2);
+        // Orphans last frame's storage instead of waiting for the GPU to release it.
+        glBufferData(GL_ARRAY_BUFFER, _instanceCapacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, instances);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void MeshPipeline::drawInstanced(const MeshData* mesh, GLuint texture, bool lit, size_t first, size_t count)
+    {
+        if (!_instancing || count == 0 || (mesh && (!mesh->vao || mesh->indexCount == 0)))
+            return;
+        begin();
+        setMaterial({1.0f, 1.0f, 1.0f}, 1.0f, texture, lit);
+        glBindVertexArray(mesh ? mesh->vao : _quad.vao);
+
+        const GLsizei stride = sizeof(InstanceData);
+        const size_t base = first * sizeof(InstanceData);
+        glBindBuffer(GL_ARRAY_BUFFER, _instanceVbo);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glEnableVertexAttribArray(ATTRIB_MODEL + column);
+            glVertexAttribPointer(ATTRIB_MODEL + column, 4, GL_FLOAT, GL_FALSE, stride,
+                                  reinterpret_cast<const void*>(base + offsetof(InstanceData, model) + column * 4 * sizeof(float)));
+            glVertexAttribDivisor(ATTRIB_MODEL + column, 1);
+        }
+        glEnableVertexAttribArray(ATTRIB_COLOR);
+        glVertexAttribPointer(ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, stride,
+                              reinterpret_cast<const void*>(base + offsetof(InstanceData, color)));
+        glVertexAttribDivisor(ATTRIB_COLOR, 1);
+
+        if (mesh)
+            glDrawElementsInstanced(GL_TRIANGLES, mesh->indexCount, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count));
+        else
+            glDrawArraysInstanced(GL_TRIANGLE_FAN, 0, _quad.count, static_cast<GLsizei>(count));
+
+        // The VAO is shared with non-instanced draws: leave it as found.
+        for (GLuint attrib = ATTRIB_MODEL; attrib <= ATTRIB_COLOR; ++attrib)
+        {
+            glVertexAttribDivisor(attrib, 0);
+            glDisableVertexAttribArray(attrib);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        resetInstanceAttribs();
+
+        ++_stats.drawCalls;
+        ++_stats.batches;
+        _stats.instances += static_cast<uint32_t>(count);
+    }
+
+    void MeshPipeline::resetInstanceAttribs()
+    {
+        glVertexAttrib4f(ATTRIB_MODEL + 0, 1.0f, 0.0f, 0.0f, 0.0f);
+        glVertexAttrib4f(ATTRIB_MODEL + 1, 0.0f, 1.0f, 0.0f, 0.0f);
+        glVertexAttrib4f(ATTRIB_MODEL + 2, 0.0f, 0.0f, 1.0f, 0.0f);
+        glVertexAttrib4f(ATTRIB_MODEL + 3, 0.0f, 0.0f, 0.0f, 1.0f);
+        glVertexAttrib4f(ATTRIB_COLOR, 1.0f, 1.0f, 1.0f, 1.0f);
+    }
+
+    const MeshPipeline::Shape& MeshPipeline::circle(int segments)
+    {
+        segments = std::max(segments, 3);
+        auto it = _circles.find(segments);
+        if (it != _circles.end())
+            return it->second;
+
+        std::vector<GpuVertex> fan;
+        fan.reserve(static_cast<size_t>(segments) + 2);
+        fan.push_back({{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.5f, 0.5f}});
+        for (int i = 0; i <= segments; i++)
+        {
+            float angle = TWO_PI * (float)i / (float)segments;
+            float c = std::cos(angle);
+            float s = std::sin(angle);
+            fan.push_back({{c, s, 0.0f}, {0.0f, 0.0f, 1.0f}, {0.5f + 0.5f * c, 0.5f - 0.5f * s}});
+        }
+        return _circles[segments] = buildShape(fan.data(), static_cast<GLsizei>(fan.size()));
+    }
+
+    MeshPipeline::Shape MeshPipeline::buildShape(const GpuVertex* vertices, GLsizei count)
+    {
+        Shape shape;
+        shape.count = count;
+        glGenVertexArrays(1, &shape.vao);
+        glBindVertexArray(shape.vao);
+        glGenBuffers(1, &shape.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, shape.vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GpuVertex) * count, vertices, GL_STATIC_DRAW);
+        setVertexLayout();
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return shape;
+    }
+
+    void MeshPipeline::destroyShape(Shape& shape)
+    {
+        if (shape.vbo)
+            glDeleteBuffers(1, &shape.vbo);
+        if (shape.vao)
+            glDeleteVertexArrays(1, &shape.vao);
+        shape = Shape{};
+    }
+
+}
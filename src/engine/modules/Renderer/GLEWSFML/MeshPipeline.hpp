@@ -0,0 +1,117 @@
+/**
+ * @file MeshPipeline.hpp
+ * @brief Retained-mode draw path: VAO/VBO geometry and one shader program
+ *
+ * @details Meshes are uploaded once (see ResourceManager::prepareMesh) as
+ * interleaved GpuVertex buffers plus an index buffer and drawn with
+ * glDrawElements. Sprites, rectangles and circles reuse a unit quad and
+ * cached unit circles, placed with the usual matrix stack. Text glyph quads
+ * are streamed through one dynamic buffer, one draw per text.
+ *
+ * With GL 3.3, world objects sharing geometry and material go out as one
+ * instanced draw: per-instance model matrix and color come from a stream
+ * buffer (see InstanceBatcher.hpp). Outside instanced draws those
+ * attributes hold the identity and white.
+ *
+ * The shader is GLSL 1.20 and reads the fixed-function matrices and
+ * GL_LIGHT0, so camera, transforms and lights are set up exactly as for
+ * the immediate-mode path. That path stays as the fallback when shaders or
+ * vertex array objects are unavailable, or with `RTYPE_RENDER_IMMEDIATE=1`.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <GL/glew.h>
+#include "RenderStructs.hpp"
+
+namespace rtypeEngine {
+
+    struct GpuVertex {
+        float position[3];
+        float normal[3];
+        float uv[2];
+    };
+
+    struct InstanceData {
+        float model[16]; // column-major, applied before the camera
+        float color[4];
+    };
+
+    /// Draw counters, accumulated until the renderer publishes and resets them.
+    struct DrawStats {
+        uint32_t drawCalls = 0;
+        uint32_t batches = 0;   // instanced draws
+        uint32_t instances = 0; // objects drawn by instanced draws
+        uint32_t immediate = 0; // objects drawn with glBegin/glEnd (counted by the renderer)
+    };
+
+    class MeshPipeline {
+    public:
+        static constexpr GLuint ATTRIB_POSITION = 0;
+        static constexpr GLuint ATTRIB_NORMAL = 1;
+        static constexpr GLuint ATTRIB_UV = 2;
+        static constexpr GLuint ATTRIB_MODEL = 3; // 3..6, one column each
+        static constexpr GLuint ATTRIB_COLOR = 7;
+
+        MeshPipeline() = default;
+        ~MeshPipeline() = default;
+
+        /// Compiles the program and builds the shared shapes (GL context current).
+        bool init();
+        void destroy();
+        bool ready() const { return _program != 0; }
+        bool instancing() const { return _instancing; }
+
+        /// Attribute pointers for GpuVertex, recorded in the bound VAO.
+        static void setVertexLayout();
+
+        /// Unbinds the program so immediate-mode drawing can follow.
+        void end();
+
+        void drawMesh(const MeshData& mesh, const Vector3f& color, GLuint texture, bool lit);
+        /// Quad from (0,0) to (1,1); v runs top-down like the immediate path.
+        void drawQuad(const Vector3f& color, float alpha, GLuint texture);
+        /// Filled circle of radius 1 around the origin.
+        void drawCircle(int segments, const Vector3f& color, float alpha);
+        /// Unlit triangles streamed this frame, e.g. glyph quads of a text.
+        void drawTriangles(const GpuVertex* vertices, size_t count, const Vector3f& color, float alpha, GLuint texture);
+
+        /// Replaces the instance stream for this frame.
+        void uploadInstances(const InstanceData* instances, size_t count);
+        /// `count` instances from `first` in the stream; a null mesh draws the unit quad.
+        void drawInstanced(const MeshData* mesh, GLuint texture, bool lit, size_t first, size_t count);
+
+        DrawStats& stats() { return _stats; }
+
+    private:
+        struct Shape {
+            GLuint vao = 0;
+            GLuint vbo = 0;
+            GLsizei count = 0;
+        };
+
+        void begin();
+        void setMaterial(const Vector3f& color, float alpha, GLuint texture, bool lit);
+        const Shape& circle(int segments);
+        static Shape buildShape(const GpuVertex* vertices, GLsizei count);
+        static void destroyShape(Shape& shape);
+        static void resetInstanceAttribs();
+
+        GLuint _program = 0;
+        GLint _colorLoc = -1;
+        GLint _useTextureLoc = -1;
+        GLint _litLoc = -1;
+        bool _active = false;
+        bool _instancing = false;
+        GLuint _instanceVbo = 0;
+        size_t _instanceCapacity = 0; // bytes allocated in _instanceVbo
+        DrawStats _stats;
+        Shape _quad;
+        std::map<int, Shape> _circles;
+        Shape _stream;
+        size_t _streamCapacity = 0; // bytes allocated in _stream.vbo
+    };
+}
@@ -1,175 +1,250 @@
 #include "ParticleSystem.hpp"
+#include <algorithm>
+#include <cstddef>
 #include <random>
 #include <cmath>
 #include <iostream>
 
 namespace rtypeEngine {
 
-    ParticleSystem::ParticleSystem() {}
+    void ParticlePool::push(const Vector3f& position, const Vector3f& velocity, float lifeTime, float size, const Vector3f& color)
+    {
+        if (count == posX.size())
+            grow();
+        posX[count] = position.x;
+        posY[count] = position.y;
+        posZ[count] = position.z;
+        velX[count] = velocity.x;
+        velY[count] = velocity.y;
+        velZ[count] = velocity.z;
+        life[count] = lifeTime;
+        invMaxLife[count] = lifeTime > 0.0f ? 1.0f / lifeTime : 0.0f;
+        halfSize[count] = size;
+        red[count] = color.x;
+        green[count] = color.y;
+        blue[count] = color.z;
+        ++count;
+    }
 
-    void ParticleSystem::update(float dt)
+    void ParticlePool::remove(size_t index)
+    {
+        size_t last = --count;
+        posX[index] = posX[last];
+        posY[index] = posY[last];
+        posZ[index] = posZ[last];
+        velX[index] = velX[last];
+        velY[index] = velY[last];
+        velZ[index] = velZ[last];
+        life[index] = life[last];
+        invMaxLife[index] = invMaxLife[last];
+        halfSize[index] = halfSize[last];
+        red[index] = red[last];
+        green[index] = green[last];
+        blue[index] = blue[last];
+    }
+
+    void ParticlePool::grow()
     {
-        static std::mt19937 rng(std::random_device{}());
-        static std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+        size_t capacity = std::max<size_t>(64, posX.size() * 2);
+        for (auto* array : {&posX, &posY, &posZ, &velX, &velY, &velZ, &life, &invMaxLife, &halfSize, &red, &green, &blue})
+            array->resize(capacity);
+    }
+
+    ParticleSystem::ParticleSystem() : _rng(std::random_device{}()) {}
 
+    void ParticleSystem::update(float dt)
+    {
         for (auto &pair : _particleGenerators)
         {
             auto &gen = pair.second;
 
             gen.accumulator += dt * gen.rate;
-            while (gen.accumulator > 1.0f)
+            if (gen.accumulator > 1.0f)
             {
-                gen.accumulator -= 1.0f;
-
-                Particle p;
+                int spawnCount = static_cast<int>(std::ceil(gen.accumulator - 1.0f));
+                gen.accumulator -= static_cast<float>(spawnCount);
+                spawn(gen, spawnCount);
+            }
 
-                // Calculate world position and direction based on entity transform
-                // Rotation order: Z, Y, X (matching Lua implementation)
+            integrate(gen.particles, dt);
+        }
+    }
 
-                float radX = gen.rotation.x * 3.14159f / 180.0f;
-                float radY = gen.rotation.y * 3.14159f / 180.0f;
-                float radZ = gen.rotation.z * 3.14159f / 180.0f;
+    void ParticleSystem::spawn(ParticleGenerator& gen, int count)
+    {
+        std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
 
-                float cx = cos(radX), sx = sin(radX);
-                float cy = cos(radY), sy = sin(radY);
-                float cz = cos(radZ), sz = sin(radZ);
+        // Calculate world position and direction based on entity transform
+        // Rotation order: Z, Y, X (matching Lua implementation). The
+        // transform is the same for the whole burst, so it is computed once.
 
-                // Rotate offset
-                float x = gen.offset.x;
-                float y = gen.offset.y;
-                float z = gen.offset.z;
+        float radX = gen.rotation.x * 3.14159f / 180.0f;
+        float radY = gen.rotation.y * 3.14159f / 180.0f;
+        float radZ = gen.rotation.z * 3.14159f / 180.0f;
 
-                // Z rotation
-                float x1 = x * cz - y * sz;
-                float y1 = x * sz + y * cz;
-                float z1 = z;
+        float cx = cos(radX), sx = sin(radX);
+        float cy = cos(radY), sy = sin(radY);
+        float cz = cos(radZ), sz = sin(radZ);
 
-                // Y rotation
-                float x2 = x1 * cy + z1 * sy;
-                float y2 = y1;
-                float z2 = -x1 * sy + z1 * cy;
+        auto rotate = [&](const Vector3f& v) -> Vector3f
+        {
+            // Z rotation
+            float x1 = v.x * cz - v.y * sz;
+            float y1 = v.x * sz + v.y * cz;
+            float z1 = v.z;
 
-                // X rotation
-                float x3 = x2;
-                float y3 = y2 * cx - z2 * sx;
-                float z3 = y2 * sx + z2 * cx;
+            // Y rotation
+            float x2 = x1 * cy + z1 * sy;
+            float y2 = y1;
+            float z2 = -x1 * sy + z1 * cy;
 
-                p.position = {gen.position.x + x3, gen.position.y + y3, gen.position.z + z3};
+            // X rotation
+            return {x2, y2 * cx - z2 * sx, y2 * sx + z2 * cx};
+        };
 
-                // Rotate direction
-                Vector3f dir = gen.direction;
+        Vector3f offset = rotate(gen.offset);
+        Vector3f position{gen.position.x + offset.x, gen.position.y + offset.y, gen.position.z + offset.z};
+        Vector3f direction = rotate(gen.direction);
 
-                // Z rotation
-                float dx1 = dir.x * cz - dir.y * sz;
-                float dy1 = dir.x * sz + dir.y * cz;
-                float dz1 = dir.z;
+        for (int i = 0; i < count; ++i)
+        {
+            // Apply spread
+            float dx = direction.x + dist(_rng) * gen.spread;
+            float dy = direction.y + dist(_rng) * gen.spread;
+            float dz = direction.z + dist(_rng) * gen.spread;
 
-                // Y rotation
-                float dx2 = dx1 * cy + dz1 * sy;
-                float dy2 = dy1;
-                float dz2 = -dx1 * sy + dz1 * cy;
+            float len = sqrt(dx * dx + dy * dy + dz * dz);
+            if (len > 0)
+            {
+                dx /= len;
+                dy /= len;
+                dz /= len;
+            }
 
-                // X rotation
-                float dx3 = dx2;
-                float dy3 = dy2 * cx - dz2 * sx;
-                float dz3 = dy2 * sx + dz2 * cx;
+            Vector3f velocity{dx * gen.speed, dy * gen.speed, dz * gen.speed};
+            gen.particles.push(position, velocity, gen.lifeTime, gen.size, gen.color);
+        }
+    }
 
-                // Apply spread
-                dx3 += dist(rng) * gen.spread;
-                dy3 += dist(rng) * gen.spread;
-                dz3 += dist(rng) * gen.spread;
+    void ParticleSystem::integrate(ParticlePool& pool, float dt)
+    {
+        const size_t count = pool.count;
+        float* __restrict life = pool.life.data();
+        float* __restrict px = pool.posX.data();
+        float* __restrict py = pool.posY.data();
+        float* __restrict pz = pool.posZ.data();
+        const float* __restrict vx = pool.velX.data();
+        const float* __restrict vy = pool.velY.data();
+        const float* __restrict vz = pool.velZ.data();
+
+        // Straight loops over float arrays; particles that die this step
+        // move too, they are removed right after.
+        for (size_t i = 0; i < count; ++i)
+            life[i] -= dt;
+        for (size_t i = 0; i < count; ++i)
+        {
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            pz[i] += vz[i] * dt;
+        }
 
-                float len = sqrt(dx3 * dx3 + dy3 * dy3 + dz3 * dz3);
-                if (len > 0)
-                {
-                    dx3 /= len;
-                    dy3 /= len;
-                    dz3 /= len;
-                }
+        for (size_t i = 0; i < pool.count;)
+        {
+            if (pool.life[i] <= 0.0f)
+                pool.remove(i);
+            else
+                ++i;
+        }
+    }
 
-                p.velocity = {dx3 * gen.speed, dy3 * gen.speed, dz3 * gen.speed};
-                p.life = gen.lifeTime;
-                p.maxLife = gen.lifeTime;
-                p.size = gen.size;
-                p.color = gen.color;
+    uint32_t ParticleSystem::render()
+    {
+        size_t total = 0;
+        for (const auto &pair : _particleGenerators)
+            total += pair.second.particles.count;
+        if (total == 0)
+            return 0;
 
-                gen.particles.push_back(p);
-            }
+        // Billboards face the camera: the quad corners are offset in eye
+        // space, so the modelview rotation only applies to the centre.
+        float modelview[16];
+        glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
 
-            for (auto it = gen.particles.begin(); it != gen.particles.end();)
+        _vertices.resize(total * 4);
+        ParticleVertex* out = _vertices.data();
+        for (const auto &pair : _particleGenerators)
+        {
+            const ParticlePool &pool = pair.second.particles;
+            for (size_t i = 0; i < pool.count; ++i)
             {
-                it->life -= dt;
-                if (it->life <= 0)
-                {
-                    it = gen.particles.erase(it);
-                }
-                else
+                float ex = modelview[0] * pool.posX[i] + modelview[4] * pool.posY[i] + modelview[8] * pool.posZ[i] + modelview[12];
+                float ey = modelview[1] * pool.posX[i] + modelview[5] * pool.posY[i] + modelview[9] * pool.posZ[i] + modelview[13];
+                float ez = modelview[2] * pool.posX[i] + modelview[6] * pool.posY[i] + modelview[10] * pool.posZ[i] + modelview[14];
+                float s = pool.halfSize[i];
+                float alpha = pool.life[i] * pool.invMaxLife[i];
+
+                const float corners[4][2] = {{-s, -s}, {s, -s}, {s, s}, {-s, s}};
+                for (const auto &corner : corners)
                 {
-                    it->position.x += it->velocity.x * dt;
-                    it->position.y += it->velocity.y * dt;
-                    it->position.z += it->velocity.z * dt;
-                    ++it;
+                    *out++ = {{ex + corner[0], ey + corner[1], ez}, {pool.red[i], pool.green[i], pool.blue[i], alpha}};
                 }
             }
         }
-    }
 
-    void ParticleSystem::render()
-    {
+        if (!_vertexBuffer)
+            glGenBuffers(1, &_vertexBuffer);
+        glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer);
+        size_t bytes = _vertices.size() * sizeof(ParticleVertex);
+        if (bytes > _vertexCapacity)
+            _vertexCapacity = std::max(bytes, _vertexCapacity * 2);
+        glBufferData(GL_ARRAY_BUFFER, _vertexCapacity, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, _vertices.data());
+
         glDisable(GL_LIGHTING);
         glEnable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE);
         glDepthMask(GL_FALSE);
 
-        for (const auto &pair : _particleGenerators)
-        {
-            const auto &gen = pair.second;
-
-            for (const auto &p : gen.particles)
-            {
-                float lifeRatio = (p.maxLife > 0.0f) ? p.life / p.maxLife : 0.0f;
-                float alpha = lifeRatio;
-
-                glColor4f(p.color.x, p.color.y, p.color.z, alpha);
-
-                glPushMatrix();
-                glTranslatef(p.position.x, p.position.y, p.position.z);
+        glMatrixMode(GL_MODELVIEW);
+        glPushMatrix();
+        glLoadIdentity();
 
-                float modelview[16];
-                glGetFloatv(GL_MODELVIEW_MATRIX, modelview);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glVertexPointer(3, GL_FLOAT, sizeof(ParticleVertex), reinterpret_cast<const void*>(offsetof(ParticleVertex, position)));
+        glColorPointer(4, GL_FLOAT, sizeof(ParticleVertex), reinterpret_cast<const void*>(offsetof(ParticleVertex, color)));
 
-                for (int i = 0; i < 3; i++)
-                {
-                    for (int j = 0; j < 3; j++)
-                    {
-                        if (i == j)
-                            modelview[i * 4 + j] = 1.0f;
-                        else
-                            modelview[i * 4 + j] = 0.0f;
-                    }
-                }
-
-                glLoadMatrixf(modelview);
-
-                float s = p.size;
-                glBegin(GL_QUADS);
-                glTexCoord2f(0, 0);
-                glVertex3f(-s, -s, 0);
-                glTexCoord2f(1, 0);
-                glVertex3f(s, -s, 0);
-                glTexCoord2f(1, 1);
-                glVertex3f(s, s, 0);
-                glTexCoord2f(0, 1);
-                glVertex3f(-s, s, 0);
-                glEnd();
-
-                glPopMatrix();
-            }
+        GLint first = 0;
+        uint32_t drawCalls = 0;
+        for (const auto &pair : _particleGenerators)
+        {
+            GLsizei vertexCount = static_cast<GLsizei>(pair.second.particles.count * 4);
+            if (vertexCount == 0)
+                continue;
+            glDrawArrays(GL_QUADS, first, vertexCount);
+            first += vertexCount;
+            ++drawCalls;
         }
 
+        glDisableClientState(GL_COLOR_ARRAY);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glPopMatrix();
+
         glDepthMask(GL_TRUE);
         glDisable(GL_BLEND);
         glEnable(GL_LIGHTING);
+        return drawCalls;
+    }
+
+    void ParticleSystem::releaseBuffers()
+    {
+        if (_vertexBuffer)
+        {
+            glDeleteBuffers(1, &_vertexBuffer);
+            _vertexBuffer = 0;
+            _vertexCapacity = 0;
+        }
     }
 
     void ParticleSystem::createGenerator(const std::string& id, const ParticleGenerator& gen) {
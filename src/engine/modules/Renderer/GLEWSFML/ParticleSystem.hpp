@@ -1,20 +1,46 @@
+/**
+ * @file ParticleSystem.hpp
+ * @brief Particle generators with pooled structure-of-arrays storage
+ *
+ * @details Each generator keeps its particles in a ParticlePool: one float
+ * array per attribute, live particles packed at the front, dead ones
+ * swap-removed. The update loops run over plain float arrays so the
+ * compiler can vectorize them.
+ *
+ * Rendering builds camera-facing quads on the CPU into one vertex array,
+ * uploads it once per frame into a streamed buffer and issues one
+ * glDrawArrays per generator.
+ */
+
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <map>
+#include <random>
 #include <string>
 #include <GL/glew.h>
 #include "../I3DRenderer.hpp"
 
 namespace rtypeEngine {
 
-    struct Particle {
-        Vector3f position;
-        Vector3f velocity;
-        Vector3f color;
-        float life;
-        float maxLife;
-        float size;
+    struct ParticlePool {
+        std::vector<float> posX, posY, posZ;
+        std::vector<float> velX, velY, velZ;
+        std::vector<float> life;
+        std::vector<float> invMaxLife; // 0 when spawned with no lifetime
+        std::vector<float> halfSize;
+        std::vector<float> red, green, blue;
+        size_t count = 0; // live particles, stored in [0, count)
+
+        bool empty() const { return count == 0; }
+        void push(const Vector3f& position, const Vector3f& velocity, float lifeTime, float size, const Vector3f& color);
+        /// Moves the last live particle into slot `index`.
+        void remove(size_t index);
+        void clear() { count = 0; }
+
+    private:
+        void grow();
     };
 
     struct ParticleGenerator {
@@ -31,7 +57,7 @@ namespace rtypeEngine {
         Vector3f color;
 
         float accumulator = 0.0f;
-        std::vector<Particle> particles;
+        ParticlePool particles;
     };
 
     class ParticleSystem {
@@ -40,7 +66,11 @@ namespace rtypeEngine {
         ~ParticleSystem() = default;
 
         void update(float dt);
-        void render();
+        /// @return draw calls issued
+        uint32_t render();
+        void seed(uint32_t value) { _rng.seed(value); }
+        /// Deletes the vertex buffer (GL context current).
+        void releaseBuffers();
 
         void createGenerator(const std::string& id, const ParticleGenerator& gen);
         void updateGenerator(const std::string& id, const ParticleGenerator& gen);
@@ -52,6 +82,18 @@ namespace rtypeEngine {
         void setGeneratorRotation(const std::string& id, const Vector3f& rot);
 
     private:
+        struct ParticleVertex {
+            float position[3];
+            float color[4];
+        };
+
+        void spawn(ParticleGenerator& gen, int count);
+        static void integrate(ParticlePool& pool, float dt);
+
         std::map<std::string, ParticleGenerator> _particleGenerators;
+        std::mt19937 _rng;
+        std::vector<ParticleVertex> _vertices;
+        GLuint _vertexBuffer = 0;
+        size_t _vertexCapacity = 0; // bytes allocated in _vertexBuffer
     };
 }
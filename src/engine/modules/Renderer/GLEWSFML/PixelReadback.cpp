@@ -0,0 +1,107 @@
+#include "PixelReadback.hpp"
+#include <algorithm>
+
+namespace rtypeEngine {
+
+    void PixelReadback::setLatency(uint32_t frames)
+    {
+        reset();
+        _latency = std::min(frames, MAX_LATENCY);
+    }
+
+    bool PixelReadback::usePixelBuffers() const
+    {
+        return _latency > 0 && (GLEW_VERSION_2_1 || GLEW_ARB_pixel_buffer_object);
+    }
+
+    void PixelReadback::queue(uint32_t width, uint32_t height)
+    {
+        const size_t bytes = static_cast<size_t>(width) * height * 4;
+
+        if (!usePixelBuffers())
+        {
+            _cpuPixels.resize(bytes);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, _cpuPixels.data());
+            _cpuFrame = {_cpuPixels.data(), width, height};
+            _inFlight = 1;
+            return;
+        }
+
+        if (_slots.size() != _latency + 1)
+        {
+            destroy();
+            _slots.resize(_latency + 1);
+            for (Slot& slot : _slots)
+                glGenBuffers(1, &slot.pbo);
+        }
+
+        Slot& slot = _slots[_next];
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        if (bytes > slot.capacity)
+        {
+            glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+            slot.capacity = bytes;
+        }
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        slot.width = width;
+        slot.height = height;
+
+        _next = (_next + 1) % _slots.size();
+        _inFlight = std::min(_inFlight + 1, _slots.size());
+    }
+
+    bool PixelReadback::acquire(Frame& frame)
+    {
+        if (!usePixelBuffers())
+        {
+            if (_inFlight == 0)
+                return false;
+            _inFlight = 0;
+            frame = _cpuFrame;
+            return true;
+        }
+
+        if (_inFlight <= _latency)
+            return false;
+        Slot& slot = _slots[(_next + _slots.size() - _inFlight) % _slots.size()];
+        --_inFlight;
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+        void* pixels = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        if (!pixels)
+            return false;
+        _mapped = slot.pbo;
+        frame = {static_cast<const uint8_t*>(pixels), slot.width, slot.height};
+        return true;
+    }
+
+    void PixelReadback::release()
+    {
+        if (!_mapped)
+            return;
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, _mapped);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        _mapped = 0;
+    }
+
+    void PixelReadback::reset()
+    {
+        release();
+        _inFlight = 0;
+        _next = 0;
+    }
+
+    void PixelReadback::destroy()
+    {
+        reset();
+        for (Slot& slot : _slots)
+        {
+            if (slot.pbo)
+                glDeleteBuffers(1, &slot.pbo);
+        }
+        _slots.clear();
+    }
+}
@@ -0,0 +1,72 @@
+/**
+ * @file PixelReadback.hpp
+ * @brief Asynchronous framebuffer readback through a ring of pixel buffer objects
+ *
+ * @details queue() issues `glReadPixels` into a pixel buffer object, which
+ * returns without waiting for the GPU. acquire() maps the buffer filled
+ * `latency` frames earlier, by which time the transfer has normally
+ * completed, so the render thread no longer stalls on every frame.
+ *
+ * Latency 0 reads synchronously, as before. Pixels are RGBA8, bottom-up
+ * (OpenGL row order), rows packed with GL_PACK_ALIGNMENT 4.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <GL/glew.h>
+
+namespace rtypeEngine {
+
+    class PixelReadback {
+    public:
+        static constexpr uint32_t DEFAULT_LATENCY = 1;
+        static constexpr uint32_t MAX_LATENCY = 3;
+
+        struct Frame {
+            const uint8_t* pixels = nullptr;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        PixelReadback() = default;
+        ~PixelReadback() = default;
+
+        /// Frames between queue() and the matching acquire(); drops frames in flight.
+        void setLatency(uint32_t frames);
+        uint32_t latency() const { return _latency; }
+        /// False when frames are read synchronously (latency 0 or no PBO
+        /// support); callers may then glReadPixels into their own memory.
+        bool asynchronous() const { return usePixelBuffers(); }
+
+        /// Reads the bound framebuffer (GL context current).
+        void queue(uint32_t width, uint32_t height);
+        /// Oldest frame once `latency` newer ones are queued; valid until release().
+        bool acquire(Frame& frame);
+        void release();
+
+        /// Forgets frames in flight, e.g. after a resize.
+        void reset();
+        void destroy();
+
+    private:
+        struct Slot {
+            GLuint pbo = 0;
+            size_t capacity = 0;
+            uint32_t width = 0;
+            uint32_t height = 0;
+        };
+
+        bool usePixelBuffers() const;
+
+        uint32_t _latency = DEFAULT_LATENCY;
+        std::vector<Slot> _slots;
+        size_t _next = 0;     // slot the next queue() writes
+        size_t _inFlight = 0; // queued, not yet acquired
+        GLuint _mapped = 0;   // buffer mapped by acquire()
+        std::vector<uint8_t> _cpuPixels; // synchronous path
+        Frame _cpuFrame;
+    };
+}
@@ -0,0 +1,110 @@
+#include "RenderObjectStore.hpp"
+#include <algorithm>
+
+namespace rtypeEngine {
+
+    RenderHandle RenderObjectStore::add(RenderObject object)
+    {
+        remove(object.id);
+
+        uint32_t slotIndex;
+        if (!_freeSlots.empty())
+        {
+            slotIndex = _freeSlots.back();
+            _freeSlots.pop_back();
+        }
+        else
+        {
+            slotIndex = static_cast<uint32_t>(_slots.size());
+            _slots.emplace_back();
+        }
+        const size_t kind = static_cast<size_t>(object.kind);
+        Slot& slot = _slots[slotIndex];
+        slot.kind = object.kind;
+        slot.index = static_cast<uint32_t>(_dense[kind].size());
+        slot.live = true;
+
+        const RenderHandle handle{slotIndex, slot.generation};
+        _ids[object.id] = handle;
+        if (object.isScreenSpace)
+        {
+            _hudOrder.push_back(handle);
+            _hudDirty = true;
+        }
+        _dense[kind].push_back(std::move(object));
+        _denseSlots[kind].push_back(slotIndex);
+        return handle;
+    }
+
+    bool RenderObjectStore::remove(const std::string& id)
+    {
+        auto it = _ids.find(id);
+        if (it == _ids.end())
+            return false;
+        const uint32_t slotIndex = it->second.slot;
+        _ids.erase(it);
+
+        Slot& slot = _slots[slotIndex];
+        const size_t kind = static_cast<size_t>(slot.kind);
+        std::vector<RenderObject>& dense = _dense[kind];
+        std::vector<uint32_t>& owners = _denseSlots[kind];
+        if (dense[slot.index].isScreenSpace)
+            _hudDirty = true; // stale handle, dropped by the next hudOrder()
+        if (slot.index + 1 != dense.size())
+        {
+            dense[slot.index] = std::move(dense.back());
+            owners[slot.index] = owners.back();
+            _slots[owners[slot.index]].index = slot.index;
+        }
+        dense.pop_back();
+        owners.pop_back();
+
+        slot.live = false;
+        ++slot.generation;
+        _freeSlots.push_back(slotIndex);
+        return true;
+    }
+
+    RenderHandle RenderObjectStore::handle(const std::string& id) const
+    {
+        auto it = _ids.find(id);
+        return it == _ids.end() ? RenderHandle{} : it->second;
+    }
+
+    RenderObject* RenderObjectStore::get(RenderHandle handle)
+    {
+        if (handle.slot >= _slots.size())
+            return nullptr;
+        const Slot& slot = _slots[handle.slot];
+        if (!slot.live || slot.generation != handle.generation)
+            return nullptr;
+        return &_dense[static_cast<size_t>(slot.kind)][slot.index];
+    }
+
+    void RenderObjectStore::setZOrder(RenderObject& object, int zOrder)
+    {
+        if (object.zOrder == zOrder)
+            return;
+        object.zOrder = zOrder;
+        if (object.isScreenSpace)
+            _hudDirty = true;
+    }
+
+    const std::vector<RenderHandle>& RenderObjectStore::hudOrder()
+    {
+        if (!_hudDirty)
+            return _hudOrder;
+        _hudOrder.erase(std::remove_if(_hudOrder.begin(), _hudOrder.end(),
+                                       [this](RenderHandle handle) { return get(handle) == nullptr; }),
+                        _hudOrder.end());
+        std::sort(_hudOrder.begin(), _hudOrder.end(), [this](RenderHandle a, RenderHandle b) {
+            const RenderObject& left = *get(a);
+            const RenderObject& right = *get(b);
+            if (left.zOrder != right.zOrder)
+                return left.zOrder < right.zOrder;
+            return left.id < right.id;
+        });
+        _hudDirty = false;
+        return _hudOrder;
+    }
+}
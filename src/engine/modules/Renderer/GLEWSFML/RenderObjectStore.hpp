@@ -0,0 +1,70 @@
+/**
+ * @file RenderObjectStore.hpp
+ * @brief Dense storage of the renderer's objects, one array per kind
+ *
+ * @details Objects live in contiguous per-kind arrays (meshes, sprites,
+ * texts, rects, ...), so each pass walks only the kinds it draws. Removal
+ * swaps the last object of the array into the hole. A RenderHandle names
+ * an object independently of where it sits; a handle whose object was
+ * destroyed (or replaced) resolves to nullptr.
+ *
+ * The string ids of the RenderEntityCommand protocol are resolved to a
+ * handle once per command through a hash index. The HUD draw list (the
+ * screen-space objects by zOrder) is kept between frames and only sorted
+ * again after an object is added, removed or changes zOrder.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "RenderStructs.hpp"
+
+namespace rtypeEngine {
+
+    struct RenderHandle {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    class RenderObjectStore {
+    public:
+        /// Stores `object` under its id, replacing any object with that id.
+        RenderHandle add(RenderObject object);
+        bool remove(const std::string& id);
+
+        RenderHandle handle(const std::string& id) const;
+        RenderObject* get(RenderHandle handle);
+        RenderObject* find(const std::string& id) { return get(handle(id)); }
+        size_t size() const { return _ids.size(); }
+
+        const std::vector<RenderObject>& objects(RenderKind kind) const
+        {
+            return _dense[static_cast<size_t>(kind)];
+        }
+
+        void setZOrder(RenderObject& object, int zOrder);
+        /// Screen-space objects sorted by (zOrder, id).
+        const std::vector<RenderHandle>& hudOrder();
+
+    private:
+        struct Slot {
+            RenderKind kind = RenderKind::Mesh;
+            uint32_t index = 0; // in _dense[kind]
+            uint32_t generation = 0;
+            bool live = false;
+        };
+        static constexpr size_t KINDS = static_cast<size_t>(RenderKind::Count);
+
+        std::vector<Slot> _slots;
+        std::vector<uint32_t> _freeSlots;
+        std::array<std::vector<RenderObject>, KINDS> _dense;
+        std::array<std::vector<uint32_t>, KINDS> _denseSlots; // slot of each dense object
+        std::unordered_map<std::string, RenderHandle> _ids;
+        std::vector<RenderHandle> _hudOrder;
+        bool _hudDirty = false;
+    };
+}
@@ -1,21 +1,33 @@
 #pragma once
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include <GL/glew.h>
 #include "../I3DRenderer.hpp"
 
 namespace rtypeEngine {
+    struct ShapedText;
+    class CompiledMesh;
+
+    enum class RenderKind : uint8_t {
+        Camera,
+        Mesh,
+        Sprite,
+        Text,
+        Rect,
+        Circle,
+        RoundedRect,
+        Line,
+        Count
+    };
+
     struct RenderObject {
         std::string id;
+        RenderKind kind = RenderKind::Mesh;
         std::string meshPath;
         std::string texturePath;
-        bool isSprite = false;
         bool isScreenSpace = false;
-        bool isText = false;
-        bool isRect = false;
-        bool isCircle = false;
-        bool isRoundedRect = false;
-        bool isLine = false;
         float cornerRadius = 0.0f;  // For rounded rectangles
         float radius = 0.0f;        // For circles
         int segments = 32;          // Circle/rounded corner segments
@@ -33,7 +45,7 @@ namespace rtypeEngine {
         Vector3f color;
         float alpha = 1.0f;
         int zOrder = 0;
-        GLuint textureID = 0; // Custom texture ID for texts
+        std::shared_ptr<const ShapedText> shapedText; // Glyph quads for texts (see GlyphAtlas.hpp)
     };
 
     struct MeshData {
@@ -41,5 +53,17 @@ namespace rtypeEngine {
         std::vector<unsigned int> indices;
         std::vector<float> uvs;
         std::vector<unsigned int> _textureIndices;
+
+        // Interleaved vertices and indices, mapped from the cache file or built from the OBJ
+        std::shared_ptr<const CompiledMesh> compiled;
+        // Sphere around the model origin holding every vertex, for culling
+        float boundsRadius = 0.0f;
+
+        // GPU copy, uploaded once by ResourceManager::prepareMesh
+        GLuint vao = 0;
+        GLuint vbo = 0;
+        GLuint ibo = 0;
+        GLsizei indexCount = 0;
+        bool uploadFailed = false;
     };
 }
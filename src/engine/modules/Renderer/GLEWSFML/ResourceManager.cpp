@@ -1,8 +1,13 @@
 #include "ResourceManager.hpp"
+#include "MeshPipeline.hpp"
+#include "MeshCache.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cmath>
+#include <cstdlib>
+#include <tuple>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -14,13 +19,28 @@
 
 namespace rtypeEngine {
 
-    ResourceManager::ResourceManager(void*& hdc, void*& hwnd, void*& hglrc)
-        : _hdc(hdc), _hwnd(hwnd), _hglrc(hglrc) {}
-
-    const MeshData* ResourceManager::getMesh(const std::string& path) const {
-        auto it = _meshCache.find(path);
-        if (it != _meshCache.end()) return &it->second;
-        return nullptr;
+    ResourceManager::ResourceManager(void*& hdc, void*& hwnd, void*& hglrc, const bool& headless)
+        : _hdc(hdc), _hwnd(hwnd), _hglrc(hglrc), _headless(headless) {}
+
+    const MeshData* ResourceManager::getMesh(const std::string& path) {
+        MeshData* found = findMesh(path);
+        if (!found) return nullptr;
+        MeshData& mesh = *found;
+        // Meshes mapped from the cache only carry the compiled form; the
+        // immediate-mode path indexes positions and UVs per corner.
+        if (mesh.indices.empty() && mesh.compiled) {
+            const CompiledMesh& compiled = *mesh.compiled;
+            mesh.vertices.reserve(compiled.vertexCount() * 3);
+            mesh.uvs.reserve(compiled.vertexCount() * 2);
+            for (uint32_t i = 0; i < compiled.vertexCount(); ++i) {
+                const GpuVertex& vertex = compiled.vertices()[i];
+                mesh.vertices.insert(mesh.vertices.end(), vertex.position, vertex.position + 3);
+                mesh.uvs.insert(mesh.uvs.end(), vertex.uv, vertex.uv + 2);
+            }
+            mesh.indices.assign(compiled.indices(), compiled.indices() + compiled.indexCount());
+            mesh._textureIndices = mesh.indices;
+        }
+        return &mesh;
     }
 
     GLuint ResourceManager::getTexture(const std::string& path) const {
@@ -35,20 +55,284 @@ namespace rtypeEngine {
         return nullptr;
     }
 
+    const MeshData* ResourceManager::prepareMesh(const std::string& path) {
+        MeshData* found = findMesh(path);
+        if (!found) return nullptr;
+        MeshData& mesh = *found;
+        if (!mesh.vao && !mesh.uploadFailed) {
+            mesh.uploadFailed = !uploadMesh(mesh);
+        }
+        return &mesh;
+    }
+
+    MeshData* ResourceManager::findMesh(const std::string& path) {
+        auto it = _meshCache.find(path);
+        if (it != _meshCache.end()) return &it->second;
+        if (assetStatus(path) != AssetStatus::Pending) return nullptr;
+        if (!_placeholderMesh.compiled) {
+            // Unit cube, faces wound outwards.
+            MeshData cube;
+            cube.vertices = {-0.5f, -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, -0.5f, 0.5f, -0.5f,
+                             -0.5f, -0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f, 0.5f, 0.5f, -0.5f, 0.5f, 0.5f};
+            cube.indices = {4, 5, 6, 4, 6, 7, 1, 0, 3, 1, 3, 2, 0, 4, 7, 0, 7, 3,
+                            5, 1, 2, 5, 2, 6, 3, 7, 6, 3, 6, 2, 0, 1, 5, 0, 5, 4};
+            _placeholderMesh.compiled = compileMesh(cube);
+            _placeholderMesh.boundsRadius = boundingRadius(*_placeholderMesh.compiled);
+        }
+        return &_placeholderMesh;
+    }
+
+    float ResourceManager::meshRadius(const std::string& path) {
+        const MeshData* mesh = findMesh(path);
+        return mesh ? mesh->boundsRadius : -1.0f;
+    }
+
+    float ResourceManager::boundingRadius(const CompiledMesh& mesh) {
+        float radiusSquared = 0.0f;
+        for (uint32_t i = 0; i < mesh.vertexCount(); ++i) {
+            const float* p = mesh.vertices()[i].position;
+            radiusSquared = std::max(radiusSquared, p[0] * p[0] + p[1] * p[1] + p[2] * p[2]);
+        }
+        return std::sqrt(radiusSquared);
+    }
+
+    void ResourceManager::releaseMeshBuffers() {
+        auto release = [](MeshData& mesh) {
+            if (mesh.ibo) glDeleteBuffers(1, &mesh.ibo);
+            if (mesh.vbo) glDeleteBuffers(1, &mesh.vbo);
+            if (mesh.vao) glDeleteVertexArrays(1, &mesh.vao);
+            mesh.vao = mesh.vbo = mesh.ibo = 0;
+            mesh.indexCount = 0;
+        };
+        for (auto& pair : _meshCache)
+            release(pair.second);
+        release(_placeholderMesh);
+    }
+
+    std::shared_ptr<const CompiledMesh> ResourceManager::compileMesh(const MeshData& mesh)
+    {
+        // One vertex per distinct (position, uv, face normal) triangle corner;
+        // faces are flat shaded, so corners are shared within a face only.
+        using CornerKey = std::tuple<unsigned int, unsigned int, float, float, float>;
+        std::map<CornerKey, unsigned int> corners;
+        std::vector<GpuVertex> vertices;
+        std::vector<uint32_t> indices;
+        indices.reserve(mesh.indices.size());
+
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            unsigned int idx[3] = {mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2]};
+            if (idx[0] * 3 + 2 >= mesh.vertices.size() ||
+                idx[1] * 3 + 2 >= mesh.vertices.size() ||
+                idx[2] * 3 + 2 >= mesh.vertices.size())
+                continue;
+
+            const float* p0 = &mesh.vertices[idx[0] * 3];
+            const float* p1 = &mesh.vertices[idx[1] * 3];
+            const float* p2 = &mesh.vertices[idx[2] * 3];
+            float ux = p1[0] - p0[0], uy = p1[1] - p0[1], uz = p1[2] - p0[2];
+            float vx = p2[0] - p0[0], vy = p2[1] - p0[1], vz = p2[2] - p0[2];
+            float nx = uy * vz - uz * vy;
+            float ny = uz * vx - ux * vz;
+            float nz = ux * vy - uy * vx;
+            float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+            if (len > 0)
+            {
+                nx /= len;
+                ny /= len;
+                nz /= len;
+            }
+            else
+            {
+                nx = 0.0f;
+                ny = 0.0f;
+                nz = 1.0f;
+            }
+
+            for (size_t c = 0; c < 3; ++c)
+            {
+                unsigned int uvIdx = (i + 2 < mesh._textureIndices.size()) ? mesh._textureIndices[i + c] : 0;
+                bool hasUV = uvIdx * 2 + 1 < mesh.uvs.size();
+                CornerKey key{idx[c], hasUV ? uvIdx : ~0u, nx, ny, nz};
+                auto found = corners.find(key);
+                if (found == corners.end())
+                {
+                    const float* p = &mesh.vertices[idx[c] * 3];
+                    GpuVertex vertex = {{p[0], p[1], p[2]}, {nx, ny, nz}, {0.0f, 0.0f}};
+                    if (hasUV)
+                    {
+                        vertex.uv[0] = mesh.uvs[uvIdx * 2];
+                        vertex.uv[1] = mesh.uvs[uvIdx * 2 + 1];
+                    }
+                    found = corners.emplace(key, static_cast<unsigned int>(vertices.size())).first;
+                    vertices.push_back(vertex);
+                }
+                indices.push_back(found->second);
+            }
+        }
+        if (indices.empty())
+            return nullptr;
+        return CompiledMesh::fromBuffers(std::move(vertices), std::move(indices));
+    }
+
+    bool ResourceManager::uploadMesh(MeshData& mesh)
+    {
+        const CompiledMesh* compiled = mesh.compiled.get();
+        if (!compiled || compiled->indexCount() == 0)
+            return false;
+
+        // Straight from the mapped cache file when there is one.
+        glGenVertexArrays(1, &mesh.vao);
+        glBindVertexArray(mesh.vao);
+        glGenBuffers(1, &mesh.vbo);
+        glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GpuVertex) * compiled->vertexCount(), compiled->vertices(), GL_STATIC_DRAW);
+        glGenBuffers(1, &mesh.ibo);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * compiled->indexCount(), compiled->indices(), GL_STATIC_DRAW);
+        MeshPipeline::setVertexLayout();
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        mesh.indexCount = static_cast<GLsizei>(compiled->indexCount());
+        return true;
+    }
+
+    void ResourceManager::startLoader()
+    {
+        _loader.start(_loaderWorkers);
+        if (_loaderWorkers > 0)
+            std::cout << "[ResourceManager] Loading assets on " << _loaderWorkers << " threads, uploading up to "
+                      << _uploadBudget / 1024 << " KiB per frame" << std::endl;
+    }
+
+    void ResourceManager::stopLoader()
+    {
+        _loader.stop();
+    }
+
+    void ResourceManager::request(LoadedAsset::Kind kind, const std::string &path)
+    {
+        _assetStatus[path] = AssetStatus::Pending;
+        ++_pendingAssets;
+        LoadedAsset asset;
+        asset.kind = kind;
+        asset.path = path;
+        asset.requested = std::chrono::steady_clock::now();
+        const AssetLoader::Decoder decode = kind == LoadedAsset::Kind::Texture ? &decodeTexture : &decodeMesh;
+        if (_loader.running())
+        {
+            _loader.submit(std::move(asset), decode);
+            return;
+        }
+        decode(asset);
+        finishAsset(asset, false);
+    }
+
+    void ResourceManager::uploadLoadedAssets(bool prepareMeshes)
+    {
+        // At least one asset per frame, however large.
+        size_t uploaded = 0;
+        LoadedAsset asset;
+        while (uploaded < _uploadBudget && _loader.poll(asset))
+            uploaded += finishAsset(asset, prepareMeshes);
+    }
+
+    size_t ResourceManager::finishAsset(LoadedAsset &asset, bool prepareMeshes)
+    {
+        size_t uploaded = 0;
+        if (asset.ok && asset.kind == LoadedAsset::Kind::Texture)
+        {
+            GLuint textureID;
+            glGenTextures(1, &textureID);
+            glBindTexture(GL_TEXTURE_2D, textureID);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, asset.width, asset.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, asset.pixels.data());
+
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+            _textureCache[asset.path] = textureID;
+            uploaded = asset.pixels.size();
+        }
+        else if (asset.ok)
+        {
+            const CompiledMesh &compiled = *asset.mesh.compiled;
+            _meshCache[asset.path] = std::move(asset.mesh);
+            if (prepareMeshes)
+            {
+                prepareMesh(asset.path);
+                uploaded = sizeof(GpuVertex) * compiled.vertexCount() + sizeof(uint32_t) * compiled.indexCount();
+            }
+        }
+
+        _assetStatus[asset.path] = asset.ok ? AssetStatus::Ready : AssetStatus::Failed;
+        --_pendingAssets;
+        if (!asset.ok)
+            ++_failedAssets;
+        _loadTimes.add(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - asset.requested).count());
+        return uploaded;
+    }
+
+    AssetStatus ResourceManager::assetStatus(const std::string &path) const
+    {
+        auto it = _assetStatus.find(path);
+        return it == _assetStatus.end() ? AssetStatus::Unknown : it->second;
+    }
+
+    LoadTimeHistogram ResourceManager::takeLoadTimes()
+    {
+        const LoadTimeHistogram times = _loadTimes;
+        _loadTimes = LoadTimeHistogram{};
+        return times;
+    }
+
     void ResourceManager::loadMesh(const std::string &path)
     {
         if (path.empty())
             return;
-        if (_meshCache.find(path) != _meshCache.end()) return;
+        if (assetStatus(path) != AssetStatus::Unknown) return;
+        request(LoadedAsset::Kind::Mesh, path);
+    }
 
+    void ResourceManager::decodeMesh(LoadedAsset &asset)
+    {
+        const std::string &path = asset.path;
+        MeshData &meshData = asset.mesh;
+        MeshSourceStamp stamp;
+        const bool hasSource = MeshSourceStamp::read(path, stamp);
+        const std::string cachePath = path + MESH_CACHE_SUFFIX;
+        if (hasSource)
+            meshData.compiled = CompiledMesh::map(cachePath, stamp);
+
+        if (meshData.compiled)
+        {
+            std::cout << "[ResourceManager] Mapped mesh " << cachePath << " with " << meshData.compiled->vertexCount()
+                      << " vertices and " << meshData.compiled->indexCount() << " indices." << std::endl;
+        }
+        else
+        {
+            if (!parseObj(path, meshData))
+                return;
+            meshData.compiled = compileMesh(meshData);
+            if (hasSource && meshData.compiled && !meshData.compiled->write(cachePath, stamp))
+                std::cerr << "[ResourceManager] Could not write mesh cache " << cachePath << std::endl;
+        }
+        asset.ok = meshData.compiled != nullptr;
+        if (asset.ok)
+            meshData.boundsRadius = boundingRadius(*meshData.compiled);
+    }
+
+    bool ResourceManager::parseObj(const std::string &path, MeshData &meshData)
+    {
         std::ifstream file(path);
         if (!file.is_open())
         {
             std::cerr << "Failed to open mesh file: " << path << std::endl;
-            return;
+            return false;
         }
 
-        MeshData meshData;
         std::string line;
         std::vector<Vector3f> tempVertices;
         std::vector<Vector2f> tempTextures;
@@ -156,157 +440,145 @@ namespace rtypeEngine {
             meshData.uvs.push_back(v.y);
         }
         std::cout << "[ResourceManager] Loaded mesh " << path << " with " << meshData.vertices.size() / 3 << " vertices, " << meshData.uvs.size() / 2 << " UVs, and " << meshData._textureIndices.size() << " UV indices." << std::endl;
-        _meshCache[path] = meshData;
+        return true;
     }
 
     GLuint ResourceManager::loadTexture(const std::string &path)
     {
-        if (_textureCache.find(path) != _textureCache.end())
+        auto cached = _textureCache.find(path);
+        if (cached != _textureCache.end())
+            return cached->second;
+        if (assetStatus(path) == AssetStatus::Unknown)
         {
-            return _textureCache[path];
+            request(LoadedAsset::Kind::Texture, path);
+            cached = _textureCache.find(path);
+            if (cached != _textureCache.end())
+                return cached->second;
         }
+        return assetStatus(path) == AssetStatus::Pending ? placeholderTexture() : 0;
+    }
 
+    void ResourceManager::decodeTexture(LoadedAsset &asset)
+    {
         sf::Image image;
-        if (!image.loadFromFile(path))
+        if (!image.loadFromFile(asset.path))
         {
-            std::cerr << "Failed to load texture: " << path << std::endl;
-            return 0;
+            std::cerr << "Failed to load texture: " << asset.path << std::endl;
+            return;
         }
+        asset.width = image.getSize().x;
+        asset.height = image.getSize().y;
+        const uint8_t *pixels = image.getPixelsPtr();
+        asset.pixels.assign(pixels, pixels + static_cast<size_t>(asset.width) * asset.height * 4);
+        asset.ok = true;
+    }
 
-        GLuint textureID;
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, image.getSize().x, image.getSize().y, 0, GL_RGBA, GL_UNSIGNED_BYTE, image.getPixelsPtr());
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        _textureCache[path] = textureID;
-        return textureID;
+    GLuint ResourceManager::placeholderTexture()
+    {
+        if (!_placeholderTexture)
+        {
+            // White, so the object shows in its own color until the texture is in.
+            const uint8_t white[4] = {255, 255, 255, 255};
+            glGenTextures(1, &_placeholderTexture);
+            glBindTexture(GL_TEXTURE_2D, _placeholderTexture);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        }
+        return _placeholderTexture;
     }
 
-    GLuint ResourceManager::createTextTexture(const std::string &text, const std::string &fontPath, unsigned int fontSize, Vector3f color)
+    std::shared_ptr<const ShapedText> ResourceManager::shapeText(const std::string &text, const std::string &fontPath, unsigned int fontSize)
     {
-// Save current OpenGL context
-#ifdef _WIN32
-        HDC oldDC = wglGetCurrentDC();
-        HGLRC oldContext = wglGetCurrentContext();
-#else
-        Display* display = (Display*)_hdc;
-        GLXContext oldContext = glXGetCurrentContext();
-        GLXDrawable oldDrawable = glXGetCurrentDrawable();
+#ifndef _WIN32
+        // SFML needs an X display to rasterize glyphs (it aborts without one).
+        if (_headless && !std::getenv("DISPLAY"))
+        {
+            std::cerr << "[ResourceManager] No X display for SFML, text skipped: " << text << std::endl;
+            return nullptr;
+        }
 #endif
-        (void)oldContext; // suppress unused warning if not used in some paths
 
-        sf::Image textImage;
-        bool success = false;
-
-        // Scope for SFML rendering to ensure resources are cleaned up before context restore
+        auto atlasIt = _glyphAtlases.find({fontPath, fontSize});
+        if (atlasIt != _glyphAtlases.end())
         {
-            if (_fontCache.find(fontPath) == _fontCache.end())
+            // Known glyphs are laid out without touching SFML or OpenGL.
+            GlyphAtlas &atlas = *atlasIt->second;
+            const uint32_t missesBefore = atlas.misses();
+            std::shared_ptr<const ShapedText> shaped;
             {
-                sf::Font font;
-                if (!font.openFromFile(fontPath))
-                {
-                    std::cerr << "Failed to load font: " << fontPath << std::endl;
-// Restore context before returning
-#ifdef _WIN32
-                    if (oldDC && oldContext)
-                        wglMakeCurrent(oldDC, oldContext);
-#endif
-                    return 0;
-                }
-                _fontCache[fontPath] = font;
+                ContextGuard guard(*this);
+                shaped = atlas.shape(text);
+                guard.keep = atlas.misses() == missesBefore;
             }
+            _atlasMisses += atlas.misses() - missesBefore;
+            return shaped;
+        }
 
-            sf::Text sfText(_fontCache[fontPath]);
-            sfText.setString(text);
-            sfText.setCharacterSize(fontSize);
-            sfText.setFillColor(sf::Color(color.x * 255, color.y * 255, color.z * 255));
-
-            sf::FloatRect bounds = sfText.getLocalBounds();
-            unsigned int width = (unsigned int)std::ceil(bounds.size.x + bounds.position.x);
-            unsigned int height = (unsigned int)std::ceil(bounds.size.y + bounds.position.y);
-
-            if (width == 0)
-                width = 1;
-            if (height == 0)
-                height = 1;
-
-            sf::RenderTexture renderTexture;
-            if (renderTexture.resize({width, height}))
+        ContextGuard guard(*this);
+        if (_fontCache.find(fontPath) == _fontCache.end())
+        {
+            sf::Font font;
+            if (!font.openFromFile(fontPath))
             {
-                renderTexture.clear(sf::Color::Transparent);
-                renderTexture.draw(sfText);
-                renderTexture.display();
-                textImage = renderTexture.getTexture().copyToImage();
-                success = true;
+                std::cerr << "Failed to load font: " << fontPath << std::endl;
+                return nullptr;
             }
+            _fontCache[fontPath] = font;
         }
+        auto &atlas = _glyphAtlases[{fontPath, fontSize}];
+        atlas = std::make_unique<GlyphAtlas>(_fontCache[fontPath], fontSize);
+        return atlas->shape(text);
+    }
 
-// Activate our renderer context to ensure the texture is created in the correct context
+    void ResourceManager::releaseTextAtlases()
+    {
+        for (auto &pair : _glyphAtlases)
+            pair.second->releaseTexture();
+    }
+
+    uint32_t ResourceManager::takeAtlasMisses()
+    {
+        const uint32_t misses = _atlasMisses;
+        _atlasMisses = 0;
+        return misses;
+    }
+
+    // SFML rasterizes glyphs with its own context; the one current before
+    // (if any) is restored afterwards unless `keep` says SFML did not run.
+    ResourceManager::ContextGuard::ContextGuard(ResourceManager &owner)
+        : _owner(owner)
+    {
 #ifdef _WIN32
-        if (_hglrc && _hdc)
-        {
-            wglMakeCurrent((HDC)_hdc, (HGLRC)_hglrc);
-        }
+        _dc = wglGetCurrentDC();
+        _context = wglGetCurrentContext();
 #else
-        // On Linux, make our GL context current for texture creation
-        if (_hdc && _hwnd && _hglrc)
+        if (!_owner._headless)
         {
-            glXMakeCurrent(display, (Window)_hwnd, (GLXContext)_hglrc);
+            _context = glXGetCurrentContext();
+            _drawable = glXGetCurrentDrawable();
         }
 #endif
+    }
 
-        if (!success)
-        {
-// Restore original context if we failed
-#ifdef _WIN32
-            if (oldDC && oldContext)
-                wglMakeCurrent(oldDC, oldContext);
-            else
-                wglMakeCurrent(NULL, NULL);
-#else
-            if (oldContext)
-                glXMakeCurrent(display, oldDrawable, oldContext);
-            else
-                glXMakeCurrent(display, None, NULL);
-#endif
-            return 0;
-        }
-
-        // Create texture in the main context
-        GLuint textureID;
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textImage.getSize().x, textImage.getSize().y, 0, GL_RGBA, GL_UNSIGNED_BYTE, textImage.getPixelsPtr());
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-// Restore original context
+    ResourceManager::ContextGuard::~ContextGuard()
+    {
+        if (keep)
+            return;
 #ifdef _WIN32
-        if (oldDC && oldContext)
-        {
-            wglMakeCurrent(oldDC, oldContext);
-        }
+        if (_dc && _context)
+            wglMakeCurrent((HDC)_dc, (HGLRC)_context);
         else
-        {
             wglMakeCurrent(NULL, NULL);
-        }
 #else
-        // Restore context on Linux - release it so loop() can acquire it
-        if (oldContext)
-             glXMakeCurrent(display, oldDrawable, oldContext);
+        Display *display = (Display *)_owner._hdc;
+        if (_owner._headless || !display)
+            return;
+        if (_context)
+            glXMakeCurrent(display, (GLXDrawable)_drawable, (GLXContext)_context);
         else
-             glXMakeCurrent(display, None, NULL);
+            glXMakeCurrent(display, None, NULL);
 #endif
-
-        return textureID;
     }
 
 }
@@ -1,22 +1,56 @@
 #pragma once
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
 #include <GL/glew.h>
 #include <SFML/Graphics.hpp>
 #include "RenderStructs.hpp"
+#include "GlyphAtlas.hpp"
+#include "AssetLoader.hpp"
 
 namespace rtypeEngine {
     class ResourceManager {
     public:
-        ResourceManager(void*& hdc, void*& hwnd, void*& hglrc);
+        static constexpr unsigned int DEFAULT_LOADER_WORKERS = 2;
+        static constexpr size_t DEFAULT_UPLOAD_BUDGET = 4 * 1024 * 1024; // bytes per frame
+
+        ResourceManager(void*& hdc, void*& hwnd, void*& hglrc, const bool& headless);
         ~ResourceManager() = default;
 
+        /// Decoding threads used from startLoader() on; 0 loads synchronously.
+        void setLoaderWorkers(unsigned int workers) { _loaderWorkers = workers; }
+        void setUploadBudget(size_t bytes) { _uploadBudget = bytes; }
+        void startLoader();
+        void stopLoader();
+        /// Uploads decoded assets until the frame budget is spent (GL context current).
+        void uploadLoadedAssets(bool prepareMeshes);
+
+        /// Requests the mesh; it maps the binary cache of `path` (see MeshCache.hpp), or parses the OBJ and writes it.
         void loadMesh(const std::string& path);
+        /// Texture of `path`, a white placeholder while it loads, 0 if it failed.
         GLuint loadTexture(const std::string& path);
-        GLuint createTextTexture(const std::string& text, const std::string& fontPath, unsigned int fontSize, Vector3f color);
+        AssetStatus assetStatus(const std::string& path) const;
+        size_t pendingAssets() const { return _pendingAssets; }
+        size_t failedAssets() const { return _failedAssets; }
+        /// Load times of the assets finished since the last call.
+        LoadTimeHistogram takeLoadTimes();
+        /// Layout of `text` from the glyph atlas of (font, size); null if it cannot be drawn.
+        std::shared_ptr<const ShapedText> shapeText(const std::string& text, const std::string& fontPath, unsigned int fontSize);
+        /// Deletes the atlas textures (GL context current); they are rebuilt on the next draw.
+        void releaseTextAtlases();
+        /// Glyphs rasterized since the last call.
+        uint32_t takeAtlasMisses();
 
-        const MeshData* getMesh(const std::string& path) const;
+        /// Mesh with the position/UV arrays of the immediate-mode path (a unit cube while it loads).
+        const MeshData* getMesh(const std::string& path);
+        /// Mesh with its VBO/IBO/VAO, uploaded on the first call (GL context current; a unit cube while it loads).
+        const MeshData* prepareMesh(const std::string& path);
+        /// Model-space bounding radius of the mesh (or its placeholder); negative if there is none.
+        float meshRadius(const std::string& path);
+        void releaseMeshBuffers();
         GLuint getTexture(const std::string& path) const;
         sf::Font* getFont(const std::string& path);
 
@@ -24,9 +58,49 @@ namespace rtypeEngine {
         std::map<std::string, MeshData> _meshCache;
         std::map<std::string, GLuint> _textureCache;
         std::map<std::string, sf::Font> _fontCache;
+        std::map<std::pair<std::string, unsigned int>, std::unique_ptr<GlyphAtlas>> _glyphAtlases;
+        uint32_t _atlasMisses = 0;
+
+        AssetLoader _loader;
+        unsigned int _loaderWorkers = DEFAULT_LOADER_WORKERS;
+        size_t _uploadBudget = DEFAULT_UPLOAD_BUDGET;
+        std::map<std::string, AssetStatus> _assetStatus;
+        size_t _pendingAssets = 0;
+        size_t _failedAssets = 0;
+        LoadTimeHistogram _loadTimes;
+        GLuint _placeholderTexture = 0;
+        MeshData _placeholderMesh;
+
+        /// Restores the GL context that was current before SFML ran.
+        struct ContextGuard {
+            explicit ContextGuard(ResourceManager& owner);
+            ~ContextGuard();
+            bool keep = false; // SFML did not touch OpenGL, nothing to restore
+
+        private:
+            ResourceManager& _owner;
+            void* _dc = nullptr;
+            void* _context = nullptr;
+            unsigned long _drawable = 0;
+        };
+
+        void request(LoadedAsset::Kind kind, const std::string& path);
+        /// Stores a decoded asset; returns the bytes uploaded.
+        size_t finishAsset(LoadedAsset& asset, bool prepareMeshes);
+        MeshData* findMesh(const std::string& path);
+        GLuint placeholderTexture();
+
+        // Run on the loader threads.
+        static void decodeTexture(LoadedAsset& asset);
+        static void decodeMesh(LoadedAsset& asset);
+        static bool parseObj(const std::string& path, MeshData& mesh);
+        static std::shared_ptr<const CompiledMesh> compileMesh(const MeshData& mesh);
+        static float boundingRadius(const CompiledMesh& mesh);
+        static bool uploadMesh(MeshData& mesh);
 
         void*& _hdc;
         void*& _hwnd;
         void*& _hglrc;
+        const bool& _headless;
     };
 }
@@ -17,7 +17,11 @@ namespace rtypeEngine {
 
 SFMLWindowManager::SFMLWindowManager(const char* pubEndpoint, const char* subEndpoint)
     : IWindowManager(pubEndpoint, subEndpoint), _window(nullptr), _texture(sf::Vector2u(1, 1)), _sprite(_texture),
-      _windowTitle("R-Type Clone"), _windowedSize{800, 600}, _isFullscreen(false) {}
+      _windowTitle("R-Type Clone"), _windowedSize{800, 600}, _isFullscreen(false) {
+    // Input polling and frame presentation: the newest frame ticket received
+    // on the bus is presented on the next tick, so at most 1/120 s late.
+    setTickRate(WINDOW_TICK_RATE);
+}
 
 void SFMLWindowManager::init() {
     createWindow(_windowTitle, _windowedSize);
@@ -123,12 +127,15 @@ void SFMLWindowManager::loop() {
             sendMessage("KeyPressed", keyMappings.at(key));
         }
     }
+
+    presentRingFrame();
 }
 
 void SFMLWindowManager::cleanup() {
     if (_window && _window->isOpen()) {
         _window->close();
     }
+    _frameRing.close();
 }
 
 void SFMLWindowManager::createWindow(const std::string &title, const Vector2u &size) {
@@ -162,8 +169,70 @@ void SFMLWindowManager::drawPixels(const std::vector<uint32_t> &pixels, const Ve
 
 }
 
+void SFMLWindowManager::prepareTexture(unsigned int width, unsigned int height, bool bottomUp) {
+    sf::Vector2u texSize = _texture.getSize();
+    if (texSize.x != width || texSize.y != height) {
+        _texture = sf::Texture(sf::Vector2u(width, height));
+        _sprite = sf::Sprite(_texture);
+        _sprite.setPosition(sf::Vector2f(0,0));
+        _sprite.setScale(sf::Vector2f(1.0f,1.0f));
+    }
+    // Bottom-up frames (straight from glReadPixels) are flipped by the texture rect.
+    int w = static_cast<int>(width);
+    int h = static_cast<int>(height);
+    if (bottomUp) {
+        _sprite.setTextureRect(sf::IntRect(sf::Vector2i(0, h), sf::Vector2i(w, -h)));
+    } else {
+        _sprite.setTextureRect(sf::IntRect(sf::Vector2i(0, 0), sf::Vector2i(w, h)));
+    }
+}
+
+void SFMLWindowManager::presentRingFrame() {
+    if (!_hasPendingTicket || !_window || !_window->isOpen()) {
+        return;
+    }
+    _hasPendingTicket = false;
+
+    if (_frameRing.name() != _pendingTicket.name) {
+        if (!_frameRing.open(_pendingTicket.name)) {
+            std::cerr << "[SFMLWindowManager] handleImageRendered: cannot open frame ring '" << _pendingTicket.name << "'" << std::endl;
+            return;
+        }
+    }
+
+    const uint8_t* pixels = _frameRing.acquire(_pendingTicket);
+    if (!pixels) {
+        // Producer already reused the slot; a newer ticket is on its way.
+        return;
+    }
+
+    prepareTexture(_pendingTicket.width, _pendingTicket.height, true);
+    _window->setActive(true);
+    _texture.update(pixels);
+    if (!_frameRing.stillValid(_pendingTicket)) {
+        // Slot was overwritten during the upload, skip the torn frame.
+        return;
+    }
+
+    _window->clear();
+    _window->draw(_sprite);
+    _window->display();
+}
+
 void SFMLWindowManager::handleImageRendered(const std::string& pixelData) {
-    // Message format: "<width>,<height>;<raw-pixel-bytes...>"
+    if (FrameRing::isTicket(pixelData)) {
+        // Only the newest ticket is kept; it is presented once per loop().
+        FrameRingTicket ticket;
+        if (!FrameRing::decodeTicket(pixelData, ticket)) {
+            std::cerr << "[SFMLWindowManager] handleImageRendered: invalid ticket '" << pixelData << "'" << std::endl;
+            return;
+        }
+        _pendingTicket = std::move(ticket);
+        _hasPendingTicket = true;
+        return;
+    }
+
+    // Legacy message format: "<width>,<height>;<raw-pixel-bytes...>"
     // Parse header
     auto sep = pixelData.find(';');
     if (sep == std::string::npos) {
@@ -198,14 +267,7 @@ void SFMLWindowManager::handleImageRendered(const std::string& pixelData) {
     }
 
     // If the texture size doesn't match the incoming image, recreate the texture and sprite
-    sf::Vector2u texSize = _texture.getSize();
-    if (texSize.x != width || texSize.y != height) {
-        _texture = sf::Texture(sf::Vector2u(width, height));
-        _sprite = sf::Sprite(_texture);
-        _sprite.setTextureRect(sf::IntRect(sf::Vector2i(0,0), sf::Vector2i(static_cast<int>(width), static_cast<int>(height))));
-        _sprite.setPosition(sf::Vector2f(0,0));
-        _sprite.setScale(sf::Vector2f(1.0f,1.0f));
-    }
+    prepareTexture(width, height, false);
 
     const uint32_t* pixelPtr = reinterpret_cast<const uint32_t*>(body.data());
     std::vector<uint32_t> pixels(pixelPtr, pixelPtr + pixelCount);
@@ -8,7 +8,7 @@
  * @section channels_sub Subscribed Channels
  * | Channel | Payload | Description |
  * |---------|---------|-------------|
- * | `ImageRendered` | Raw pixel data | Display rendered frame from Renderer |
+ * | `ImageRendered` | Frame ring ticket or "w,h;pixels" | Display rendered frame from Renderer |
  * | `SetFullscreen` | "true"/"false" | Toggle fullscreen mode |
  * | `SetWindowSize` | "width,height" | Resize window |
  * | `GetWindowInfo` | - | Request window info |
@@ -31,6 +31,7 @@
 #include <SFML/Graphics.hpp>
 #include <memory>
 #include "../IWindowManager.hpp"
+#include "../../../types/frameRing.hpp"
 
 namespace rtypeEngine {
 class SFMLWindowManager : public IWindowManager {
@@ -48,11 +49,15 @@ class SFMLWindowManager : public IWindowManager {
     void drawPixels(const std::vector<uint32_t> &pixels, const Vector2u &size) override;
 
   private:
+    static constexpr double WINDOW_TICK_RATE = 120.0;
+
     void handleImageRendered(const std::string& message);
     void handleSetFullscreen(const std::string& message);
     void handleSetWindowSize(const std::string& message);
     void handleGetWindowInfo(const std::string& message);
     void recreateWindow(bool fullscreen);
+    void prepareTexture(unsigned int width, unsigned int height, bool bottomUp);
+    void presentRingFrame();
     
     std::unique_ptr<sf::RenderWindow> _window;
     sf::Texture _texture;
@@ -61,5 +66,9 @@ class SFMLWindowManager : public IWindowManager {
     std::string _windowTitle = "R-Type Clone";
     Vector2u _windowedSize = {800, 600};
     bool _isFullscreen = false;
+
+    FrameRing _frameRing;
+    FrameRingTicket _pendingTicket;
+    bool _hasPendingTicket = false;
 };
 }  // namespace rtypeEngine
@@ -0,0 +1,191 @@
+/**
+ * @file busCodec.hpp
+ * @brief Packed binary payloads for the hot message bus channels
+ *
+ * @details `EntityUpdated`, `PhysicCommand`, `RenderEntityCommand` and the
+ * snapshot channels (`NetworkSnapshot`, `SnapshotReceived`) carry per-entity
+ * float updates every tick. Instead of formatting and reparsing
+ * text, producers can batch them into one binary payload:
+ *
+ * @code
+ * Header   : u8 marker (0x1B) | u8 version | u16 reserved | u32 sectionCount
+ * Section  : u16 opcode | u16 floatCount | u32 recordCount | records...
+ * Record   : char id[ENTITY_ID_SIZE] (zero padded) | float values[floatCount]
+ * @endcode
+ *
+ * Consecutive records with the same opcode share a section, so order is kept
+ * across mixed commands. Each section states its own float count, so a
+ * decoder skips opcodes it does not know about. Values are host-endian: the
+ * bus never leaves the machine.
+ *
+ * Text payloads never start with the marker byte, so both formats can share
+ * a channel. `RTYPE_BUS_TEXT=1` makes producers keep emitting text, which is
+ * handy when reading bus traffic with `RTYPE_DEBUG`.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace rtypeEngine {
+namespace busCodec {
+
+constexpr uint8_t MARKER = 0x1B;
+constexpr uint8_t VERSION = 1;
+constexpr std::size_t HEADER_SIZE = 8;
+constexpr std::size_t SECTION_HEADER_SIZE = 8;
+constexpr std::size_t ENTITY_ID_SIZE = 36;  // UUID string length
+constexpr uint16_t MAX_FLOATS = 16;
+
+enum class Op : uint16_t {
+  // EntityUpdated (PhysicEngine -> ECS): x,y,z,rx,ry,rz
+  EntityUpdated = 1,
+  PhysicsStep = 2,  // seqLow16,seqHigh16 (id "step"), leads each EntityUpdated batch
+
+  // PhysicCommand (ECS -> PhysicEngine)
+  SetLinearVelocity = 16,   // vx,vy,vz
+  SetAngularVelocity = 17,  // wx,wy,wz
+  ApplyForce = 18,          // fx,fy,fz
+  ApplyImpulse = 19,        // ix,iy,iz
+  SetTransform = 20,        // x,y,z,rx,ry,rz
+
+  // RenderEntityCommand (ECS -> Renderer)
+  RenderSetPosition = 32,   // x,y,z
+  RenderSetRotation = 33,   // rx,ry,rz
+  RenderSetScale = 34,      // sx,sy,sz
+  RenderSetColor = 35,      // r,g,b
+  RenderSetTransform = 36,  // x,y,z,rx,ry,rz[,sx,sy,sz]
+
+  // NetworkSnapshot (ECS -> NetworkManager) / SnapshotReceived (NetworkManager -> ECS)
+  SnapshotEntity = 48,   // kind,x,y,z,rx,ry,rz,vx,vy,vz
+  SnapshotRemoved = 49,  // no values
+};
+
+inline bool isBinary(const std::string& payload) {
+  return payload.size() >= HEADER_SIZE && static_cast<uint8_t>(payload[0]) == MARKER;
+}
+
+inline bool textFallbackEnabled() {
+  static bool enabled = [] {
+    const char* value = std::getenv("RTYPE_BUS_TEXT");
+    return value != nullptr && value[0] != '\0' && value[0] != '0';
+  }();
+  return enabled;
+}
+
+/// Valid payload with no records (e.g. "no replicated entities left").
+inline std::string emptyPayload() {
+  std::string payload(HEADER_SIZE, '\0');
+  payload[0] = static_cast<char>(MARKER);
+  payload[1] = static_cast<char>(VERSION);
+  return payload;
+}
+
+/// Accumulates records and produces one binary payload.
+class BatchWriter {
+ public:
+  /// Returns false (and writes nothing) if the id does not fit a record.
+  bool add(Op op, const std::string& id, const float* values, uint16_t count) {
+    if (id.empty() || id.size() > ENTITY_ID_SIZE || count > MAX_FLOATS) return false;
+    if (_buffer.empty()) {
+      _buffer.assign(HEADER_SIZE, '\0');
+      _buffer[0] = static_cast<char>(MARKER);
+      _buffer[1] = static_cast<char>(VERSION);
+      _sectionCount = 0;
+    }
+    if (_sectionCount == 0 || op != _sectionOp || count != _sectionFloats) {
+      _sectionStart = _buffer.size();
+      _sectionOp = op;
+      _sectionFloats = count;
+      _sectionRecords = 0;
+      ++_sectionCount;
+      _buffer.append(SECTION_HEADER_SIZE, '\0');
+      uint16_t opcode = static_cast<uint16_t>(op);
+      std::memcpy(&_buffer[_sectionStart], &opcode, sizeof(opcode));
+      std::memcpy(&_buffer[_sectionStart + 2], &count, sizeof(count));
+    }
+    std::size_t offset = _buffer.size();
+    _buffer.append(ENTITY_ID_SIZE + count * sizeof(float), '\0');
+    std::memcpy(&_buffer[offset], id.data(), id.size());
+    if (count > 0) {
+      std::memcpy(&_buffer[offset + ENTITY_ID_SIZE], values, count * sizeof(float));
+    }
+    ++_sectionRecords;
+    std::memcpy(&_buffer[_sectionStart + 4], &_sectionRecords, sizeof(_sectionRecords));
+    ++_records;
+    return true;
+  }
+
+  bool empty() const { return _records == 0; }
+  std::size_t recordCount() const { return _records; }
+
+  /// Hand out the finished payload and reset for the next batch.
+  std::string take() {
+    std::string out;
+    if (_records == 0) return out;
+    std::memcpy(&_buffer[4], &_sectionCount, sizeof(_sectionCount));
+    out.swap(_buffer);
+    _buffer.reserve(out.capacity());
+    _records = 0;
+    _sectionCount = 0;
+    return out;
+  }
+
+ private:
+  std::string _buffer;
+  std::size_t _sectionStart = 0;
+  Op _sectionOp = Op::EntityUpdated;
+  uint16_t _sectionFloats = 0;
+  uint32_t _sectionRecords = 0;
+  uint32_t _sectionCount = 0;
+  std::size_t _records = 0;
+};
+
+/**
+ * Walk every record of a binary payload.
+ * @param fn called as fn(Op op, const std::string& id, const float* values, uint16_t count)
+ * @return false if the payload is malformed or has an unknown version.
+ */
+template <typename Fn>
+bool decode(const std::string& payload, Fn&& fn) {
+  if (!isBinary(payload) || static_cast<uint8_t>(payload[1]) != VERSION) return false;
+  uint32_t sections = 0;
+  std::memcpy(&sections, payload.data() + 4, sizeof(sections));
+
+  std::size_t offset = HEADER_SIZE;
+  std::string id;
+  id.reserve(ENTITY_ID_SIZE);
+  float values[MAX_FLOATS];
+  for (uint32_t s = 0; s < sections; ++s) {
+    if (offset + SECTION_HEADER_SIZE > payload.size()) return false;
+    uint16_t opcode = 0;
+    uint16_t count = 0;
+    uint32_t records = 0;
+    std::memcpy(&opcode, payload.data() + offset, sizeof(opcode));
+    std::memcpy(&count, payload.data() + offset + 2, sizeof(count));
+    std::memcpy(&records, payload.data() + offset + 4, sizeof(records));
+    offset += SECTION_HEADER_SIZE;
+
+    if (count > MAX_FLOATS) return false;
+    const std::size_t recordSize = ENTITY_ID_SIZE + count * sizeof(float);
+    if (records > (payload.size() - offset) / recordSize) return false;
+
+    for (uint32_t r = 0; r < records; ++r) {
+      const char* rec = payload.data() + offset;
+      const void* nul = std::memchr(rec, '\0', ENTITY_ID_SIZE);
+      std::size_t idLen = nul ? static_cast<std::size_t>(static_cast<const char*>(nul) - rec) : ENTITY_ID_SIZE;
+      id.assign(rec, idLen);
+      std::memcpy(values, rec + ENTITY_ID_SIZE, count * sizeof(float));
+      fn(static_cast<Op>(opcode), id, static_cast<const float*>(values), count);
+      offset += recordSize;
+    }
+  }
+  return true;
+}
+
+}  // namespace busCodec
+}  // namespace rtypeEngine
@@ -1,16 +1,298 @@
 #pragma once
 
 #include <sol/sol.hpp>
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <unordered_map>
 
 namespace rtypeEngine {
 
-    struct ComponentPool {
+    /**
+     * Entity handle: low 32 bits are the slot index, high 32 bits the slot
+     * generation. Destroying an entity bumps its slot generation so stale
+     * handles never alias a recycled slot.
+     */
+    using EntityHandle = uint64_t;
+
+    constexpr EntityHandle INVALID_ENTITY = ~static_cast<EntityHandle>(0);
+    constexpr uint32_t INVALID_INDEX = ~static_cast<uint32_t>(0);
+
+    inline uint32_t entityIndex(EntityHandle handle) { return static_cast<uint32_t>(handle); }
+    inline uint32_t entityGeneration(EntityHandle handle) { return static_cast<uint32_t>(handle >> 32); }
+    inline EntityHandle makeEntityHandle(uint32_t index, uint32_t generation) {
+        return (static_cast<EntityHandle>(generation) << 32) | index;
+    }
+
+    /**
+     * Sparse set of entity slot indices: `sparse` maps index -> dense row,
+     * `entities` maps row -> index. Pools derive from it and keep their data
+     * in rows parallel to `entities`.
+     */
+    struct SparseSet {
+        std::vector<uint32_t> entities;
+        std::vector<uint32_t> sparse;
+
+        bool has(uint32_t index) const {
+            return index < sparse.size() && sparse[index] != INVALID_INDEX;
+        }
+
+        uint32_t rowOf(uint32_t index) const { return has(index) ? sparse[index] : INVALID_INDEX; }
+        std::size_t size() const { return entities.size(); }
+
+      protected:
+        /// Append a row for a new index and return it.
+        uint32_t insertIndex(uint32_t index) {
+            if (index >= sparse.size()) {
+                sparse.resize(index + 1, INVALID_INDEX);
+            }
+            uint32_t row = static_cast<uint32_t>(entities.size());
+            sparse[index] = row;
+            entities.push_back(index);
+            return row;
+        }
+
+        /// Swap-remove bookkeeping. Returns the vacated row; the caller moves
+        /// its data from row size() (the old last row) into it, then pops.
+        uint32_t eraseIndex(uint32_t index) {
+            uint32_t row = sparse[index];
+            uint32_t last = static_cast<uint32_t>(entities.size() - 1);
+            if (row != last) {
+                entities[row] = entities[last];
+                sparse[entities[row]] = row;
+            }
+            entities.pop_back();
+            sparse[index] = INVALID_INDEX;
+            return row;
+        }
+
+        void clearIndices() {
+            entities.clear();
+            sparse.clear();
+        }
+    };
+
+    /// Generic component storage: one Lua table per entity.
+    struct ComponentPool : SparseSet {
         std::vector<sol::table> dense;
-        std::vector<std::string> entities;
-        std::unordered_map<std::string, size_t> sparse;
+
+        sol::table* get(uint32_t index) {
+            return has(index) ? &dense[sparse[index]] : nullptr;
+        }
+
+        void set(uint32_t index, const sol::table& component) {
+            if (has(index)) {
+                dense[sparse[index]] = component;
+                return;
+            }
+            insertIndex(index);
+            dense.push_back(component);
+        }
+
+        bool remove(uint32_t index) {
+            if (!has(index)) return false;
+            uint32_t row = eraseIndex(index);
+            if (row != dense.size() - 1) {
+                dense[row] = std::move(dense.back());
+            }
+            dense.pop_back();
+            return true;
+        }
+    };
+
+    /**
+     * Typed component storage registered from a schema: every field is a
+     * float column (structure of arrays). Keys outside the schema go to a
+     * per-entity Lua table created on first use, so scripts can still hang
+     * ad-hoc data off a typed component.
+     */
+    struct TypedComponentPool : SparseSet {
+        std::string name;
+        std::vector<std::string> fields;
+        std::vector<float> defaults;
+        std::vector<std::vector<float>> columns;
+        std::vector<sol::table> extras;
+
+        TypedComponentPool() = default;
+        TypedComponentPool(std::string componentName, std::vector<std::string> fieldNames,
+                           std::vector<float> fieldDefaults)
+            : name(std::move(componentName)), fields(std::move(fieldNames)),
+              defaults(std::move(fieldDefaults)), columns(fields.size()) {}
+
+        /// Schemas are a handful of fields, a linear scan beats hashing.
+        int fieldIndex(const std::string& field) const {
+            for (std::size_t i = 0; i < fields.size(); ++i) {
+                if (fields[i] == field) return static_cast<int>(i);
+            }
+            return -1;
+        }
+
+        /// Row of the entity, adding one filled with defaults if needed.
+        uint32_t emplace(uint32_t index) {
+            if (has(index)) return sparse[index];
+            uint32_t row = insertIndex(index);
+            for (std::size_t f = 0; f < columns.size(); ++f) {
+                columns[f].push_back(defaults[f]);
+            }
+            extras.emplace_back();
+            return row;
+        }
+
+        float& at(uint32_t row, int field) { return columns[field][row]; }
+
+        bool remove(uint32_t index) {
+            if (!has(index)) return false;
+            uint32_t row = eraseIndex(index);
+            uint32_t last = static_cast<uint32_t>(extras.size() - 1);
+            for (auto& column : columns) {
+                column[row] = column[last];
+                column.pop_back();
+            }
+            if (row != last) {
+                extras[row] = std::move(extras[last]);
+            }
+            extras.pop_back();
+            return true;
+        }
+
+        void clear() {
+            clearIndices();
+            for (auto& column : columns) column.clear();
+            extras.clear();
+        }
+    };
+
+    /**
+     * Persistent result of a component query. Membership is kept up to date
+     * by the ECS as components are added and removed; `ids` caches the Lua
+     * array handed to scripts and is only rebuilt after membership changed.
+     */
+    struct EntityQuery : SparseSet {
+        std::string key;
+        std::vector<std::string> components;
+        sol::table ids;
+        bool dirty = true;
+        uint64_t lookups = 0;
+        uint64_t hits = 0;
+        uint64_t rebuilds = 0;
+
+        void add(uint32_t index) {
+            if (has(index)) return;
+            insertIndex(index);
+            dirty = true;
+        }
+
+        void remove(uint32_t index) {
+            if (!has(index)) return;
+            eraseIndex(index);
+            dirty = true;
+        }
+
+        bool uses(const std::string& component) const {
+            for (const auto& name : components) {
+                if (name == component) return true;
+            }
+            return false;
+        }
+
+        void clear() {
+            clearIndices();
+            dirty = true;
+        }
+    };
+
+    /**
+     * Allocates entity slots and keeps the two-way mapping with the string
+     * ids used by Lua, saves and the network. Strings are only hashed when an
+     * id crosses that boundary; everything inside the ECS uses slot indices.
+     */
+    class EntityRegistry {
+      public:
+        /// Register a new entity under the given string id.
+        EntityHandle create(const std::string& id) {
+            uint32_t index;
+            if (!_freeSlots.empty()) {
+                index = _freeSlots.back();
+                _freeSlots.pop_back();
+            } else {
+                index = static_cast<uint32_t>(_slots.size());
+                _slots.push_back(Slot{});
+            }
+            Slot& slot = _slots[index];
+            slot.id = id;
+            slot.alivePos = static_cast<uint32_t>(_alive.size());
+            _alive.push_back(index);
+            _byId[id] = index;
+            return makeEntityHandle(index, slot.generation);
+        }
+
+        /// Handle for an existing id, registering ids created elsewhere (saves, network).
+        EntityHandle findOrCreate(const std::string& id) {
+            EntityHandle handle = find(id);
+            return handle != INVALID_ENTITY ? handle : create(id);
+        }
+
+        EntityHandle find(const std::string& id) const {
+            auto it = _byId.find(id);
+            if (it == _byId.end()) return INVALID_ENTITY;
+            return makeEntityHandle(it->second, _slots[it->second].generation);
+        }
+
+        bool alive(EntityHandle handle) const {
+            uint32_t index = entityIndex(handle);
+            return index < _slots.size() && _slots[index].alivePos != INVALID_INDEX &&
+                   _slots[index].generation == entityGeneration(handle);
+        }
+
+        /// String id of a live slot index.
+        const std::string& idAt(uint32_t index) const { return _slots[index].id; }
+
+        /// O(1): the slot goes back to the free list with a new generation.
+        bool destroy(EntityHandle handle) {
+            if (!alive(handle)) return false;
+            uint32_t index = entityIndex(handle);
+            Slot& slot = _slots[index];
+
+            uint32_t pos = slot.alivePos;
+            uint32_t moved = _alive.back();
+            _alive[pos] = moved;
+            _slots[moved].alivePos = pos;
+            _alive.pop_back();
+
+            _byId.erase(slot.id);
+            slot.id.clear();
+            slot.alivePos = INVALID_INDEX;
+            ++slot.generation;
+            _freeSlots.push_back(index);
+            return true;
+        }
+
+        /// Slot indices of all live entities (unordered).
+        const std::vector<uint32_t>& aliveIndices() const { return _alive; }
+        std::size_t size() const { return _alive.size(); }
+
+        void clear() {
+            for (uint32_t index : _alive) {
+                _slots[index].id.clear();
+                _slots[index].alivePos = INVALID_INDEX;
+                ++_slots[index].generation;
+                _freeSlots.push_back(index);
+            }
+            _alive.clear();
+            _byId.clear();
+        }
+
+      private:
+        struct Slot {
+            std::string id;
+            uint32_t generation = 0;
+            uint32_t alivePos = INVALID_INDEX;
+        };
+
+        std::vector<Slot> _slots;
+        std::vector<uint32_t> _freeSlots;
+        std::vector<uint32_t> _alive;
+        std::unordered_map<std::string, uint32_t> _byId;
     };
 
 }
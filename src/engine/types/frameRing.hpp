@@ -0,0 +1,293 @@
+/**
+ * @file frameRing.hpp
+ * @brief Shared-memory ring of rendered frames
+ *
+ * @details The renderer writes each frame straight into one slot of a small
+ * ring (triple buffered by default) that lives in a named shared-memory
+ * object. The message bus then only carries a ticket
+ * `ring:<name>:<slot>:<seq>:<width>,<height>` on `ImageRendered` instead of
+ * the whole RGBA frame.
+ *
+ * The same mapping is used whether the window manager is loaded in the same
+ * process (modules are dlopen'ed with local symbols, so a plain static arena
+ * would not be shared between the two libraries) or in another process.
+ *
+ * Each slot carries an atomic sequence number: the producer zeroes it before
+ * writing and publishes the new sequence once the pixels are in place, so a
+ * consumer can detect both stale tickets and frames overwritten while it was
+ * still reading them.
+ *
+ * Pixels are stored bottom-up (OpenGL row order), RGBA8, tightly packed.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace rtypeEngine {
+
+struct FrameRingTicket {
+  std::string name;
+  uint32_t slot = 0;
+  uint64_t sequence = 0;
+  uint32_t width = 0;
+  uint32_t height = 0;
+};
+
+class FrameRing {
+ public:
+  static constexpr uint32_t MAGIC = 0x47525446;  // "FTRG"
+  static constexpr uint32_t VERSION = 1;
+  static constexpr uint32_t MAX_SLOTS = 4;
+  static constexpr uint32_t DEFAULT_SLOTS = 3;
+  static constexpr const char* TICKET_PREFIX = "ring:";
+
+  FrameRing() = default;
+  ~FrameRing() { close(); }
+  FrameRing(const FrameRing&) = delete;
+  FrameRing& operator=(const FrameRing&) = delete;
+
+  /// Build a ring name unique to this process and resize generation.
+  static std::string makeName(const std::string& tag, uint32_t generation) {
+#ifdef _WIN32
+    unsigned long pid = static_cast<unsigned long>(GetCurrentProcessId());
+    return "Local\\rtype_" + tag + "_" + std::to_string(pid) + "_" + std::to_string(generation);
+#else
+    long pid = static_cast<long>(getpid());
+    return "/rtype_" + tag + "_" + std::to_string(pid) + "_" + std::to_string(generation);
+#endif
+  }
+
+  /// Producer side: create (or replace) the shared object and map it.
+  bool create(const std::string& name, uint32_t slotCount, std::size_t slotCapacity) {
+    close();
+    if (slotCount == 0 || slotCount > MAX_SLOTS || slotCapacity == 0) return false;
+    std::size_t total = dataOffset() + slotCapacity * slotCount;
+    if (!mapRegion(name, total, true)) return false;
+
+    Header* header = this->header();
+    header->magic = MAGIC;
+    header->version = VERSION;
+    header->slotCount = slotCount;
+    header->slotCapacity = slotCapacity;
+    for (uint32_t i = 0; i < MAX_SLOTS; ++i) {
+      header->slots[i].sequence.store(0, std::memory_order_relaxed);
+      header->slots[i].width = 0;
+      header->slots[i].height = 0;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    _owner = true;
+    _nextSequence = 0;
+    return true;
+  }
+
+  /// Consumer side: map an existing ring created by the producer.
+  bool open(const std::string& name) {
+    close();
+    if (!mapRegion(name, sizeof(Header), false)) return false;
+    Header* header = this->header();
+    if (header->magic != MAGIC || header->version != VERSION ||
+        header->slotCount == 0 || header->slotCount > MAX_SLOTS) {
+      close();
+      return false;
+    }
+    std::size_t total = dataOffset() + header->slotCapacity * header->slotCount;
+    unmapRegion();
+    return mapRegion(name, total, false);
+  }
+
+  void close() {
+    unmapRegion();
+#ifndef _WIN32
+    if (_owner && !_name.empty()) shm_unlink(_name.c_str());
+#endif
+    _owner = false;
+    _name.clear();
+  }
+
+  bool isOpen() const { return _base != nullptr; }
+  const std::string& name() const { return _name; }
+  uint32_t slotCount() const { return isOpen() ? header()->slotCount : 0; }
+  std::size_t slotCapacity() const { return isOpen() ? header()->slotCapacity : 0; }
+
+  /// Producer: pick the next slot and mark it as being written.
+  uint32_t beginWrite() {
+    uint32_t slot = static_cast<uint32_t>(_nextSequence % header()->slotCount);
+    header()->slots[slot].sequence.store(0, std::memory_order_relaxed);
+    // Seqlock write-begin: the pixel writes that follow must not become
+    // visible before the slot is marked busy.
+    std::atomic_thread_fence(std::memory_order_release);
+    return slot;
+  }
+
+  uint8_t* slotData(uint32_t slot) { return _base + dataOffset() + slot * header()->slotCapacity; }
+
+  /// Producer: publish the slot and return the ticket to send on the bus.
+  FrameRingTicket commit(uint32_t slot, uint32_t width, uint32_t height) {
+    Slot& s = header()->slots[slot];
+    s.width = width;
+    s.height = height;
+    uint64_t sequence = ++_nextSequence;
+    s.sequence.store(sequence, std::memory_order_release);
+    return FrameRingTicket{_name, slot, sequence, width, height};
+  }
+
+  /// Consumer: pixels for a ticket, or nullptr if the slot was already reused.
+  const uint8_t* acquire(const FrameRingTicket& ticket) const {
+    if (!isOpen() || ticket.slot >= header()->slotCount) return nullptr;
+    const Slot& s = header()->slots[ticket.slot];
+    if (s.sequence.load(std::memory_order_acquire) != ticket.sequence) return nullptr;
+    if (static_cast<std::size_t>(ticket.width) * ticket.height * 4 > header()->slotCapacity) return nullptr;
+    return _base + dataOffset() + ticket.slot * header()->slotCapacity;
+  }
+
+  /// Consumer: true if the slot was not overwritten since acquire().
+  bool stillValid(const FrameRingTicket& ticket) const {
+    if (!isOpen() || ticket.slot >= header()->slotCount) return false;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header()->slots[ticket.slot].sequence.load(std::memory_order_relaxed) == ticket.sequence;
+  }
+
+  static std::string encodeTicket(const FrameRingTicket& ticket) {
+    std::string out;
+    out.reserve(64);
+    out += TICKET_PREFIX;
+    out += ticket.name;
+    out += ':';
+    out += std::to_string(ticket.slot);
+    out += ':';
+    out += std::to_string(ticket.sequence);
+    out += ':';
+    out += std::to_string(ticket.width);
+    out += ',';
+    out += std::to_string(ticket.height);
+    return out;
+  }
+
+  static bool isTicket(const std::string& message) {
+    return message.compare(0, 5, TICKET_PREFIX) == 0;
+  }
+
+  static bool decodeTicket(const std::string& message, FrameRingTicket& ticket) {
+    if (!isTicket(message)) return false;
+    // Fields are parsed from the right so the ring name may contain ':' (Windows "Local\").
+    std::size_t comma = message.rfind(',');
+    std::size_t seqEnd = message.rfind(':', comma);
+    if (comma == std::string::npos || seqEnd == std::string::npos || seqEnd < 5) return false;
+    std::size_t slotEnd = message.rfind(':', seqEnd - 1);
+    if (slotEnd == std::string::npos || slotEnd < 5) return false;
+    std::size_t nameEnd = message.rfind(':', slotEnd - 1);
+    if (nameEnd == std::string::npos || nameEnd < 5) return false;
+
+    char* end = nullptr;
+    ticket.name = message.substr(5, nameEnd - 5);
+    ticket.slot = static_cast<uint32_t>(std::strtoul(message.c_str() + nameEnd + 1, &end, 10));
+    if (end != message.c_str() + slotEnd) return false;
+    ticket.sequence = std::strtoull(message.c_str() + slotEnd + 1, &end, 10);
+    if (end != message.c_str() + seqEnd) return false;
+    ticket.width = static_cast<uint32_t>(std::strtoul(message.c_str() + seqEnd + 1, &end, 10));
+    if (end != message.c_str() + comma) return false;
+    ticket.height = static_cast<uint32_t>(std::strtoul(message.c_str() + comma + 1, &end, 10));
+    return !ticket.name.empty() && ticket.sequence != 0 && ticket.width > 0 && ticket.height > 0;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<uint64_t> sequence;
+    uint32_t width;
+    uint32_t height;
+  };
+
+  struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t reserved;
+    uint64_t slotCapacity;
+    Slot slots[MAX_SLOTS];
+  };
+
+  static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                "FrameRing needs lock-free 64-bit atomics to live in shared memory");
+
+  static constexpr std::size_t dataOffset() { return (sizeof(Header) + 63) & ~static_cast<std::size_t>(63); }
+
+  Header* header() const { return reinterpret_cast<Header*>(_base); }
+
+  bool mapRegion(const std::string& name, std::size_t size, bool create) {
+#ifdef _WIN32
+    HANDLE mapping = nullptr;
+    if (create) {
+      unsigned long long size64 = static_cast<unsigned long long>(size);
+      mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                   static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFull),
+                                   name.c_str());
+    } else {
+      mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    }
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+      CloseHandle(mapping);
+      return false;
+    }
+    _mapping = mapping;
+#else
+    int flags = create ? (O_CREAT | O_RDWR | O_TRUNC) : O_RDWR;
+    int fd = shm_open(name.c_str(), flags, 0600);
+    if (fd < 0) return false;
+    if (create && ftruncate(fd, static_cast<off_t>(size)) != 0) {
+      ::close(fd);
+      shm_unlink(name.c_str());
+      return false;
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED) {
+      if (create) shm_unlink(name.c_str());
+      return false;
+    }
+#endif
+    _base = static_cast<uint8_t*>(view);
+    _size = size;
+    _name = name;
+    return true;
+  }
+
+  void unmapRegion() {
+    if (!_base) return;
+#ifdef _WIN32
+    UnmapViewOfFile(_base);
+    if (_mapping) CloseHandle(static_cast<HANDLE>(_mapping));
+    _mapping = nullptr;
+#else
+    munmap(_base, _size);
+#endif
+    _base = nullptr;
+    _size = 0;
+  }
+
+  uint8_t* _base = nullptr;
+  std::size_t _size = 0;
+  std::string _name;
+  bool _owner = false;
+  uint64_t _nextSequence = 0;
+#ifdef _WIN32
+  void* _mapping = nullptr;
+#endif
+};
+
+}  // namespace rtypeEngine
@@ -0,0 +1,324 @@
+/**
+ * @file main.cpp
+ * @brief Headless, deterministic throughput benchmark for GLEWSFMLRenderer
+ *
+ * @details Records a scene as RenderEntityCommand strings (sprites, meshes
+ * from assets/models, HUD elements, optional text, particle generators and
+ * per-frame movement), then replays it through onRenderEntityCommand and
+ * renders every frame offscreen. The renderer runs on an EGL surfaceless
+ * context by default (`RTYPE_RENDER_HEADLESS=1`), so Mesa llvmpipe is
+ * enough: no X server or GPU is needed.
+ *
+ * Object placement uses a fixed-seed generator and the renderer runs with a
+ * fixed frame time and particle seed, so two runs draw the same frames.
+ * Reported: frame time percentiles, readback cost, draw calls per frame, and
+ * one `RESULT key=value ...` line for CI scripts.
+ */
+
+#include "../engine/modules/Renderer/GLEWSFML/GLEWSFMLRenderer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    int frames = 600;
+    int warmup = 60;
+    int sprites = 200;
+    int meshes = 200;
+    int hud = 24;
+    int particles = 4;
+    int width = 1280;
+    int height = 720;
+    bool text = false;
+    bool native = false;
+    std::string root = RENDER_BENCH_ROOT;
+};
+
+void usage()
+{
+    std::cout << "Usage: render_bench [--frames N] [--warmup N] [--sprites N] [--meshes N] [--hud N]\n"
+                 "                    [--particles N] [--size WxH] [--text] [--native] [--root DIR]\n"
+                 "  --text    add text elements (SFML needs an X display to rasterize them)\n"
+                 "  --native  use the usual X11/GLX context instead of EGL surfaceless\n"
+                 "  --root    directory containing assets/ (default: source tree)\n"
+                 "Renderer settings such as RTYPE_READBACK_LATENCY or RTYPE_RENDER_IMMEDIATE\n"
+                 "are read from the environment as usual." << std::endl;
+}
+
+bool parseOptions(int argc, char **argv, Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        auto next = [&]() -> const char * { return i + 1 < argc ? argv[++i] : nullptr; };
+        auto intArg = [&](int &out) {
+            const char *value = next();
+            if (!value)
+                return false;
+            out = std::max(0, std::atoi(value));
+            return true;
+        };
+
+        if (arg == "--frames") { if (!intArg(options.frames)) return false; }
+        else if (arg == "--warmup") { if (!intArg(options.warmup)) return false; }
+        else if (arg == "--sprites") { if (!intArg(options.sprites)) return false; }
+        else if (arg == "--meshes") { if (!intArg(options.meshes)) return false; }
+        else if (arg == "--hud") { if (!intArg(options.hud)) return false; }
+        else if (arg == "--particles") { if (!intArg(options.particles)) return false; }
+        else if (arg == "--size")
+        {
+            const char *value = next();
+            if (!value || std::sscanf(value, "%dx%d", &options.width, &options.height) != 2)
+                return false;
+        }
+        else if (arg == "--text") options.text = true;
+        else if (arg == "--native") options.native = true;
+        else if (arg == "--root")
+        {
+            const char *value = next();
+            if (!value)
+                return false;
+            options.root = value;
+        }
+        else
+            return false;
+    }
+    return options.frames > 0 && options.width > 0 && options.height > 0;
+}
+
+// Small LCG: the scene must not depend on the standard library's engines.
+class SceneRandom {
+  public:
+    explicit SceneRandom(uint32_t seed) : _state(seed) {}
+    float next(float low, float high)
+    {
+        _state = _state * 1664525u + 1013904223u;
+        return low + (high - low) * static_cast<float>(_state >> 8) / static_cast<float>(1u << 24);
+    }
+
+  private:
+    uint32_t _state;
+};
+
+struct Mover {
+    std::string id;
+    float x, y, z;
+    float radius, speed, phase;
+    bool spins;
+};
+
+struct Scene {
+    std::string setup;
+    std::vector<std::string> frames;
+};
+
+Scene recordScene(const Options &options)
+{
+    static const char *MODELS[] = {
+        "assets/models/cube.obj",
+        "assets/models/sphere.obj",
+        "assets/models/laser.obj",
+        "assets/models/Monster_1/motion_1.obj",
+        "assets/models/Monster_2/motion_1.obj",
+        "assets/models/Monster_3/motion_1.obj",
+    };
+    static const char *TEXTURES[] = {
+        "assets/textures/character.png",
+        "assets/textures/hud_icon.png",
+        "assets/textures/shoot.jpg",
+        "assets/textures/attack.jpg",
+    };
+
+    SceneRandom random(0x52545950u);
+    std::ostringstream setup;
+    std::vector<Mover> movers;
+
+    setup << "CreateEntity:Camera:bench_camera;SetPosition:bench_camera,0,0,30;SetActiveCamera:bench_camera;";
+    setup << "SetLightProperties:bench_light,1,1,1,1;";
+
+    for (int i = 0; i < options.sprites; ++i)
+    {
+        std::string id = "sprite_" + std::to_string(i);
+        setup << "CreateEntity:Sprite:" << TEXTURES[i % 4] << ":" << id << ";";
+        setup << "SetScale:" << id << ",1.5,1.5,1;";
+        movers.push_back({id, random.next(-18, 18), random.next(-10, 10), random.next(-6, 2),
+                          random.next(0.5f, 3), random.next(0.5f, 2), random.next(0, 6.28f), false});
+    }
+    for (int i = 0; i < options.meshes; ++i)
+    {
+        std::string id = "mesh_" + std::to_string(i);
+        setup << "CreateEntity:" << MODELS[i % 6] << ":" << id << ";";
+        setup << "SetColor:" << id << "," << random.next(0.2f, 1) << "," << random.next(0.2f, 1) << ","
+              << random.next(0.2f, 1) << ";";
+        if (i % 6 >= 3)
+            setup << "SetScale:" << id << ",0.4,0.4,0.4;";
+        movers.push_back({id, random.next(-18, 18), random.next(-10, 10), random.next(-10, 0),
+                          random.next(0.5f, 3), random.next(0.5f, 2), random.next(0, 6.28f), true});
+    }
+    for (int i = 0; i < options.hud; ++i)
+    {
+        std::string id = "hud_" + std::to_string(i);
+        float x = 10.0f + (i % 8) * 90.0f;
+        float y = 10.0f + (i / 8) * 60.0f;
+        switch (i % 4)
+        {
+        case 0:
+            setup << "CreateRect:" << id << ":" << x << "," << y << ",80,40:0.1,0.2,0.6,0.7:1;";
+            break;
+        case 1:
+            setup << "CreateCircle:" << id << ":" << x + 20 << "," << y + 20 << ",18:0.9,0.3,0.2,0.8:1:32;";
+            break;
+        case 2:
+            setup << "CreateRoundedRect:" << id << ":" << x << "," << y << ",80,40,8:0.2,0.7,0.3,0.8:1;";
+            break;
+        default:
+            setup << "CreateUISprite:" << id << ":" << TEXTURES[1] << ":" << x << "," << y << ",32,32:1:" << i << ";";
+            break;
+        }
+    }
+    if (options.text)
+    {
+        setup << "CreateText:hud_score:assets/fonts/arial.ttf:24:1:SCORE 0000000;";
+        setup << "SetPosition:hud_score,20," << options.height - 40 << ",0;";
+        setup << "CreateText:world_label:assets/fonts/arial.ttf:32:0:BOSS;";
+        setup << "SetPosition:world_label,0,8,0;";
+    }
+    for (int i = 0; i < options.particles; ++i)
+    {
+        std::string id = "particles_" + std::to_string(i);
+        setup << "CreateParticleGenerator:" << id << ":0,0,0:0,1,0:0.6:4:1.2:300:0.08:"
+              << random.next(0.5f, 1) << "," << random.next(0.2f, 0.8f) << ",0.2;";
+        movers.push_back({id, random.next(-15, 15), random.next(-8, 8), 0, 2, 0.7f, random.next(0, 6.28f), false});
+    }
+
+    Scene scene;
+    scene.setup = setup.str();
+    const int total = options.warmup + options.frames;
+    scene.frames.reserve(total);
+    for (int frame = 0; frame < total; ++frame)
+    {
+        const float t = frame / 60.0f;
+        std::ostringstream commands;
+        commands << std::fixed << std::setprecision(3);
+        for (const Mover &mover : movers)
+        {
+            float angle = mover.phase + mover.speed * t;
+            commands << "SetPosition:" << mover.id << "," << mover.x + mover.radius * std::cos(angle) << ","
+                     << mover.y + mover.radius * std::sin(angle) << "," << mover.z << ";";
+            if (mover.spins)
+                commands << "SetRotation:" << mover.id << "," << angle * 0.5f << "," << angle << ",0;";
+        }
+        if (options.text && frame % 30 == 0)
+            commands << "SetText:hud_score:SCORE " << std::setw(7) << std::setfill('0') << frame * 10 << ";";
+        scene.frames.push_back(commands.str());
+    }
+    return scene;
+}
+
+double percentile(std::vector<double> sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+    std::sort(sorted.begin(), sorted.end());
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)];
+}
+
+double mean(const std::vector<double> &values)
+{
+    double sum = 0.0;
+    for (double value : values)
+        sum += value;
+    return values.empty() ? 0.0 : sum / values.size();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        usage();
+        return 2;
+    }
+
+    std::error_code error;
+    std::filesystem::current_path(options.root, error);
+    if (error)
+    {
+        std::cerr << "[render_bench] Cannot enter " << options.root << ": " << error.message() << std::endl;
+        return 1;
+    }
+#ifndef _WIN32
+    if (!options.native)
+        setenv("RTYPE_RENDER_HEADLESS", "1", 1);
+#endif
+
+    const Scene scene = recordScene(options);
+
+    try
+    {
+        // Nothing listens on these endpoints: published frames are dropped.
+        rtypeEngine::GLEWSFMLRenderer renderer("inproc://render_bench_pub", "inproc://render_bench_sub");
+        renderer.setDeterministic(1.0f / 60.0f, 42);
+        renderer.init();
+        renderer.handleWindowResized(std::to_string(options.width) + "," + std::to_string(options.height));
+        renderer.onRenderEntityCommand(scene.setup);
+
+        std::vector<double> frameMs, readbackMs, drawCalls, batches, immediate, culled;
+        frameMs.reserve(options.frames);
+        readbackMs.reserve(options.frames);
+        const int total = options.warmup + options.frames;
+        for (int frame = 0; frame < total; ++frame)
+        {
+            renderer.onRenderEntityCommand(scene.frames[frame]);
+            renderer.loop();
+            if (frame < options.warmup)
+                continue;
+            const auto &profile = renderer.lastFrameProfile();
+            frameMs.push_back(profile.renderMs);
+            readbackMs.push_back(profile.readbackMs);
+            drawCalls.push_back(profile.draws.drawCalls);
+            batches.push_back(profile.draws.batches);
+            immediate.push_back(profile.draws.immediate);
+            culled.push_back(profile.culled);
+        }
+        renderer.cleanup();
+
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "[render_bench] " << options.width << "x" << options.height << ", " << options.frames
+                  << " frames after " << options.warmup << " warmup; " << options.sprites << " sprites, "
+                  << options.meshes << " meshes, " << options.hud << " HUD elements, " << options.particles
+                  << " particle generators, text " << (options.text ? "on" : "off") << std::endl;
+        std::cout << "  frame ms     p50 " << percentile(frameMs, 50) << "  p90 " << percentile(frameMs, 90)
+                  << "  p99 " << percentile(frameMs, 99) << "  max " << percentile(frameMs, 100)
+                  << "  mean " << mean(frameMs) << std::endl;
+        std::cout << "  readback ms  p50 " << percentile(readbackMs, 50) << "  p99 " << percentile(readbackMs, 99)
+                  << "  mean " << mean(readbackMs) << std::endl;
+        std::cout << "  per frame    drawCalls " << mean(drawCalls) << "  batches " << mean(batches)
+                  << "  immediate " << mean(immediate) << "  culled " << mean(culled) << std::endl;
+        std::cout << "RESULT frames=" << options.frames << " p50_ms=" << percentile(frameMs, 50)
+                  << " p90_ms=" << percentile(frameMs, 90) << " p99_ms=" << percentile(frameMs, 99)
+                  << " mean_ms=" << mean(frameMs) << " readback_p50_ms=" << percentile(readbackMs, 50)
+                  << " readback_mean_ms=" << mean(readbackMs) << " draw_calls=" << mean(drawCalls)
+                  << " batches=" << mean(batches) << " immediate=" << mean(immediate) << " culled=" << mean(culled)
+                  << std::endl;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "[render_bench] Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}